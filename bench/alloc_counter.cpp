@@ -0,0 +1,96 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  alloc_counter.cpp
+ *
+ *    Description:  counts heap allocations by interposing malloc
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 08:34:52 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+// Linked into the benchmark executables only. Definitions of malloc & co. in
+// the executable take precedence over the ones of the C library for every
+// shared object of the process, including the library itself, libstdc++
+// (operator new) and Eigen's aligned allocator. The real allocator is reached
+// through the __libc_* entry points of glibc. Elsewhere the counter is
+// disabled and alloc_counting_available() returns false.
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include "bench_utils.h"
+
+namespace OptSuite { namespace Bench {
+    namespace {
+        std::atomic<long long> alloc_count{0};
+        std::atomic<long long> alloc_bytes{0};
+
+        inline void record(size_t size){
+            alloc_count.fetch_add(1, std::memory_order_relaxed);
+            alloc_bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+        }
+    }
+
+    AllocStats alloc_stats(){
+        AllocStats s;
+        s.count = alloc_count.load(std::memory_order_relaxed);
+        s.bytes = alloc_bytes.load(std::memory_order_relaxed);
+        return s;
+    }
+
+#if defined(__GLIBC__)
+    bool alloc_counting_available() { return true; }
+}}
+
+extern "C" {
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+
+    void* malloc(size_t size){
+        OptSuite::Bench::record(size);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t n, size_t size){
+        OptSuite::Bench::record(n * size);
+        return __libc_calloc(n, size);
+    }
+
+    void* realloc(void* p, size_t size){
+        // a realloc may move the block, count it as a new allocation
+        OptSuite::Bench::record(size);
+        return __libc_realloc(p, size);
+    }
+
+    void* memalign(size_t alignment, size_t size){
+        OptSuite::Bench::record(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size){
+        OptSuite::Bench::record(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** p, size_t alignment, size_t size){
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+        OptSuite::Bench::record(size);
+        *p = __libc_memalign(alignment, size);
+        return *p == nullptr && size != 0 ? ENOMEM : 0;
+    }
+}
+#else
+    bool alloc_counting_available() { return false; }
+}}
+#endif
@@ -0,0 +1,39 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  bench_main.cpp
+ *
+ *    Description:  entry point shared by all micro benchmarks
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 04:02:18 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <string>
+#include "benchmark/benchmark.h"
+#include "OptSuite/core_n.h"
+
+int main(int argc, char **argv){
+    // stored in the "context" section of the JSON output so that results of
+    // different releases and precisions can be told apart
+    benchmark::AddCustomContext("optsuite_version",
+            std::to_string(OPTSUITE_VERSION_MAJOR) + "." +
+            std::to_string(OPTSUITE_VERSION_MINOR) + "." +
+            std::to_string(OPTSUITE_VERSION_PATCH));
+    benchmark::AddCustomContext("optsuite_scalar",
+            OPTSUITE_SCALAR_TOKEN == 0 ? "double" : "float");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  bench_utils.cpp
+ *
+ *    Description:  
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 06:31:09 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "bench_utils.h"
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace OptSuite { namespace Bench {
+#ifdef __linux__
+    namespace {
+        // read a "Key:   value kB" line of /proc/self/status
+        long read_status_kb(const char* key){
+            std::ifstream in("/proc/self/status");
+            std::string line;
+            size_t len = std::strlen(key);
+            while (std::getline(in, line)){
+                if (line.compare(0, len, key) == 0 && line.size() > len && line[len] == ':')
+                    return std::atol(line.c_str() + len + 1);
+            }
+            return 0;
+        }
+    }
+
+    long current_rss_kb(){
+        return read_status_kb("VmRSS");
+    }
+
+    long peak_rss_kb(){
+        long v = read_status_kb("VmHWM");
+        if (v > 0)
+            return v;
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    bool reset_peak_rss(){
+        // writing 5 to clear_refs resets the peak RSS (Linux >= 4.0)
+        std::FILE* f = std::fopen("/proc/self/clear_refs", "w");
+        if (f == nullptr)
+            return false;
+        bool ok = std::fputs("5", f) >= 0;
+        ok = (std::fclose(f) == 0) && ok;
+        return ok;
+    }
+#else
+    long current_rss_kb() { return 0; }
+    long peak_rss_kb() { return 0; }
+    bool reset_peak_rss() { return false; }
+#endif
+
+    ArgList::ArgList(int argc, char** argv){
+        for (int i = 1; i < argc; ++i){
+            std::string arg(argv[i]);
+            if (arg.compare(0, 2, "--") != 0){
+                args_[arg] = "";
+                continue;
+            }
+            size_t eq = arg.find('=');
+            if (eq == std::string::npos)
+                args_[arg.substr(2)] = "1";
+            else
+                args_[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+        }
+    }
+
+    bool ArgList::has(const std::string& key) const {
+        used_[key] = true;
+        return args_.count(key) > 0;
+    }
+
+    std::string ArgList::get(const std::string& key, const std::string& def) const {
+        used_[key] = true;
+        auto it = args_.find(key);
+        return it == args_.end() ? def : it->second;
+    }
+
+    long ArgList::get_int(const std::string& key, long def) const {
+        std::string v = get(key, "");
+        return v.empty() ? def : std::strtol(v.c_str(), nullptr, 10);
+    }
+
+    double ArgList::get_double(const std::string& key, double def) const {
+        std::string v = get(key, "");
+        return v.empty() ? def : std::strtod(v.c_str(), nullptr);
+    }
+
+    std::vector<std::string> ArgList::get_list(const std::string& key, const std::string& def) const {
+        std::vector<std::string> list;
+        std::stringstream ss(get(key, def));
+        std::string item;
+        while (std::getline(ss, item, ','))
+            if (!item.empty())
+                list.push_back(item);
+        return list;
+    }
+
+    std::vector<std::string> ArgList::unused() const {
+        std::vector<std::string> keys;
+        for (auto& kv : args_)
+            if (!used_.count(kv.first))
+                keys.push_back(kv.first);
+        return keys;
+    }
+
+    std::string json_escape(const std::string& s){
+        std::string out;
+        out.reserve(s.size());
+        for (char c : s){
+            switch (c){
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n";  break;
+                case '\t': out += "\\t";  break;
+                default:   out += c;
+            }
+        }
+        return out;
+    }
+}}
@@ -0,0 +1,72 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  bench_utils.h
+ *
+ *    Description:  helpers shared by the benchmark drivers
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 06:20:44 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_BENCH_BENCH_UTILS_H
+#define OPTSUITE_BENCH_BENCH_UTILS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace OptSuite { namespace Bench {
+    // resident set size of the process in KiB, 0 if unknown
+    long current_rss_kb();
+
+    // high water mark of the resident set size in KiB. On Linux the mark can
+    // be moved back to the current RSS with reset_peak_rss(), which returns
+    // false when this is not supported (the mark is then the peak since the
+    // start of the process).
+    long peak_rss_kb();
+    bool reset_peak_rss();
+
+    // heap allocations (count and requested bytes) since the start of the
+    // process. Provided by alloc_counter.cpp, which must be linked into the
+    // executable; the numbers stay zero when alloc_counting_available() is
+    // false.
+    struct AllocStats {
+        long long count = 0;
+        long long bytes = 0;
+    };
+    AllocStats alloc_stats();
+    bool alloc_counting_available();
+
+    // command line of the form --key=value or --flag (value "1")
+    class ArgList {
+        public:
+            ArgList(int argc, char** argv);
+
+            bool has(const std::string&) const;
+            std::string get(const std::string&, const std::string&) const;
+            long get_int(const std::string&, long) const;
+            double get_double(const std::string&, double) const;
+            // comma separated list
+            std::vector<std::string> get_list(const std::string&, const std::string&) const;
+
+            // keys that were given but never queried
+            std::vector<std::string> unused() const;
+
+        private:
+            std::map<std::string, std::string> args_;
+            mutable std::map<std::string, bool> used_;
+    };
+
+    // escape a string for a JSON document
+    std::string json_escape(const std::string&);
+}}
+
+#endif
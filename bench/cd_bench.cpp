@@ -0,0 +1,78 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  cd_bench.cpp
+ *
+ *    Description:  thread scaling of the asynchronous coordinate descent
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 06:41:27 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <algorithm>
+#include <thread>
+#include "benchmark/benchmark.h"
+#include "OptSuite/core_n.h"
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/Base/solver.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "OptSuite/Utils/thread_pool.h"
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+using namespace OptSuite::Utils;
+
+namespace {
+    // sparse lasso solved to a fixed number of sweeps
+    // range(0): threads, range(1): rows, range(2): columns
+    // items are coordinate updates, their rate should grow linearly with the
+    // threads as long as the columns rarely share rows. One thread is the
+    // serial cyclic solver without active set.
+    void BM_AsyncCD(benchmark::State& state){
+        int p = static_cast<int>(state.range(0));
+        Index m = state.range(1), n = state.range(2);
+        rng(42);
+        SpMat A = sprandn(m, n, 20_s / m);
+        Mat b = randn(m, 1);
+        Mat x0 = Mat::Zero(n, 1);
+        Mat x(n, 1);
+        Scalar mu = 0.1_s * (A.transpose() * b).cwiseAbs().maxCoeff();
+        L1Norm h(mu);
+        ShrinkageL1 prox(mu);
+
+        SolverOptions options;
+        options.xtol(0);
+        options.maxit(10);
+        options.verbosity(Verbosity::Quiet);
+        CoordinateDescentOptions cd;
+        cd.num_threads = p;
+        cd.active_set = false;
+        CoordinateDescentSolver solver("AsyncCD", options, cd);
+        ThreadPool::global().set_num_threads(p);
+
+        for (auto _ : state){
+            SolverRecords records;
+            solver(x0, A, b, h, prox, x, records);
+            benchmark::DoNotOptimize(x.data());
+        }
+        state.SetItemsProcessed(state.iterations() * options.maxit() * n);
+        state.counters["hw_threads"] = std::thread::hardware_concurrency();
+    }
+
+    void thread_args(benchmark::internal::Benchmark* b){
+        int hc = std::max(1u, std::thread::hardware_concurrency());
+        for (int p = 1; p <= std::max(hc, 8); p *= 2)
+            b->Args({p, 1 << 14, 1 << 16});
+        b->Unit(benchmark::kMillisecond)->UseRealTime();
+    }
+}
+
+BENCHMARK(BM_AsyncCD)->Apply(thread_args);
@@ -0,0 +1,138 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  funcgrad_bench.cpp
+ *
+ *    Description:  micro benchmarks of the smooth losses
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 04:37:05 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include "benchmark/benchmark.h"
+#include "OptSuite/core_n.h"
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/Base/factorized_mat.h"
+#include "OptSuite/Base/spmat_wrapper.h"
+#include "OptSuite/Base/shared_spmat.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+
+namespace {
+    // range(0): m, range(1): n, range(2): columns of x, range(3): gradient
+    void BM_AxmbNormSqr(benchmark::State& state){
+        Index m = state.range(0), n = state.range(1), l = state.range(2);
+        bool compute_grad = state.range(3) != 0;
+        rng(42);
+        Mat A = randn(m, n), b = randn(m, l), x = randn(n, l), g(n, l);
+        AxmbNormSqr<Scalar> f(A, b);
+
+        for (auto _ : state){
+            benchmark::DoNotOptimize(f(x, g, compute_grad));
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * m * n * l);
+        state.SetBytesProcessed(state.iterations() * m * n * sizeof(Scalar) *
+                (compute_grad ? 2 : 1));
+    }
+
+    // range(0): number of samples, range(1): number of features, range(2): gradient
+    void BM_LogisticRegression(benchmark::State& state){
+        Index m = state.range(0), n = state.range(1);
+        bool compute_grad = state.range(2) != 0;
+        rng(42);
+        Mat A = randn(n, m), x = randn(n, 1), g(n, 1);
+        Mat b = (rand(m, 1).array() > 0.5_s).cast<Scalar>() * 2 - 1;
+        LogisticRegression<Scalar> f(A, b);
+
+        for (auto _ : state){
+            benchmark::DoNotOptimize(f(x, g, compute_grad));
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * m * n);
+        state.SetBytesProcessed(state.iterations() * m * n * sizeof(Scalar) *
+                (compute_grad ? 2 : 1));
+    }
+
+    // sparse gradients: projection onto a sampling pattern
+    // range(0): m = n, range(1): density in percent, range(2): rank of x
+    // (0 for a dense x with a dense gradient), template argument: storage of
+    // the sparse gradient
+    template<typename G>
+    void BM_ProjectionOmega(benchmark::State& state){
+        Index m = state.range(0), rank = state.range(2);
+        Scalar density = state.range(1) / 100_s;
+        rng(42);
+        SpMat omega = sprandn(m, m, density);
+        omega.makeCompressed();
+        Mat b = randn(omega.nonZeros(), 1);
+        ProjectionOmega<Scalar> f(omega, b);
+
+        if (rank == 0){
+            Mat x = randn(m, m), g(m, m);
+            for (auto _ : state){
+                benchmark::DoNotOptimize(f(x, g, true));
+                benchmark::ClobberMemory();
+            }
+        } else {
+            FactorizedMat<Scalar> x(randn(m, rank), randn(m, rank));
+            G g;
+            Variable<Scalar>& xv = x;
+            Variable<Scalar>& gv = g;
+            for (auto _ : state){
+                benchmark::DoNotOptimize(f(xv, gv, true));
+                benchmark::ClobberMemory();
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * omega.nonZeros());
+    }
+
+    void axmb_args(benchmark::internal::Benchmark* b){
+        for (int grad : {0, 1}){
+            b->Args({256, 512, 1, grad});
+            b->Args({1024, 2048, 1, grad});
+            b->Args({4096, 1024, 1, grad});
+            b->Args({1024, 2048, 16, grad});
+        }
+        b->Unit(benchmark::kMicrosecond);
+    }
+
+    void logistic_args(benchmark::internal::Benchmark* b){
+        for (int grad : {0, 1}){
+            b->Args({512, 256, grad});
+            b->Args({8192, 256, grad});
+            b->Args({65536, 64, grad});
+        }
+        b->Unit(benchmark::kMicrosecond);
+    }
+
+    void omega_args(benchmark::internal::Benchmark* b){
+        for (Index m : {500, 2000}){
+            b->Args({m, 5, 0});
+            b->Args({m, 5, 10});
+        }
+        b->Unit(benchmark::kMicrosecond);
+    }
+
+    // factorized x only, the dense case does not use the sparse gradient
+    void omega_sparse_args(benchmark::internal::Benchmark* b){
+        for (Index m : {500, 2000})
+            b->Args({m, 5, 10});
+        b->Unit(benchmark::kMicrosecond);
+    }
+}
+
+BENCHMARK(BM_AxmbNormSqr)->Apply(axmb_args);
+BENCHMARK(BM_LogisticRegression)->Apply(logistic_args);
+BENCHMARK_TEMPLATE(BM_ProjectionOmega, SpMatWrapper<Scalar>)->Apply(omega_args);
+BENCHMARK_TEMPLATE(BM_ProjectionOmega, SharedSpMat<Scalar>)->Apply(omega_sparse_args);
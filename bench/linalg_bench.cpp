@@ -0,0 +1,128 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  linalg_bench.cpp
+ *
+ *    Description:  micro benchmarks of the linear algebra kernels
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 04:52:30 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "OptSuite/core_n.h"
+#include "OptSuite/LinAlg/lansvd.h"
+#include "OptSuite/LinAlg/fftw_wrapper.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+
+using namespace OptSuite;
+using namespace OptSuite::LinAlg;
+
+namespace {
+    // range(0): m = n, range(1): number of singular values
+    void BM_LANSVD_Dense(benchmark::State& state){
+        Index m = state.range(0);
+        int k = static_cast<int>(state.range(1));
+        rng(42);
+        Mat A = randn(m, m);
+        LANSVD<Scalar> svd;
+
+        for (auto _ : state){
+            svd.compute(A, k);
+            benchmark::DoNotOptimize(svd.d().data());
+        }
+        if (svd.info() != 0)
+            state.SkipWithError("LANSVD failed");
+    }
+
+    // range(0): m = n, range(1): number of singular values, range(2): density in percent
+    void BM_LANSVD_Sparse(benchmark::State& state){
+        Index m = state.range(0);
+        int k = static_cast<int>(state.range(1));
+        Scalar density = state.range(2) / 100_s;
+        rng(42);
+        SpMat A = sprandn(m, m, density);
+        A.makeCompressed();
+        LANSVD<Scalar> svd;
+
+        for (auto _ : state){
+            svd.compute(A, k);
+            benchmark::DoNotOptimize(svd.d().data());
+        }
+        if (svd.info() != 0)
+            state.SkipWithError("LANSVD failed");
+        state.counters["nnz"] = A.nonZeros();
+    }
+
+    // range(0): length of the transform
+    void BM_FFT_Vector(benchmark::State& state, bool is_forward){
+        Index n = state.range(0);
+        rng(42);
+        Mat re = randn(n, 1), im = randn(n, 1);
+        std::vector<ComplexScalar> x(n), y(n);
+        for (Index i = 0; i < n; ++i)
+            x[i] = ComplexScalar(re(i), im(i));
+        FFTWManager manager;
+
+        for (auto _ : state){
+            if (is_forward)
+                manager.forward(x, y);
+            else
+                manager.backward(x, y);
+            benchmark::DoNotOptimize(y.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * n);
+    }
+
+    // column-wise transform of a matrix
+    // range(0): length of the transform, range(1): number of columns
+    void BM_FFT_Matrix(benchmark::State& state, bool is_forward){
+        Index n = state.range(0), l = state.range(1);
+        rng(42);
+        CMat x(n, l), y(n, l);
+        x.real() = randn(n, l);
+        x.imag() = randn(n, l);
+        FFTWManager manager;
+
+        for (auto _ : state){
+            if (is_forward)
+                manager.forward(x, y);
+            else
+                manager.backward(x, y);
+            benchmark::DoNotOptimize(y.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * n * l);
+    }
+
+    void fft_vector_args(benchmark::internal::Benchmark* b){
+        // powers of two and a length with a large prime factor
+        for (Index n : {1 << 8, 1 << 12, 1 << 16, 1 << 20})
+            b->Args({n});
+        b->Args({3 * 5 * 7 * 11 * 13});
+        b->Args({65537});
+    }
+
+    void fft_matrix_args(benchmark::internal::Benchmark* b){
+        b->Args({256, 256})->Args({4096, 64})->Args({1 << 16, 4});
+    }
+}
+
+BENCHMARK(BM_LANSVD_Dense)->Args({500, 10})->Args({2000, 10})->Args({2000, 50})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LANSVD_Sparse)->Args({2000, 10, 1})->Args({10000, 10, 1})->Args({10000, 50, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_FFT_Vector, forward, true)->Apply(fft_vector_args);
+BENCHMARK_CAPTURE(BM_FFT_Vector, backward, false)->Apply(fft_vector_args);
+BENCHMARK_CAPTURE(BM_FFT_Matrix, forward, true)->Apply(fft_matrix_args);
+BENCHMARK_CAPTURE(BM_FFT_Matrix, backward, false)->Apply(fft_matrix_args);
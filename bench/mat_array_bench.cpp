@@ -0,0 +1,167 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  mat_array_bench.cpp
+ *
+ *    Description:  micro benchmarks of MatArray
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 05:03:18 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include "benchmark/benchmark.h"
+#include "OptSuite/core_n.h"
+#include "OptSuite/Base/mat_array.h"
+#include "OptSuite/Base/var_expr.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+
+namespace {
+    // all benchmarks take range(0): block size (square), range(1): number of blocks
+    MatArray make_array(Index s, Index nb){
+        rng(42);
+        MatArray x;
+        x.add_blocks(s, s, nb);
+        x.vec() = randn(x.total_size(), 1);
+        return x;
+    }
+
+    // build the array one block at a time
+    void BM_MatArray_AddBlocks(benchmark::State& state){
+        Index s = state.range(0), nb = state.range(1);
+        for (auto _ : state){
+            MatArray x;
+            for (Index i = 0; i < nb; ++i)
+                x.add_blocks(s, s);
+            benchmark::DoNotOptimize(x.vec().data());
+        }
+        state.SetItemsProcessed(state.iterations() * nb);
+    }
+
+    // describe the blocks first, then allocate once
+    // range(2): alignment of the blocks in bytes
+    void BM_MatArray_Layout(benchmark::State& state){
+        Index s = state.range(0), nb = state.range(1);
+        for (auto _ : state){
+            MatArray::Layout layout(state.range(2));
+            layout.reserve(nb);
+            layout.add_blocks(s, s, nb);
+            MatArray x(layout);
+            benchmark::DoNotOptimize(x.data());
+        }
+        state.SetItemsProcessed(state.iterations() * nb);
+    }
+
+    void BM_MatArray_Copy(benchmark::State& state){
+        MatArray x = make_array(state.range(0), state.range(1));
+        MatArray y;
+        for (auto _ : state){
+            y = x;
+            benchmark::DoNotOptimize(y.vec().data());
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * x.total_size() * sizeof(Scalar));
+    }
+
+    void BM_MatArray_ZerosLike(benchmark::State& state){
+        MatArray x = make_array(state.range(0), state.range(1));
+        for (auto _ : state){
+            MatArray y = MatArray::zeros_like(x);
+            benchmark::DoNotOptimize(y.vec().data());
+        }
+        state.SetBytesProcessed(state.iterations() * x.total_size() * sizeof(Scalar));
+    }
+
+    void BM_MatArray_Dot(benchmark::State& state){
+        MatArray x = make_array(state.range(0), state.range(1));
+        MatArray y = x;
+        // through the Variable interface, as the solvers do
+        const Variable<Scalar>& yv = y;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(x.dot(yv));
+        state.SetBytesProcessed(state.iterations() * x.total_size() * 2 * sizeof(Scalar));
+    }
+
+    void BM_MatArray_SquaredNorm(benchmark::State& state){
+        MatArray x = make_array(state.range(0), state.range(1));
+        for (auto _ : state)
+            benchmark::DoNotOptimize(x.squaredNorm());
+        state.SetBytesProcessed(state.iterations() * x.total_size() * sizeof(Scalar));
+    }
+
+    // block-wise traversal with the iterators
+    void BM_MatArray_Iterate(benchmark::State& state){
+        MatArray x = make_array(state.range(0), state.range(1));
+        for (auto _ : state){
+            Scalar s = 0;
+            for (auto it = x.begin(); it != x.end(); ++it)
+                s += it->sum();
+            benchmark::DoNotOptimize(s);
+        }
+        state.SetItemsProcessed(state.iterations() * x.total_blocks());
+    }
+
+    // block-wise traversal with operator[]
+    void BM_MatArray_Index(benchmark::State& state){
+        MatArray x = make_array(state.range(0), state.range(1));
+        for (auto _ : state){
+            Scalar s = 0;
+            for (Index i = 0; i < x.total_blocks(); ++i)
+                s += x[i].sum();
+            benchmark::DoNotOptimize(s);
+        }
+        state.SetItemsProcessed(state.iterations() * x.total_blocks());
+    }
+
+    // x_new = x - t * g, lazily evaluated in one pass
+    void BM_MatArray_AxpyExpr(benchmark::State& state){
+        MatArray x = make_array(state.range(0), state.range(1));
+        MatArray g = x, x_new = MatArray::zeros_like(x);
+        for (auto _ : state){
+            x_new = x - 0.1_s * g;
+            benchmark::DoNotOptimize(x_new.vec().data());
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * x.total_size() * 3 * sizeof(Scalar));
+    }
+
+    // the same update through a temporary, as written before the expressions
+    void BM_MatArray_AxpyTemp(benchmark::State& state){
+        MatArray x = make_array(state.range(0), state.range(1));
+        MatArray g = x, x_new = MatArray::zeros_like(x);
+        for (auto _ : state){
+            x_new = MatArray::from_vec_like(x.vec() - 0.1_s * g.vec(), x);
+            benchmark::DoNotOptimize(x_new.vec().data());
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * x.total_size() * 3 * sizeof(Scalar));
+    }
+
+    // many small blocks stress the bookkeeping, few large blocks the memory
+    void block_args(benchmark::internal::Benchmark* b){
+        b->Args({1, 1 << 16})->Args({4, 4096})->Args({32, 256})->Args({512, 4});
+    }
+}
+
+BENCHMARK(BM_MatArray_AddBlocks)->Args({1, 1 << 10})->Args({1, 1 << 14})->Args({4, 4096})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MatArray_Layout)->Args({1, 1 << 10, 0})->Args({1, 1 << 14, 0})->Args({4, 4096, 0})
+    ->Args({4, 4096, 64})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MatArray_Copy)->Apply(block_args);
+BENCHMARK(BM_MatArray_ZerosLike)->Apply(block_args);
+BENCHMARK(BM_MatArray_Dot)->Apply(block_args);
+BENCHMARK(BM_MatArray_SquaredNorm)->Apply(block_args);
+BENCHMARK(BM_MatArray_Iterate)->Apply(block_args);
+BENCHMARK(BM_MatArray_Index)->Apply(block_args);
+BENCHMARK(BM_MatArray_AxpyExpr)->Apply(block_args);
+BENCHMARK(BM_MatArray_AxpyTemp)->Apply(block_args);
@@ -0,0 +1,232 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  prox_bench.cpp
+ *
+ *    Description:  micro benchmarks of the proximal operators
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 04:10:52 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include "benchmark/benchmark.h"
+#include "OptSuite/core_n.h"
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+
+namespace {
+    // range(0): rows, range(1): columns
+    template<typename Prox>
+    void BM_Prox(benchmark::State& state, Prox prox){
+        Index m = state.range(0), n = state.range(1);
+        rng(42);
+        Mat x = randn(m, n);
+        Mat y(m, n);
+        Scalar t = 0.1_s;
+
+        for (auto _ : state){
+            prox(x, t, y);
+            benchmark::DoNotOptimize(y.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * m * n);
+        state.SetBytesProcessed(state.iterations() * m * n * 2 * sizeof(Scalar));
+    }
+
+    // prox on a MatArray with many blocks of the same shape
+    // range(0): block size (square), range(1): number of blocks
+    template<typename Prox>
+    void BM_ProxMatArray(benchmark::State& state, Prox prox){
+        Index s = state.range(0), nb = state.range(1);
+        rng(42);
+        MatArray x;
+        x.add_blocks(s, s, nb);
+        x.vec() = randn(x.total_size(), 1);
+        MatArray y = MatArray::zeros_like(x);
+
+        // the MatArray overload is hidden in the derived classes
+        Proximal<Scalar>& p = prox;
+        for (auto _ : state){
+            p(x, 0.1_s, y);
+            benchmark::DoNotOptimize(y.vec().data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * x.total_size());
+    }
+
+    // the l1 ball projection by sorting the magnitudes, O(n log n), the
+    // reference of L1NormBallProj
+    struct SortedL1NormBallProj {
+        Scalar mu;
+        void operator()(const Mat& x, Scalar, Mat& y){
+            if (x.lpNorm<1>() <= mu){
+                y = x;
+                return;
+            }
+            Vec a = x.col(0).cwiseAbs();
+            std::sort(a.data(), a.data() + a.size(), std::greater<Scalar>());
+            Scalar sum = 0, tau = 0;
+            for (Index i = 0; i < a.size() && a(i) > (sum + a(i) - mu) / (i + 1); i++){
+                sum += a(i);
+                tau = (sum - mu) / (i + 1);
+            }
+            y = x.array().sign() * (x.array().abs() - tau).max(0_s);
+        }
+    };
+
+    // the l0 ball projection by sorting the indexes, the reference of L0NormBallProj
+    struct SortedL0NormBallProj {
+        Index k;
+        void operator()(const Mat& x, Scalar, Mat& y){
+            std::vector<Index> idx(x.rows());
+            std::iota(idx.begin(), idx.end(), Index(0));
+            std::sort(idx.begin(), idx.end(),
+                      [&x](Index a, Index b){ return std::fabs(x(a)) > std::fabs(x(b)); });
+            y = x;
+            for (Index i = k; i < x.rows(); i++)
+                y(idx[i]) = 0;
+        }
+    };
+
+    // weights drawn once per size, range(0): rows
+    void BM_WeightedL1NormBallProj(benchmark::State& state){
+        Index m = state.range(0);
+        rng(42);
+        Mat x = randn(m, 1);
+        Mat y(m, 1);
+        Vec w = randn(m, 1).cwiseAbs().array() + 0.1_s;
+        WeightedL1NormBallProj<Scalar> prox(w, 1_s);
+
+        for (auto _ : state){
+            prox(x, 0.1_s, y);
+            benchmark::DoNotOptimize(y.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * m);
+        state.SetBytesProcessed(state.iterations() * m * 3 * sizeof(Scalar));
+    }
+
+    // groups of 8 rows, range(0): rows, range(1): 0 for consecutive rows and
+    // 1 for rows in random order
+    void BM_ShrinkageGroupL2(benchmark::State& state){
+        Index m = state.range(0);
+        rng(42);
+        Mat x = randn(m, 1);
+        Mat y(m, 1);
+        std::vector<Index> rows(m);
+        std::iota(rows.begin(), rows.end(), Index(0));
+        if (state.range(1))
+            std::shuffle(rows.begin(), rows.end(), std::mt19937(42));
+        std::vector<Index> ptr;
+        for (Index i = 0; i < m; i += 8)
+            ptr.push_back(i);
+        ptr.push_back(m);
+        ShrinkageGroupL2 prox(GroupIndex(m, ptr, rows), 1e-2_s);
+
+        for (auto _ : state){
+            prox(x, 0.1_s, y);
+            benchmark::DoNotOptimize(y.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * m);
+        state.SetBytesProcessed(state.iterations() * m * 2 * sizeof(Scalar));
+    }
+
+    // SLOPE weights decreasing linearly from 1 to 0.1, range(0): rows
+    void BM_SortedL1Prox(benchmark::State& state){
+        Index m = state.range(0);
+        rng(42);
+        Mat x = randn(m, 1);
+        Mat y(m, 1);
+        SortedL1Prox prox(Vec::LinSpaced(m, 1, 0.1), 1e-2_s);
+
+        for (auto _ : state){
+            prox(x, 0.1_s, y);
+            benchmark::DoNotOptimize(y.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * m);
+        state.SetBytesProcessed(state.iterations() * m * 2 * sizeof(Scalar));
+    }
+
+    void sorted_l1_args(benchmark::internal::Benchmark* b){
+        for (Index m : {1 << 10, 1 << 14, 1 << 18, 1 << 20, 10000000})
+            b->Args({m});
+        b->Unit(benchmark::kMillisecond);
+    }
+
+    void matrix_args(benchmark::internal::Benchmark* b){
+        for (Index m : {1 << 10, 1 << 14, 1 << 18})
+            b->Args({m, 1});
+        b->Args({1 << 10, 16});
+        b->Args({1 << 12, 64});
+    }
+
+    void vector_args(benchmark::internal::Benchmark* b){
+        for (Index m : {1 << 10, 1 << 14, 1 << 18, 1 << 20})
+            b->Args({m, 1});
+    }
+
+    void svd_args(benchmark::internal::Benchmark* b){
+        for (Index m : {64, 256})
+            b->Args({m, m / 4})->Args({m, m});
+        b->Unit(benchmark::kMillisecond);
+    }
+
+    void array_args(benchmark::internal::Benchmark* b){
+        b->Args({4, 4096})->Args({32, 256})->Args({256, 4});
+    }
+}
+
+// element-wise and block-wise operators
+BENCHMARK_CAPTURE(BM_Prox, IdentityProx, IdentityProx<Scalar>())->Apply(matrix_args);
+BENCHMARK_CAPTURE(BM_Prox, ShrinkageL1, ShrinkageL1(1e-2_s))->Apply(matrix_args);
+BENCHMARK_CAPTURE(BM_Prox, ShrinkageL2, ShrinkageL2(1e-2_s))->Apply(matrix_args);
+BENCHMARK_CAPTURE(BM_Prox, ShrinkageL0, ShrinkageL0(1e-2_s))->Apply(matrix_args);
+BENCHMARK_CAPTURE(BM_Prox, ShrinkageL2Rowwise, ShrinkageL2Rowwise(1e-2_s))->Apply(matrix_args);
+BENCHMARK_CAPTURE(BM_Prox, L2NormBallProj, L2NormBallProj<Scalar>(1_s))->Apply(matrix_args);
+BENCHMARK_CAPTURE(BM_Prox, LInfBallProj, LInfBallProj<Scalar>(1_s))->Apply(matrix_args);
+BENCHMARK_CAPTURE(BM_Prox, TV1DProx, TV1DProx(1e-1_s))->Apply(matrix_args);
+
+// operators restricted to vectors
+BENCHMARK_CAPTURE(BM_Prox, ShrinkageLInf, ShrinkageLInf(1e-2_s))->Apply(vector_args);
+BENCHMARK_CAPTURE(BM_Prox, L1NormBallProj, L1NormBallProj<Scalar>(1_s))->Apply(vector_args);
+BENCHMARK_CAPTURE(BM_Prox, L1NormBallProjSorted, SortedL1NormBallProj{1_s})->Apply(vector_args);
+BENCHMARK_CAPTURE(BM_Prox, SimplexProj, SimplexProj<Scalar>(1_s))->Apply(vector_args);
+BENCHMARK(BM_WeightedL1NormBallProj)->Apply(vector_args);
+BENCHMARK(BM_ShrinkageGroupL2)->ArgsProduct({{1 << 10, 1 << 14, 1 << 18, 1 << 20}, {0, 1}});
+BENCHMARK(BM_SortedL1Prox)->Apply(sorted_l1_args);
+BENCHMARK_CAPTURE(BM_Prox, L0NormBallProj, L0NormBallProj<Scalar>(64_s))->Apply(vector_args);
+BENCHMARK_CAPTURE(BM_Prox, L0NormBallProjSorted, SortedL0NormBallProj{64})->Apply(vector_args);
+BENCHMARK_CAPTURE(BM_Prox, L0NormBallProjColumns, L0NormBallProj<Scalar>(64_s))
+    ->Args({1 << 10, 16})->Args({1 << 12, 64});
+
+// SVD based operators
+BENCHMARK_CAPTURE(BM_Prox, ShrinkageNuclear, ShrinkageNuclear(1_s))->Apply(svd_args);
+BENCHMARK_CAPTURE(BM_Prox, NuclearNormProx, NuclearNormProx(1_s))->Apply(svd_args);
+
+// 100 iterations of the 2D total variation solvers
+BENCHMARK_CAPTURE(BM_Prox, TV2DProxAnisotropic, TV2DProx(1e-1_s, TVType::Anisotropic, 100, 0))
+    ->Apply(svd_args);
+BENCHMARK_CAPTURE(BM_Prox, TV2DProxIsotropic, TV2DProx(1e-1_s, TVType::Isotropic, 100, 0))
+    ->Apply(svd_args);
+
+// block-wise evaluation on MatArray
+BENCHMARK_CAPTURE(BM_ProxMatArray, ShrinkageL1, ShrinkageL1(1e-2_s))->Apply(array_args);
+BENCHMARK_CAPTURE(BM_ProxMatArray, ShrinkageL2, ShrinkageL2(1e-2_s))->Apply(array_args);
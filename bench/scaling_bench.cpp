@@ -0,0 +1,416 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  scaling_bench.cpp
+ *
+ *    Description:  thread scaling and memory footprint of the kernels and
+ *                  solvers
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 08:58:16 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+// usage: scaling_bench [--problem=lasso,group_lasso,completion,logistic,multitask]
+//                      [--threads=1,2,4] [--vary=both|eigen|omp] [--tasks=K]
+//                      [--solver-maxit=K] [--min-time=SECONDS] [--repeat=N]
+//                      [--min-efficiency=E] [--baseline=FILE]
+//                      [--max-mem-growth=R] [--mem-slack-kb=KB]
+//                      [--format=table|json] [--output=FILE]
+//                      [problem options of solver_bench]
+//
+// Every problem contributes three workloads: one evaluation of f and its
+// gradient ("grad"), one proximal step ("prox") and a fixed number of
+// proximal gradient iterations ("proxgrad"). The pseudo problem "multitask"
+// holds --tasks logistic models in the blocks of a MatArray and measures the
+// block-wise gradient, prox and objective. Each workload is timed for every
+// thread count, which is applied to Eigen (setNbThreads) and/or to OpenMP
+// (omp_set_num_threads) and the block thread pool according to --vary.
+// Speedup and efficiency are relative to the first thread count.
+//
+// The run fails (exit code 2) when
+//  - the efficiency of some workload drops below --min-efficiency, or
+//  - with --baseline, the peak RSS growth or the allocations per call of a
+//    workload exceed the ones in the baseline (a JSON file written by an
+//    earlier run) by more than the ratio --max-mem-growth. RSS differences
+//    below --mem-slack-kb are ignored.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "OptSuite/core_n.h"
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/Base/solver.h"
+#include "OptSuite/LinAlg/problem_gen.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "OptSuite/Utils/logger.h"
+#include "OptSuite/Utils/thread_pool.h"
+#include "bench_utils.h"
+#include "workloads.h"
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::Bench;
+
+namespace {
+    struct ScalingConfig {
+        std::vector<std::string> problems;
+        std::vector<int> threads;
+        std::string vary;
+        Index  solver_maxit;
+        double min_time;
+        Index  repeat;
+        double min_efficiency;
+        std::string baseline;
+        double max_mem_growth;
+        long   mem_slack_kb;
+        ProblemConfig problem;
+        Index  tasks;
+    };
+
+    struct Workload {
+        std::string name;
+        std::function<void()> call;
+    };
+
+    struct Measurement {
+        std::string workload;
+        int    threads = 1;
+        double time_us = 0;         // per call
+        double speedup = 1;
+        double efficiency = 1;
+        long   delta_rss_kb = -1;   // -1 if unknown
+        double allocs = 0;          // per call
+        double alloc_bytes = 0;     // per call
+    };
+
+    void set_threads(int p, const std::string& vary){
+        Eigen::setNbThreads(vary == "omp" ? 1 : p);
+#ifdef _OPENMP
+        omp_set_num_threads(vary == "eigen" ? 1 : p);
+#endif
+        Utils::ThreadPool::global().set_num_threads(vary == "eigen" ? 1 : p);
+    }
+
+    // time one workload: calls are repeated until min_time has passed, the
+    // fastest of `repeat` such rounds is kept
+    Measurement measure(const Workload& w, int p, const ScalingConfig& c){
+        using Clock = std::chrono::steady_clock;
+        Measurement m;
+        m.workload = w.name;
+        m.threads = p;
+
+        for (Index rep = 0; rep < c.repeat; ++rep){
+            bool reset = reset_peak_rss();
+            long rss0 = current_rss_kb();
+            AllocStats a0 = alloc_stats();
+
+            Index calls = 0;
+            auto t0 = Clock::now();
+            double elapsed = 0;
+            do {
+                w.call();
+                ++calls;
+                elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+            } while (elapsed < c.min_time);
+
+            AllocStats a1 = alloc_stats();
+            long peak = peak_rss_kb();
+
+            double t = elapsed * 1e6 / calls;
+            if (rep == 0 || t < m.time_us)
+                m.time_us = t;
+            m.allocs = static_cast<double>(a1.count - a0.count) / calls;
+            m.alloc_bytes = static_cast<double>(a1.bytes - a0.bytes) / calls;
+            if (reset)
+                m.delta_rss_kb = std::max(m.delta_rss_kb, peak - rss0);
+        }
+        return m;
+    }
+
+    // workloads on one generated problem
+    std::vector<Workload> make_workloads(Instance& ins, const ScalingConfig& c){
+        std::vector<Workload> ws;
+        Instance* p = &ins;
+        // evaluate at a random point, x0 is typically all zeros
+        auto x = std::make_shared<Mat>(LinAlg::randn(ins.x0.rows(), ins.x0.cols()));
+        auto g = std::make_shared<Mat>(ins.x0.rows(), ins.x0.cols());
+        auto y = std::make_shared<Mat>(ins.x0.rows(), ins.x0.cols());
+
+        ws.push_back({ins.problem + "/grad", [p, x, g](){
+            (*p->f)(*x, *g, true);
+        }});
+        ws.push_back({ins.problem + "/prox", [p, x, y](){
+            (*p->h_prox)(*x, 1 / p->lipschitz, *y);
+        }});
+
+        SolverEntry prox_grad = solver_registry().front();
+        Index maxit = c.solver_maxit;
+        ws.push_back({ins.problem + "/proxgrad", [p, prox_grad, maxit](){
+            SolverRecords records;
+            // ftol = 0: always run maxit iterations
+            prox_grad.run(*p, "fixed", maxit, 0, records);
+        }});
+        return ws;
+    }
+
+    // block-wise workloads on a MatArray of independent models
+    std::vector<Workload> make_multitask_workloads(const ScalingConfig& c){
+        Index m = c.problem.m > 0 ? c.problem.m : 1000;
+        Index n = c.problem.n > 0 ? c.problem.n : 200;
+        auto data = LinAlg::gen_logistic(m, n, c.problem.sparsity, c.problem.cond,
+                c.problem.noise, c.problem.seed);
+        auto f = std::make_shared<LogisticRegression<Scalar>>(data.A, data.b);
+        auto h = std::make_shared<L1Norm>(c.problem.mu_ratio);
+        auto h_prox = std::make_shared<ShrinkageL1>(c.problem.mu_ratio);
+
+        MatArray::Layout layout;
+        layout.add_blocks(n, 1, c.tasks);
+        auto x = std::make_shared<MatArray>(layout);
+        x->vec() = LinAlg::randn(x->total_size(), 1);
+        auto g = std::make_shared<MatArray>(layout);
+        auto y = std::make_shared<MatArray>(layout);
+
+        // the MatArray overloads are hidden in the derived classes
+        std::vector<Workload> ws;
+        ws.push_back({"multitask/grad", [f, x, g](){
+            static_cast<FuncGrad<Scalar>&>(*f)(*x, *g, true);
+        }});
+        ws.push_back({"multitask/prox", [h_prox, x, y](){
+            static_cast<Proximal<Scalar>&>(*h_prox)(*x, 1_s, *y);
+        }});
+        ws.push_back({"multitask/obj", [h, x](){
+            static_cast<Func<Scalar>&>(*h)(*x);
+        }});
+        return ws;
+    }
+
+    // value of "key": in a line of our own JSON output
+    std::string json_field(const std::string& line, const std::string& key){
+        std::string pat = "\"" + key + "\": ";
+        size_t i = line.find(pat);
+        if (i == std::string::npos)
+            return "";
+        i += pat.size();
+        if (line[i] == '"'){
+            size_t j = line.find('"', i + 1);
+            return line.substr(i + 1, j - i - 1);
+        }
+        size_t j = line.find_first_of(",}", i);
+        return line.substr(i, j - i);
+    }
+
+    std::map<std::pair<std::string, int>, Measurement> read_baseline(const std::string& file){
+        std::map<std::pair<std::string, int>, Measurement> base;
+        std::ifstream in(file);
+        if (!in){
+            Utils::Global::logger_e.log_info("cannot open baseline ", file, "\n");
+            std::exit(1);
+        }
+        std::string line;
+        while (std::getline(in, line)){
+            std::string w = json_field(line, "workload");
+            if (w.empty())
+                continue;
+            Measurement m;
+            m.workload     = w;
+            m.threads      = std::stoi(json_field(line, "threads"));
+            m.delta_rss_kb = std::stol(json_field(line, "delta_rss_kb"));
+            m.allocs       = std::stod(json_field(line, "allocs"));
+            m.alloc_bytes  = std::stod(json_field(line, "alloc_bytes"));
+            base[std::make_pair(w, m.threads)] = m;
+        }
+        return base;
+    }
+
+    // returns the number of violations, each one is reported on stderr
+    int check(const std::vector<Measurement>& ms, const ScalingConfig& c){
+        int failures = 0;
+        auto fail = [&](const Measurement& m, const std::string& what){
+            Utils::Global::logger_e.log_info("FAIL ", m.workload, " threads=", m.threads,
+                    ": ", what, "\n");
+            ++failures;
+        };
+
+        for (auto& m : ms)
+            if (m.threads > c.threads.front() && m.efficiency < c.min_efficiency)
+                fail(m, "efficiency " + std::to_string(m.efficiency) +
+                        " < " + std::to_string(c.min_efficiency));
+
+        if (c.baseline.empty())
+            return failures;
+
+        auto base = read_baseline(c.baseline);
+        double r = 1 + c.max_mem_growth;
+        for (auto& m : ms){
+            auto it = base.find(std::make_pair(m.workload, m.threads));
+            if (it == base.end())
+                continue;
+            const Measurement& b = it->second;
+            if (m.delta_rss_kb >= 0 && b.delta_rss_kb >= 0 &&
+                    m.delta_rss_kb > b.delta_rss_kb * r + c.mem_slack_kb)
+                fail(m, "peak RSS growth " + std::to_string(m.delta_rss_kb) +
+                        " KiB, baseline " + std::to_string(b.delta_rss_kb) + " KiB");
+            // allow half an allocation per call of noise
+            if (m.allocs > b.allocs * r + 0.5)
+                fail(m, "allocations per call " + std::to_string(m.allocs) +
+                        ", baseline " + std::to_string(b.allocs));
+            if (m.alloc_bytes > b.alloc_bytes * r + 1024. * c.mem_slack_kb)
+                fail(m, "allocated bytes per call " + std::to_string(m.alloc_bytes) +
+                        ", baseline " + std::to_string(b.alloc_bytes));
+        }
+        return failures;
+    }
+
+    void write_table(std::ostream& out, const std::vector<Measurement>& ms){
+        out << std::left << std::setw(24) << "workload" << std::right
+            << std::setw(8)  << "threads" << std::setw(14) << "time(us)"
+            << std::setw(10) << "speedup" << std::setw(8) << "eff"
+            << std::setw(12) << "delta(KiB)" << std::setw(12) << "allocs"
+            << std::setw(14) << "alloc(KiB)" << "\n";
+        out << std::string(102, '-') << "\n";
+        for (auto& m : ms){
+            out << std::left << std::setw(24) << m.workload << std::right << std::fixed
+                << std::setw(8)  << m.threads
+                << std::setw(14) << std::setprecision(1) << m.time_us
+                << std::setw(10) << std::setprecision(2) << m.speedup
+                << std::setw(8)  << m.efficiency;
+            if (m.delta_rss_kb >= 0)
+                out << std::setw(12) << m.delta_rss_kb;
+            else
+                out << std::setw(12) << "-";
+            out << std::setw(12) << std::setprecision(1) << m.allocs
+                << std::setw(14) << m.alloc_bytes / 1024 << "\n";
+        }
+    }
+
+    // one record per line, read back by read_baseline()
+    void write_json(std::ostream& out, const ScalingConfig& c, const std::vector<Measurement>& ms){
+        out << std::setprecision(10);
+        out << "{\n  \"context\": {\n"
+            << "    \"optsuite_version\": \"" << OPTSUITE_VERSION_MAJOR << "."
+                << OPTSUITE_VERSION_MINOR << "." << OPTSUITE_VERSION_PATCH << "\",\n"
+            << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef _OPENMP
+            << "    \"openmp\": true,\n"
+#else
+            << "    \"openmp\": false,\n"
+#endif
+            << "    \"vary\": \"" << json_escape(c.vary) << "\",\n"
+            << "    \"alloc_counting\": " << (alloc_counting_available() ? "true" : "false") << "\n"
+            << "  },\n  \"benchmarks\": [";
+        for (size_t k = 0; k < ms.size(); ++k){
+            const Measurement& m = ms[k];
+            out << (k == 0 ? "\n" : ",\n") << "    {"
+                << "\"workload\": \"" << json_escape(m.workload) << "\", "
+                << "\"threads\": " << m.threads << ", "
+                << "\"time_us\": " << m.time_us << ", "
+                << "\"speedup\": " << m.speedup << ", "
+                << "\"efficiency\": " << m.efficiency << ", "
+                << "\"delta_rss_kb\": " << m.delta_rss_kb << ", "
+                << "\"allocs\": " << m.allocs << ", "
+                << "\"alloc_bytes\": " << m.alloc_bytes << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+}
+
+int main(int argc, char **argv){
+    ArgList args(argc, argv);
+    ScalingConfig c;
+
+    std::string default_threads = "1";
+    for (unsigned p = 2; p <= std::thread::hardware_concurrency(); p *= 2)
+        default_threads += "," + std::to_string(p);
+
+    c.problems       = args.get_list("problem", "lasso,group_lasso,completion,logistic,multitask");
+    for (auto& p : args.get_list("threads", default_threads))
+        c.threads.push_back(std::max(1, std::stoi(p)));
+    c.vary           = args.get("vary", "both");
+    c.solver_maxit   = args.get_int("solver-maxit", 50);
+    c.min_time       = args.get_double("min-time", 0.2);
+    c.repeat         = std::max(1l, args.get_int("repeat", 3));
+    c.min_efficiency = args.get_double("min-efficiency", 0);
+    c.baseline       = args.get("baseline", "");
+    c.max_mem_growth = args.get_double("max-mem-growth", 0.1);
+    c.mem_slack_kb   = args.get_int("mem-slack-kb", 256);
+    c.tasks          = std::max(1l, args.get_int("tasks", 64));
+    c.problem.read(args);
+    std::string format = args.get("format", "table");
+    std::string output = args.get("output", "");
+
+    for (auto& key : args.unused()){
+        Utils::Global::logger_e.log_info("unknown argument ", key, "\n");
+        return 1;
+    }
+    if (c.vary != "both" && c.vary != "eigen" && c.vary != "omp"){
+        Utils::Global::logger_e.log_info("--vary must be one of both, eigen, omp\n");
+        return 1;
+    }
+#ifndef _OPENMP
+    if (c.threads.size() > 1)
+        Utils::Global::logger_e.log_info("warning: built without OpenMP (cmake -DUSE_OPENMP=ON), ",
+                "the thread count only affects the multitask workloads\n");
+#endif
+    if (!alloc_counting_available())
+        Utils::Global::logger_e.log_info("warning: allocation counting is not available\n");
+
+    std::vector<Measurement> ms;
+    for (auto& name : c.problems){
+        std::vector<Workload> ws;
+        Instance ins;
+        if (name == "multitask"){
+            ws = make_multitask_workloads(c);
+            Utils::Global::logger_e.log_info("running ", name, " (", c.tasks, " tasks)\n");
+        } else {
+            ins = make_instance(name, c.problem);
+            Utils::Global::logger_e.log_info("running ", name, " (", ins.size, ")\n");
+            ws = make_workloads(ins, c);
+        }
+        for (auto& w : ws){
+            double t_ref = 0;
+            for (int p : c.threads){
+                set_threads(p, c.vary);
+                Measurement m = measure(w, p, c);
+                if (p == c.threads.front())
+                    t_ref = m.time_us;
+                m.speedup = t_ref / m.time_us;
+                m.efficiency = m.speedup * c.threads.front() / p;
+                ms.push_back(m);
+            }
+        }
+    }
+    set_threads(c.threads.front(), c.vary);
+
+    std::ofstream file;
+    if (!output.empty()){
+        file.open(output);
+        if (!file){
+            Utils::Global::logger_e.log_info("cannot open ", output, "\n");
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+    if (format == "json")
+        write_json(out, c, ms);
+    else
+        write_table(out, ms);
+
+    return check(ms, c) > 0 ? 2 : 0;
+}
@@ -0,0 +1,282 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  solver_bench.cpp
+ *
+ *    Description:  end-to-end benchmark of the solvers on generated problems
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 06:47:51 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+// usage: solver_bench [--problem=lasso,group_lasso,completion,logistic]
+//                     [--solver=proxgrad] [--strategy=fixed,armijo,bb]
+//                     [--m=M] [--n=N] [--l=L] [--rank=R] [--sparsity=S]
+//                     [--sample-ratio=P] [--cond=C] [--noise=SIGMA]
+//                     [--mu-ratio=R] [--seed=S] [--tol=T] [--maxit=K]
+//                     [--reference-maxit=K] [--repeat=N]
+//                     [--format=table|json] [--output=FILE]
+//
+// For every problem a reference objective value f* is computed first with a
+// long run. Each (solver, strategy) pair is then timed; "time to tolerance"
+// is the time of the first iteration with (f - f*) / max(1, |f*|) <= tol.
+// The peak memory is the high water mark of the RSS during the run, the
+// allocations are the number of heap allocations made by the run.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "OptSuite/core_n.h"
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/Base/solver.h"
+#include "OptSuite/Utils/logger.h"
+#include "bench_utils.h"
+#include "workloads.h"
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::Bench;
+
+namespace {
+    struct BenchConfig {
+        std::vector<std::string> problems;
+        std::vector<std::string> solvers;
+        std::vector<std::string> strategies;
+        ProblemConfig problem;
+        Scalar tol;
+        Index  maxit, reference_maxit, repeat;
+    };
+
+    struct RunResult {
+        std::string solver;
+        std::string strategy;
+        Index  iters = 0;
+        time_t time_us = 0;
+        Index  iters_to_tol = -1;
+        time_t time_to_tol_us = -1;
+        Scalar obj = 0;
+        Scalar rel_gap = 0;
+        long   peak_rss_kb = 0;
+        long   delta_rss_kb = 0;
+        long long allocs = 0;
+        long long alloc_bytes = 0;
+        // kept until f* is known
+        std::vector<Scalar> obj_hist;
+        std::vector<time_t> time_hist_us;
+    };
+
+    void finalize(RunResult& r, Scalar f_star, Scalar tol){
+        Scalar scale = std::max(1_s, std::fabs(f_star));
+        r.obj = r.obj_hist.empty() ? std::numeric_limits<Scalar>::quiet_NaN() : r.obj_hist.back();
+        r.rel_gap = (r.obj - f_star) / scale;
+        for (size_t k = 0; k < r.obj_hist.size(); ++k){
+            if ((r.obj_hist[k] - f_star) / scale <= tol){
+                r.iters_to_tol = k;
+                r.time_to_tol_us = r.time_hist_us[k];
+                break;
+            }
+        }
+        r.obj_hist.clear();
+        r.time_hist_us.clear();
+    }
+
+    struct InstanceResult {
+        std::string problem;
+        std::string size;
+        Scalar f_star;
+        std::vector<RunResult> runs;
+    };
+
+    InstanceResult run_instance(Instance& ins, const std::vector<SolverEntry>& solvers,
+            const BenchConfig& c){
+        InstanceResult res;
+        res.problem = ins.problem;
+        res.size = ins.size;
+
+        // reference value with a long run of the proximal gradient method
+        // with BB steps, the first entry of the registry
+        SolverRecords ref;
+        solver_registry().front().run(ins, "bb", c.reference_maxit, 1e-14_s, ref);
+        Scalar f_star = *std::min_element(ref.obj_hist.begin(), ref.obj_hist.end());
+
+        for (const SolverEntry& s : solvers){
+            std::vector<std::string> strategies;
+            for (auto& st : s.strategies)
+                if (std::find(c.strategies.begin(), c.strategies.end(), st) != c.strategies.end())
+                    strategies.push_back(st);
+            if (s.strategies.empty())
+                strategies.push_back("-");
+
+            for (auto& st : strategies){
+                RunResult r;
+                r.solver = s.name;
+                r.strategy = st;
+                for (Index rep = 0; rep < c.repeat; ++rep){
+                    SolverRecords records;
+                    bool reset = reset_peak_rss();
+                    long rss0 = current_rss_kb();
+                    AllocStats a0 = alloc_stats();
+                    s.run(ins, st, c.maxit, 1e-3_s * c.tol, records);
+                    AllocStats a1 = alloc_stats();
+                    long peak = peak_rss_kb();
+
+                    // keep the fastest repetition, the iterates are identical
+                    if (rep == 0 || records.elapsed_time_us < r.time_us){
+                        r.iters = records.n_iters;
+                        r.time_us = records.elapsed_time_us;
+                        r.obj_hist = std::move(records.obj_hist);
+                        r.time_hist_us = std::move(records.time_hist_us);
+                        r.allocs = a1.count - a0.count;
+                        r.alloc_bytes = a1.bytes - a0.bytes;
+                    }
+                    r.peak_rss_kb = std::max(r.peak_rss_kb, peak);
+                    if (reset)
+                        r.delta_rss_kb = std::max(r.delta_rss_kb, peak - rss0);
+                    else
+                        r.delta_rss_kb = -1;
+                }
+                f_star = std::min(f_star, *std::min_element(r.obj_hist.begin(), r.obj_hist.end()));
+                res.runs.push_back(std::move(r));
+            }
+        }
+
+        res.f_star = f_star;
+        for (auto& r : res.runs)
+            finalize(r, f_star, c.tol);
+        return res;
+    }
+
+    void write_table(std::ostream& out, const std::vector<InstanceResult>& results){
+        out << std::left
+            << std::setw(12) << "problem" << std::setw(28) << "size"
+            << std::setw(10) << "solver" << std::setw(8) << "step"
+            << std::right
+            << std::setw(8)  << "iters" << std::setw(12) << "time(ms)"
+            << std::setw(10) << "it@tol" << std::setw(12) << "t@tol(ms)"
+            << std::setw(12) << "rel_gap" << std::setw(12) << "peak(MiB)"
+            << std::setw(12) << "delta(KiB)" << std::setw(10) << "allocs" << "\n";
+        out << std::string(146, '-') << "\n";
+        for (auto& res : results){
+            for (auto& r : res.runs){
+                out << std::left
+                    << std::setw(12) << res.problem << std::setw(28) << res.size
+                    << std::setw(10) << r.solver << std::setw(8) << r.strategy
+                    << std::right << std::fixed
+                    << std::setw(8) << r.iters
+                    << std::setw(12) << std::setprecision(3) << r.time_us / 1e3;
+                if (r.iters_to_tol >= 0)
+                    out << std::setw(10) << r.iters_to_tol
+                        << std::setw(12) << std::setprecision(3) << r.time_to_tol_us / 1e3;
+                else
+                    out << std::setw(10) << "-" << std::setw(12) << "-";
+                out << std::setw(12) << std::scientific << std::setprecision(2) << r.rel_gap
+                    << std::fixed << std::setprecision(1)
+                    << std::setw(12) << r.peak_rss_kb / 1024.;
+                if (r.delta_rss_kb >= 0)
+                    out << std::setw(12) << r.delta_rss_kb;
+                else
+                    out << std::setw(12) << "-";
+                out << std::setw(10) << r.allocs << "\n";
+            }
+        }
+    }
+
+    void write_json(std::ostream& out, const BenchConfig& c,
+            const std::vector<InstanceResult>& results){
+        out << std::setprecision(10);
+        out << "{\n  \"context\": {\n"
+            << "    \"optsuite_version\": \"" << OPTSUITE_VERSION_MAJOR << "."
+                << OPTSUITE_VERSION_MINOR << "." << OPTSUITE_VERSION_PATCH << "\",\n"
+            << "    \"optsuite_scalar\": \"" << (OPTSUITE_SCALAR_TOKEN == 0 ? "double" : "float") << "\",\n"
+            << "    \"seed\": " << c.problem.seed << ",\n"
+            << "    \"tol\": " << c.tol << ",\n"
+            << "    \"maxit\": " << c.maxit << "\n"
+            << "  },\n  \"benchmarks\": [";
+        bool first = true;
+        for (auto& res : results){
+            for (auto& r : res.runs){
+                out << (first ? "\n" : ",\n") << "    {"
+                    << "\"problem\": \"" << json_escape(res.problem) << "\", "
+                    << "\"size\": \"" << json_escape(res.size) << "\", "
+                    << "\"solver\": \"" << json_escape(r.solver) << "\", "
+                    << "\"strategy\": \"" << json_escape(r.strategy) << "\", "
+                    << "\"iters\": " << r.iters << ", "
+                    << "\"time_us\": " << r.time_us << ", "
+                    << "\"iters_to_tol\": " << r.iters_to_tol << ", "
+                    << "\"time_to_tol_us\": " << r.time_to_tol_us << ", "
+                    << "\"obj\": " << r.obj << ", "
+                    << "\"f_star\": " << res.f_star << ", "
+                    << "\"rel_gap\": " << r.rel_gap << ", "
+                    << "\"peak_rss_kb\": " << r.peak_rss_kb << ", "
+                    << "\"delta_rss_kb\": " << r.delta_rss_kb << ", "
+                    << "\"allocs\": " << r.allocs << ", "
+                    << "\"alloc_bytes\": " << r.alloc_bytes << "}";
+                first = false;
+            }
+        }
+        out << "\n  ]\n}\n";
+    }
+}
+
+int main(int argc, char **argv){
+    ArgList args(argc, argv);
+    BenchConfig c;
+    c.problems        = args.get_list("problem", "lasso,group_lasso,completion,logistic");
+    c.solvers         = args.get_list("solver", "proxgrad");
+    c.strategies      = args.get_list("strategy", "fixed,armijo,bb");
+    c.problem.read(args);
+    c.tol             = args.get_double("tol", 1e-6);
+    c.maxit           = args.get_int("maxit", 5000);
+    c.reference_maxit = args.get_int("reference-maxit", 10 * c.maxit);
+    c.repeat          = std::max(1l, args.get_int("repeat", 1));
+    std::string format = args.get("format", "table");
+    std::string output = args.get("output", "");
+
+    for (auto& key : args.unused()){
+        Utils::Global::logger_e.log_info("unknown argument ", key, "\n");
+        return 1;
+    }
+
+    std::vector<SolverEntry> solvers;
+    for (auto& s : solver_registry())
+        if (std::find(c.solvers.begin(), c.solvers.end(), s.name) != c.solvers.end())
+            solvers.push_back(s);
+    if (solvers.empty()){
+        Utils::Global::logger_e.log_info("no solver selected\n");
+        return 1;
+    }
+
+    std::vector<InstanceResult> results;
+    for (auto& p : c.problems){
+        Instance ins = make_instance(p, c.problem);
+        Utils::Global::logger_e.log_info("running ", p, " (", ins.size, ")\n");
+        results.push_back(run_instance(ins, solvers, c));
+    }
+
+    std::ofstream file;
+    if (!output.empty()){
+        file.open(output);
+        if (!file){
+            Utils::Global::logger_e.log_info("cannot open ", output, "\n");
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+    if (format == "json")
+        write_json(out, c, results);
+    else
+        write_table(out, results);
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  variable_bench.cpp
+ *
+ *    Description:  cost of the type dispatch of the Variable operations
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 09:41:03 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+// The Variable operations dispatch on the kind tag of the argument. The
+// "DynamicCast" benchmarks reproduce the former dispatch through a chain of
+// dynamic_casts on the same data, so the difference is the dispatch cost.
+// Small variables are used on purpose: for them the dispatch dominates.
+
+#include "benchmark/benchmark.h"
+#include "OptSuite/core_n.h"
+#include "OptSuite/Base/mat_array.h"
+#include "OptSuite/Base/mat_wrapper.h"
+#include "OptSuite/Base/spmat_wrapper.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+
+namespace {
+    // the former implementation of MatWrapper::dot(const Variable&)
+    __attribute__((noinline))
+    Scalar dot_dynamic_cast(const MatWrapper<Scalar>& x, const Variable<Scalar>& other){
+        const MatWrapper<Scalar>* other_ptr = dynamic_cast<const MatWrapper<Scalar>*>(&other);
+        const SpMatWrapper<Scalar>* other_ptr_s = dynamic_cast<const SpMatWrapper<Scalar>*>(&other);
+        OPTSUITE_ASSERT(other_ptr || other_ptr_s);
+        if (other_ptr)
+            return x.dot(*other_ptr);
+        else
+            return x.dot(*other_ptr_s);
+    }
+
+    // the former implementation of MatArray_t::squared_norm_diff
+    __attribute__((noinline))
+    Scalar squared_norm_diff_dynamic_cast(const MatArray& x, const Variable<Scalar>& other){
+        const MatArray* other_ptr = dynamic_cast<const MatArray*>(&other);
+        OPTSUITE_ASSERT(other_ptr);
+        return (x.vec() - other_ptr->vec()).squaredNorm();
+    }
+
+    // range(0): number of entries
+    void BM_Dot_Dense_Tagged(benchmark::State& state){
+        Index n = state.range(0);
+        MatWrapper<Scalar> x(randn(n, 1)), y(randn(n, 1));
+        const Variable<Scalar>& xv = x;
+        const Variable<Scalar>& yv = y;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(xv.dot(yv));
+    }
+
+    void BM_Dot_Dense_DynamicCast(benchmark::State& state){
+        Index n = state.range(0);
+        MatWrapper<Scalar> x(randn(n, 1)), y(randn(n, 1));
+        const Variable<Scalar>& yv = y;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(dot_dynamic_cast(x, yv));
+    }
+
+    // the second branch of the chain: dense x sparse
+    void BM_Dot_Sparse_Tagged(benchmark::State& state){
+        Index n = state.range(0);
+        MatWrapper<Scalar> x(randn(n, n));
+        SpMatWrapper<Scalar> y(sprandn(n, n, 0.5));
+        const Variable<Scalar>& xv = x;
+        const Variable<Scalar>& yv = y;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(xv.dot(yv));
+    }
+
+    void BM_Dot_Sparse_DynamicCast(benchmark::State& state){
+        Index n = state.range(0);
+        MatWrapper<Scalar> x(randn(n, n));
+        SpMatWrapper<Scalar> y(sprandn(n, n, 0.5));
+        const Variable<Scalar>& yv = y;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(dot_dynamic_cast(x, yv));
+    }
+
+    // range(0): block size, range(1): number of blocks
+    MatArray make_array(Index s, Index nb){
+        MatArray x;
+        x.add_blocks(s, s, nb);
+        x.vec() = randn(x.total_size(), 1);
+        return x;
+    }
+
+    void BM_SquaredNormDiff_Array_Tagged(benchmark::State& state){
+        MatArray x = make_array(state.range(0), state.range(1));
+        MatArray y = make_array(state.range(0), state.range(1));
+        const Variable<Scalar>& xv = x;
+        const Variable<Scalar>& yv = y;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(xv.squared_norm_diff(yv));
+    }
+
+    void BM_SquaredNormDiff_Array_DynamicCast(benchmark::State& state){
+        MatArray x = make_array(state.range(0), state.range(1));
+        MatArray y = make_array(state.range(0), state.range(1));
+        const Variable<Scalar>& yv = y;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(squared_norm_diff_dynamic_cast(x, yv));
+    }
+}
+
+BENCHMARK(BM_Dot_Dense_Tagged)->Arg(1)->Arg(4)->Arg(16)->Arg(256);
+BENCHMARK(BM_Dot_Dense_DynamicCast)->Arg(1)->Arg(4)->Arg(16)->Arg(256);
+BENCHMARK(BM_Dot_Sparse_Tagged)->Arg(2)->Arg(8);
+BENCHMARK(BM_Dot_Sparse_DynamicCast)->Arg(2)->Arg(8);
+BENCHMARK(BM_SquaredNormDiff_Array_Tagged)->Args({1, 1})->Args({2, 4})->Args({8, 4});
+BENCHMARK(BM_SquaredNormDiff_Array_DynamicCast)->Args({1, 1})->Args({2, 4})->Args({8, 4});
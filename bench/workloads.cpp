@@ -0,0 +1,168 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  workloads.cpp
+ *
+ *    Description:  
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 08:12:20 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include "OptSuite/LinAlg/problem_gen.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "OptSuite/Utils/logger.h"
+#include "workloads.h"
+
+namespace OptSuite { namespace Bench {
+    using namespace OptSuite::Base;
+    using namespace OptSuite::LinAlg;
+
+    void ProblemConfig::read(const ArgList& args){
+        m            = args.get_int("m", m);
+        n            = args.get_int("n", n);
+        l            = args.get_int("l", l);
+        rank         = args.get_int("rank", rank);
+        sparsity     = args.get_double("sparsity", sparsity);
+        sample_ratio = args.get_double("sample-ratio", sample_ratio);
+        cond         = args.get_double("cond", cond);
+        noise        = args.get_double("noise", noise);
+        mu_ratio     = args.get_double("mu-ratio", mu_ratio);
+        seed         = args.get_int("seed", seed);
+    }
+
+    namespace {
+        // |A|_2^2 by power iteration on A^T A
+        Scalar spectral_norm_sqr(const Ref<const Mat> A){
+            Vec v = randn(A.cols(), 1);
+            Scalar s = 0;
+            for (int k = 0; k < 100; ++k){
+                Vec w = A.transpose() * (A * v);
+                Scalar s_new = w.norm();
+                if (s_new == 0)
+                    return 0;
+                v = w / s_new;
+                if (std::fabs(s_new - s) <= 1e-6_s * s_new)
+                    return s_new;
+                s = s_new;
+            }
+            return s;
+        }
+
+        std::string size_string(std::initializer_list<std::pair<const char*, Index>> dims){
+            std::string s;
+            for (auto& d : dims){
+                if (!s.empty()) s += ",";
+                s += std::string(d.first) + "=" + std::to_string(d.second);
+            }
+            return s;
+        }
+
+        Index pick(Index given, Index def){
+            return given > 0 ? given : def;
+        }
+
+        SolverOptions prox_grad_options(const Instance& ins, const std::string& strategy,
+                Index maxit, Scalar ftol){
+            Scalar t0 = 1 / ins.lipschitz;
+            SolverOptions options{};
+            options.ftol(ftol);
+            options.maxit(maxit);
+            options.min_lasting_iters(10);
+            options.verbosity(Verbosity::Quiet);
+            options.fixed(FixedStepSize(t0));
+            if (strategy == "fixed"){
+                options.step_size_strategy(StepSizeStrategy::Fixed);
+            } else if (strategy == "armijo"){
+                options.step_size_strategy(StepSizeStrategy::Armijo);
+                options.armijo(ArmijoStepSize(4 * t0, 0.5, 5));
+            } else if (strategy == "bb"){
+                BBStepSize bb(t0, 1e-20, 1e20, 0.5, 1e-4, 0.85, 5, true);
+                options.step_size_strategy(StepSizeStrategy::BBStepSize);
+                options.bb(bb);
+            } else {
+                Utils::Global::logger_e.log_info("unknown step size strategy ", strategy, "\n");
+                std::exit(1);
+            }
+            return options;
+        }
+    }
+
+    Instance make_instance(const std::string& name, const ProblemConfig& c){
+        Instance ins;
+        ins.problem = name;
+        if (name == "lasso"){
+            Index m = pick(c.m, 512), n = pick(c.n, 1024);
+            RegressionProblem p = gen_lasso(m, n, c.sparsity, c.cond, c.noise, c.seed);
+            Scalar mu = c.mu_ratio * (p.A.transpose() * p.b).cwiseAbs().maxCoeff();
+            ins.size = size_string({{"m", m}, {"n", n}});
+            ins.lipschitz = spectral_norm_sqr(p.A);
+            ins.f.reset(new AxmbNormSqr<Scalar>(p.A, p.b));
+            ins.h.reset(new L1Norm(mu));
+            ins.h_prox.reset(new ShrinkageL1(mu));
+            ins.x0 = Mat::Zero(n, 1);
+        } else if (name == "group_lasso"){
+            Index m = pick(c.m, 512), n = pick(c.n, 1024), l = pick(c.l, 4);
+            RegressionProblem p = gen_group_lasso(m, n, l, c.sparsity, c.cond, c.noise, c.seed);
+            Scalar mu = c.mu_ratio * (p.A.transpose() * p.b).rowwise().norm().maxCoeff();
+            ins.size = size_string({{"m", m}, {"n", n}, {"l", l}});
+            ins.lipschitz = spectral_norm_sqr(p.A);
+            ins.f.reset(new AxmbNormSqr<Scalar>(p.A, p.b));
+            ins.h.reset(new L1_2Norm(mu));
+            ins.h_prox.reset(new ShrinkageL2Rowwise(mu));
+            ins.x0 = Mat::Zero(n, l);
+        } else if (name == "completion"){
+            Index m = pick(c.m, 256), n = pick(c.n, 256), r = pick(c.rank, 5);
+            CompletionProblem p = gen_low_rank_completion(m, n, r, c.sample_ratio, c.noise, c.seed);
+            Mat y = Mat::Zero(m, n);
+            Index k = 0;
+            for (Index j = 0; j < p.omega.outerSize(); ++j)
+                for (SpMat::InnerIterator it(p.omega, j); it; ++it)
+                    y(it.row(), it.col()) = p.b(k++);
+            Scalar mu = c.mu_ratio * std::sqrt(spectral_norm_sqr(y));
+            ins.size = size_string({{"m", m}, {"n", n}, {"r", r}, {"nnz", p.omega.nonZeros()}});
+            ins.lipschitz = 1;
+            ins.f.reset(new ProjectionOmega<Scalar>(p.omega, p.b));
+            ins.h.reset(new NuclearNorm(mu));
+            ins.h_prox.reset(new ShrinkageNuclear(mu));
+            ins.x0 = Mat::Zero(m, n);
+        } else if (name == "logistic"){
+            Index m = pick(c.m, 2048), n = pick(c.n, 512);
+            ClassificationProblem p = gen_logistic(m, n, c.sparsity, c.cond, c.noise, c.seed);
+            // f(x) = mean(log(1 + exp(-b .* A^T x)))
+            Scalar mu = c.mu_ratio * (p.A * p.b).cwiseAbs().maxCoeff() / (2 * m);
+            ins.size = size_string({{"m", m}, {"n", n}});
+            ins.lipschitz = spectral_norm_sqr(p.A) / (4 * m);
+            ins.f.reset(new LogisticRegression<Scalar>(p.A, p.b));
+            ins.h.reset(new L1Norm(mu));
+            ins.h_prox.reset(new ShrinkageL1(mu));
+            ins.x0 = Mat::Zero(n, 1);
+        } else {
+            Utils::Global::logger_e.log_info("unknown problem ", name, "\n");
+            std::exit(1);
+        }
+        return ins;
+    }
+
+    std::vector<SolverEntry> solver_registry(){
+        std::vector<SolverEntry> solvers;
+        solvers.push_back({"proxgrad", {"fixed", "armijo", "bb"},
+            [](Instance& ins, const std::string& strategy, Index maxit, Scalar ftol,
+                    SolverRecords& records){
+                ProximalGradSolver solver("Proximal Gradient",
+                        prox_grad_options(ins, strategy, maxit, ftol));
+                Mat x(ins.x0);
+                solver(ins.x0, *ins.f, *ins.h, *ins.h_prox, 1, x, records);
+            }});
+        return solvers;
+    }
+}}
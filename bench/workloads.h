@@ -0,0 +1,77 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  workloads.h
+ *
+ *    Description:  generated problems and solvers shared by the drivers
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 08:05:37 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_BENCH_WORKLOADS_H
+#define OPTSUITE_BENCH_WORKLOADS_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "OptSuite/core_n.h"
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/Base/solver.h"
+#include "bench_utils.h"
+
+namespace OptSuite { namespace Bench {
+    // parameters of the generators, sizes <= 0 select the per-problem default
+    struct ProblemConfig {
+        Index  m = 0, n = 0, l = 0, rank = 0;
+        Scalar sparsity = 0.1;
+        Scalar sample_ratio = 0.3;
+        Scalar cond = 1;
+        Scalar noise = 1e-2;
+        Scalar mu_ratio = 0.1;
+        unsigned long seed = 42;
+
+        // --m, --n, --l, --rank, --sparsity, --sample-ratio, --cond, --noise,
+        // --mu-ratio, --seed
+        void read(const ArgList&);
+    };
+
+    // a generated problem  min f(x) + h(x)
+    struct Instance {
+        std::string problem;
+        std::string size;
+        std::unique_ptr<Base::FuncGrad<Scalar>> f;
+        std::unique_ptr<Base::Func<Scalar>> h;
+        std::unique_ptr<Base::Proximal<Scalar>> h_prox;
+        Mat x0;
+        Scalar lipschitz;  // of the gradient of f
+    };
+
+    // problem is one of lasso, group_lasso, completion, logistic. The
+    // regularization parameter is mu_ratio * mu_max, where mu_max is the
+    // smallest mu with the solution x = 0.
+    Instance make_instance(const std::string& problem, const ProblemConfig&);
+
+    // a solver that can be swept. `run` solves the instance with the given
+    // step size strategy (ignored by solvers without one), at most maxit
+    // iterations and tolerance ftol, and fills the records.
+    struct SolverEntry {
+        std::string name;
+        std::vector<std::string> strategies;
+        std::function<void(Instance&, const std::string&, Index, Scalar,
+                Base::SolverRecords&)> run;
+    };
+
+    // all solvers, the first entry is the proximal gradient method
+    std::vector<SolverEntry> solver_registry();
+}}
+
+#endif
@@ -36,24 +36,38 @@ namespace OptSuite { namespace Base {
         mat_t V_;
 
         public:
-            FactorizedMat() = default;
-            FactorizedMat(Index m, Index n, Index k){
+            FactorizedMat() : Variable<dtype>(VariableKind::Factorized) {}
+            FactorizedMat(Index m, Index n, Index k) : Variable<dtype>(VariableKind::Factorized) {
                 U_.resize(m, k);
                 V_.resize(n, k);
             }
-            FactorizedMat(const Ref<const mat_t> UU, const Ref<const mat_t> VV){
+            FactorizedMat(const Ref<const mat_t> UU, const Ref<const mat_t> VV)
+                : Variable<dtype>(VariableKind::Factorized) {
                 OPTSUITE_ASSERT(UU.cols() == VV.cols());
                 U_ = UU;
                 V_ = VV;
             }
-            
+            template<int N>
+            FactorizedMat(const LinCombExpr<FactorizedMat, N>& e) : Variable<dtype>(VariableKind::Factorized) {
+                e.eval_to(*this);
+            }
+
+            static constexpr VariableKind static_kind() { return VariableKind::Factorized; }
+
             Variable<dtype>& operator=(const Variable<dtype>& other){
-                const FactorizedMat* other_ptr = dynamic_cast<const FactorizedMat*>(&other);
+                const FactorizedMat* other_ptr = variable_cast<FactorizedMat>(&other);
                 OPTSUITE_ASSERT(other_ptr);
                 *this = *other_ptr;
                 return *this;
             }
 
+            // evaluates x = sum_k c_k x_k by concatenating the factors, see var_expr.h
+            template<int N>
+            FactorizedMat& operator=(const LinCombExpr<FactorizedMat, N>& e){
+                e.eval_to(*this);
+                return *this;
+            }
+
             inline
             void resize(Index m, Index n, Index k){
                 U_.resize(m, k);
@@ -76,15 +90,18 @@ namespace OptSuite { namespace Base {
             inline mat_t mat() const { return U_ * V_.transpose(); }
 
             inline dtype dot(const Variable<dtype>& other) const {
-                const FactorizedMat* other_ptr_f = dynamic_cast<const FactorizedMat*>(&other);
-                const SpMatWrapper<dtype>* other_ptr_s = dynamic_cast<const SpMatWrapper<dtype>*>(&other);
-
-                OPTSUITE_ASSERT(other_ptr_f || other_ptr_s);
-
-                if (other_ptr_f)
-                    return this->dot(*other_ptr_f);
-                else
-                    return this->dot(*other_ptr_s);
+                switch (other.kind()){
+                    case VariableKind::Factorized:
+                        return this->dot(static_cast<const FactorizedMat&>(other));
+                    case VariableKind::Sparse:
+                        return this->dot(static_cast<const SpMatWrapper<dtype>&>(other));
+                    case VariableKind::SharedSparse:
+                        // conj(<S, x>), SharedSpMat implements the mixed products
+                        return Eigen::numext::conj(other.dot(*this));
+                    default:
+                        OPTSUITE_ASSERT(false);
+                        return dtype(0);
+                }
             }
 
             inline dtype dot(const FactorizedMat& other) const {
@@ -99,7 +116,7 @@ namespace OptSuite { namespace Base {
             }
 
             inline void set_zero_like(const Variable<dtype>& other){
-                const FactorizedMat* other_ptr = dynamic_cast<const FactorizedMat*>(&other);
+                const FactorizedMat* other_ptr = variable_cast<FactorizedMat>(&other);
                 OPTSUITE_ASSERT(other_ptr);
                 set_zero_like(*other_ptr);
             }
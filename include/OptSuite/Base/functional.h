@@ -18,13 +18,22 @@
 #ifndef OPTSUITE_BASE_FUNCTIONAL_H
 #define OPTSUITE_BASE_FUNCTIONAL_H
 
+#include <vector>
 #include "OptSuite/core_n.h"
 #include "OptSuite/Base/variable.h"
 #include "OptSuite/Base/mat_wrapper.h"
 #include "OptSuite/Base/mat_array.h"
 #include "OptSuite/Base/spmat_wrapper.h"
+#include "OptSuite/Base/shared_spmat.h"
 #include "OptSuite/Base/factorized_mat.h"
+#include "OptSuite/Base/group_index.h"
 #include "OptSuite/LinAlg/lansvd.h"
+#include "OptSuite/Utils/profiler.h"
+
+// columns from this length on are split across the threads by L0NormBallProj
+#ifndef OPTSUITE_TOP_K_PARALLEL
+#define OPTSUITE_TOP_K_PARALLEL (1 << 20)
+#endif
 
 namespace OptSuite { namespace Base {
     class Functional {
@@ -50,6 +59,21 @@ namespace OptSuite { namespace Base {
             virtual Scalar operator()(const mat_wrapper_t&);
             virtual Scalar operator()(const mat_array_t&);
             virtual Scalar operator()(const var_t&);
+            // true if operator() on matrices may run concurrently on different
+            // arguments, i.e. it has no workspace members. Enables the parallel
+            // evaluation over the blocks of a MatArray_t.
+            virtual bool is_reentrant() const { return false; }
+            // rough cost of one entry of the argument relative to an
+            // element-wise operation, used to size the parallel chunks
+            virtual Index work_per_entry() const { return 1; }
+    };
+
+    // group structure of h = mu * sum_g ||x_g||_2: the entries of x (l1 norm)
+    // or its rows (l1,2 norm); used by the screening rules
+    enum class PenaltyGroups {
+        None,
+        Entries,
+        Rows,
     };
 
     template<typename dtype>
@@ -68,8 +92,30 @@ namespace OptSuite { namespace Base {
         virtual void   operator()(const mat_array_t &, Scalar, mat_array_t &);
         virtual void   operator()(const var_t &, Scalar, const var_t &, Scalar, var_t &);
         virtual bool   is_identity() const { return false; }
+        // see Func::is_reentrant and Func::work_per_entry
+        virtual bool   is_reentrant() const { return false; }
+        virtual Index  work_per_entry() const { return 1; }
         virtual bool   has_objective_cache() const { return false; }
         virtual Scalar cached_objective() const { return 0_s; }
+        // separable operators act on every entry alone, prox_entry(v, t) is
+        // the prox of one entry; used by the coordinate descent solvers
+        virtual bool   is_separable() const { return false; }
+        virtual dtype  prox_entry(dtype, Scalar) const;
+        // the operator is the prox of the group norm above with weight
+        // penalty_weight(), see PenaltyGroups
+        virtual PenaltyGroups penalty_groups() const { return PenaltyGroups::None; }
+        virtual Scalar        penalty_weight() const { return 0_s; }
+        // duality gap, see SolverOptions::gap_tol: dual_scale(g) is the largest
+        // s <= 1 such that h*(-s g) is finite, conjugate(v) = h*(v) for such v
+        virtual bool   has_conjugate() const { return false; }
+        virtual Scalar dual_scale(const Ref<const mat_t>) const { return 1_s; }
+        virtual Scalar conjugate(const Ref<const mat_t>) const { return 0_s; }
+        // generalized Jacobian for the Newton solvers: y = D v with D a
+        // symmetric element of the Clarke Jacobian of the operator at x,
+        // 0 <= D <= I, and p the result of the operator at x with the same t
+        virtual bool   has_jacobian() const { return false; }
+        virtual void   jacobian(const Ref<const mat_t> x, const Ref<const mat_t> p, Scalar t,
+                                const Ref<const mat_t> v, Ref<mat_t> y) const;
     };
 
     template<typename dtype>
@@ -92,6 +138,7 @@ namespace OptSuite { namespace Base {
             Scalar operator()(const Ref<const mat_t>){
                 return 0_s;
             }
+            bool is_reentrant() const { return true; }
     };
 
     
@@ -99,14 +146,27 @@ namespace OptSuite { namespace Base {
         public:
             inline L1Norm(Scalar mu_ = 1) : mu(mu_) {}
             Scalar operator()(const Ref<const mat_t>);
+            bool is_reentrant() const { return true; }
 
             Scalar mu;
     };
 
+    // mu1 * ||x||_1 + mu2 / 2 * ||x||_F^2
+    class ElasticNet : public Func<Scalar> {
+        public:
+            inline ElasticNet(Scalar mu1_ = 1, Scalar mu2_ = 1) : mu1(mu1_), mu2(mu2_) {}
+            Scalar operator()(const Ref<const mat_t>);
+            bool is_reentrant() const { return true; }
+
+            Scalar mu1;
+            Scalar mu2;
+    };
+
     class L2Norm : public Func<Scalar> {
         public:
             inline L2Norm(Scalar mu_ = 1) : mu(mu_) {}
             Scalar operator()(const Ref<const mat_t>);
+            bool is_reentrant() const { return true; }
 
             Scalar mu;
     };
@@ -115,6 +175,7 @@ namespace OptSuite { namespace Base {
         public:
             inline LInfNorm(Scalar mu_ = 1) : mu(mu_) {}
             Scalar operator()(const Ref<const mat_t>);
+            bool is_reentrant() const { return true; }
 
             Scalar mu;
     };
@@ -123,6 +184,7 @@ namespace OptSuite { namespace Base {
         public:
             inline L1_2Norm(Scalar mu_ = 1) : mu(mu_) {}
             Scalar operator()(const Ref<const mat_t>);
+            bool is_reentrant() const { return true; }
 
             Scalar mu;
     };
@@ -151,6 +213,8 @@ namespace OptSuite { namespace Base {
     public:
         explicit NuclearNormProx(Scalar mu) : mu_(mu) {}
         void operator()(Ref<const mat_t> x, Scalar t, Ref<mat_t> y);
+        bool   has_conjugate() const { return true; }
+        Scalar dual_scale(const Ref<const mat_t>) const;
 
     private:
         Scalar mu_;
@@ -167,20 +231,25 @@ namespace OptSuite { namespace Base {
         ~IdentityProx() = default;
 
         void operator()(const Ref<const mat_t> x, dtype, Ref<mat_t> y) {
+            OPTSUITE_PROFILE_SCOPE("IdentityProx");
             // simple copy
             y = x;
         }
 
         void operator()(const Variable<dtype> &xp, Scalar tau, const Variable<dtype> &gp, Scalar,
                         Variable<dtype> &x) {
-            const mat_wrapper_t *xp_ptr = dynamic_cast<const mat_wrapper_t *>(&xp);
-            const mat_wrapper_t *gp_ptr = dynamic_cast<const mat_wrapper_t *>(&gp);
-            mat_wrapper_t *      x_ptr  = dynamic_cast<mat_wrapper_t *>(&x);
+            OPTSUITE_PROFILE_SCOPE("IdentityProx");
+            const mat_wrapper_t *xp_ptr = variable_cast<mat_wrapper_t>(&xp);
+            const mat_wrapper_t *gp_ptr = variable_cast<mat_wrapper_t>(&gp);
+            mat_wrapper_t *      x_ptr  = variable_cast<mat_wrapper_t>(&x);
 
             OPTSUITE_ASSERT(xp_ptr || gp_ptr || x_ptr);
             x_ptr->mat() = xp_ptr->mat() - tau * gp_ptr->mat();
         }
         bool is_identity() const { return true; }
+        bool is_reentrant() const { return true; }
+        bool is_separable() const { return true; }
+        dtype prox_entry(dtype v, Scalar) const { return v; }
     };
 
     template<typename dtype>
@@ -192,11 +261,66 @@ namespace OptSuite { namespace Base {
         ~L1NormBallProj() = default;
 
         void operator()( Ref<const mat_t> x, Scalar t, Ref<mat_t> y);
+        bool is_reentrant() const { return true; }
+        bool   has_conjugate() const { return true; }
+        Scalar conjugate(const Ref<const mat_t> v) const { return mu_ * v.cwiseAbs().maxCoeff(); }
+        bool   has_jacobian() const { return true; }
+        void   jacobian(const Ref<const mat_t>, const Ref<const mat_t>, Scalar,
+                        const Ref<const mat_t>, Ref<mat_t>) const;
 
     private:
         Scalar mu_;
     };
 
+    // projection onto the simplex {y >= 0, sum(y) = radius}
+    template<typename dtype>
+    class SimplexProj : public Proximal<dtype> {
+        using typename Proximal<dtype>::mat_t;
+
+    public:
+        explicit SimplexProj(Scalar radius = 1) : radius_(radius) { OPTSUITE_ASSERT(radius > 0); }
+        ~SimplexProj() = default;
+
+        void operator()( Ref<const mat_t> x, Scalar t, Ref<mat_t> y);
+        bool is_reentrant() const { return true; }
+        bool   has_conjugate() const { return true; }
+        Scalar conjugate(const Ref<const mat_t> v) const { return radius_ * v.maxCoeff(); }
+        bool   has_jacobian() const { return true; }
+        void   jacobian(const Ref<const mat_t>, const Ref<const mat_t>, Scalar,
+                        const Ref<const mat_t>, Ref<mat_t>) const;
+
+    private:
+        Scalar radius_;
+    };
+
+    // projection onto the weighted l1 ball {y : sum_i w_i |y_i| <= mu}, w > 0
+    template<typename dtype>
+    class WeightedL1NormBallProj : public Proximal<dtype> {
+        using typename Proximal<dtype>::mat_t;
+        using vec_t = Eigen::Matrix<dtype, Dynamic, 1>;
+
+    public:
+        WeightedL1NormBallProj(const Ref<const vec_t> w, Scalar mu) : w_(w), mu_(mu) {
+            OPTSUITE_ASSERT(w.size() == 0 || w.minCoeff() > 0);
+        }
+        ~WeightedL1NormBallProj() = default;
+
+        void operator()( Ref<const mat_t> x, Scalar t, Ref<mat_t> y);
+        bool is_reentrant() const { return true; }
+        bool   has_conjugate() const { return true; }
+        Scalar conjugate(const Ref<const mat_t> v) const {
+            return mu_ * (v.col(0).cwiseAbs().array() / w_.array()).maxCoeff();
+        }
+        bool   has_jacobian() const { return true; }
+        void   jacobian(const Ref<const mat_t>, const Ref<const mat_t>, Scalar,
+                        const Ref<const mat_t>, Ref<mat_t>) const;
+
+    private:
+        vec_t  w_;
+        Scalar mu_;
+    };
+
+    // keeps the floor(mu) entries of largest magnitude in every column
     template<typename dtype>
     class L0NormBallProj : public Proximal<dtype> {
     public:
@@ -204,6 +328,7 @@ namespace OptSuite { namespace Base {
         explicit L0NormBallProj(Scalar mu) : mu_(mu) {}
         ~L0NormBallProj() = default;
         void operator()( Ref<const mat_t> x, Scalar t, Ref<mat_t> y);
+        bool is_reentrant() const { return true; }
 
     private:
         Scalar mu_;
@@ -221,6 +346,12 @@ namespace OptSuite { namespace Base {
         ~L2NormBallProj() = default;
 
         void operator()( Ref<const mat_t> x, Scalar t, Ref<mat_t> y);
+        bool is_reentrant() const { return true; }
+        bool   has_conjugate() const { return true; }
+        Scalar conjugate(const Ref<const mat_t> v) const { return mu_ * v.norm(); }
+        bool   has_jacobian() const { return true; }
+        void   jacobian(const Ref<const mat_t>, const Ref<const mat_t>, Scalar,
+                        const Ref<const mat_t>, Ref<mat_t>) const;
 
     private:
         Scalar mu_;
@@ -235,6 +366,14 @@ namespace OptSuite { namespace Base {
         explicit LInfBallProj(Scalar mu) : mu_(mu) {}
         ~LInfBallProj() = default;
         void operator()( Ref<const mat_t> x, Scalar t, Ref<mat_t> y);
+        bool is_reentrant() const { return true; }
+        bool   has_conjugate() const { return true; }
+        Scalar conjugate(const Ref<const mat_t> v) const { return mu_ * v.cwiseAbs().sum(); }
+        bool   has_jacobian() const { return true; }
+        void   jacobian(const Ref<const mat_t> x, const Ref<const mat_t>, Scalar,
+                        const Ref<const mat_t> v, Ref<mat_t> y) const {
+            y = (x.array().abs() < mu_).select(v, 0);
+        }
 
     private:
         Scalar mu_;
@@ -246,16 +385,83 @@ namespace OptSuite { namespace Base {
         ~ShrinkageL1() = default;
 
         void operator()(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+        bool is_reentrant() const { return true; }
+        bool is_separable() const { return true; }
+        inline Scalar prox_entry(Scalar v, Scalar t) const {
+            return v > t * mu ? v - t * mu : (v < -t * mu ? v + t * mu : 0_s);
+        }
+        PenaltyGroups penalty_groups() const { return PenaltyGroups::Entries; }
+        Scalar        penalty_weight() const { return mu; }
+        bool          has_conjugate() const { return true; }
+        Scalar        dual_scale(const Ref<const mat_t> g) const {
+            Scalar d = g.cwiseAbs().maxCoeff();
+            return d > mu ? mu / d : 1_s;
+        }
+        bool has_jacobian() const { return true; }
+        void jacobian(const Ref<const mat_t>, const Ref<const mat_t> p, Scalar,
+                      const Ref<const mat_t> v, Ref<mat_t> y) const {
+            y = (p.array() != 0).select(v, 0);
+        }
 
         Scalar mu;
     };
 
+    // prox of ElasticNet
+    class ShrinkageElasticNet : public Proximal<Scalar> {
+    public:
+        inline ShrinkageElasticNet(Scalar mu1_ = 1, Scalar mu2_ = 1) : mu1(mu1_), mu2(mu2_) {}
+        ~ShrinkageElasticNet() = default;
+
+        void operator()(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+        bool is_reentrant() const { return true; }
+        bool is_separable() const { return true; }
+        inline Scalar prox_entry(Scalar v, Scalar t) const {
+            Scalar s = v > t * mu1 ? v - t * mu1 : (v < -t * mu1 ? v + t * mu1 : 0_s);
+            return s / (1 + t * mu2);
+        }
+        // the ridge term has no group structure
+        PenaltyGroups penalty_groups() const {
+            return mu2 == 0 ? PenaltyGroups::Entries : PenaltyGroups::None;
+        }
+        Scalar penalty_weight() const { return mu1; }
+        bool   has_jacobian() const { return true; }
+        void   jacobian(const Ref<const mat_t>, const Ref<const mat_t> p, Scalar t,
+                        const Ref<const mat_t> v, Ref<mat_t> y) const {
+            y = (p.array() != 0).select(v / (1 + t * mu2), 0);
+        }
+
+        Scalar mu1;
+        Scalar mu2;
+    };
+
+    // projection onto the box lo <= x <= hi
+    class BoxProj : public Proximal<Scalar> {
+    public:
+        BoxProj(Scalar lo, Scalar hi) : lo_(lo), hi_(hi) { OPTSUITE_ASSERT(lo <= hi); }
+        ~BoxProj() = default;
+
+        void operator()(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+        bool is_reentrant() const { return true; }
+        bool is_separable() const { return true; }
+        inline Scalar prox_entry(Scalar v, Scalar) const { return std::min(hi_, std::max(lo_, v)); }
+        bool has_jacobian() const { return true; }
+        void jacobian(const Ref<const mat_t> x, const Ref<const mat_t>, Scalar,
+                      const Ref<const mat_t> v, Ref<mat_t> y) const {
+            y = (x.array() > lo_ && x.array() < hi_).select(v, 0);
+        }
+
+    private:
+        Scalar lo_;
+        Scalar hi_;
+    };
+
     class ShrinkageL2 : public Proximal<Scalar> {
     public:
         inline ShrinkageL2(Scalar mu_ = 1) : mu(mu_) {}
         ~ShrinkageL2() = default;
 
         void   operator()(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+        bool   is_reentrant() const { return true; }
         Scalar mu;
     };
 
@@ -264,6 +470,7 @@ namespace OptSuite { namespace Base {
         ShrinkageL0(Scalar mu = 1) : mu_(mu) {}
         ~ShrinkageL0() = default;
         void operator()(Ref<const mat_t> x, Scalar t, Ref<mat_t> y);
+        bool is_reentrant() const { return true; }
 
     private:
         Scalar mu_;
@@ -274,6 +481,7 @@ namespace OptSuite { namespace Base {
         ShrinkageLInf(Scalar mu = 1) : mu_(mu) {}
         ~ShrinkageLInf() = default;
         void operator()(Ref<const mat_t> x, Scalar t, Ref<mat_t> y);
+        bool is_reentrant() const { return true; }
 
     private:
         Scalar mu_;
@@ -288,14 +496,184 @@ namespace OptSuite { namespace Base {
         ~ShrinkageL2Rowwise() = default;
 
         void operator()(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+        PenaltyGroups penalty_groups() const { return PenaltyGroups::Rows; }
+        Scalar        penalty_weight() const { return mu; }
+        bool          has_conjugate() const { return true; }
+        Scalar        dual_scale(const Ref<const mat_t> g) const {
+            Scalar d = g.rowwise().norm().maxCoeff();
+            return d > mu ? mu / d : 1_s;
+        }
+        bool has_jacobian() const { return true; }
+        void jacobian(const Ref<const mat_t>, const Ref<const mat_t>, Scalar,
+                      const Ref<const mat_t>, Ref<mat_t>) const;
 
         Scalar mu;
     };
 
+    // mu * sum_g w_g ||x_g||_F over the groups of a GroupIndex, x_g the rows
+    // of group g; rows in no group are free. For overlapping groups the
+    // argument is the latent variable v of GroupIndex::duplicate.
+    class GroupL2Norm : public Func<Scalar> {
+        public:
+            // w_g = 1 when weights is empty
+            GroupL2Norm(const GroupIndex& groups, Scalar mu = 1, Vec weights = Vec());
+            Scalar operator()(const Ref<const mat_t>);
+            bool is_reentrant() const { return true; }
+
+        private:
+            GroupIndex groups_;
+            Vec        weights_;
+            Scalar     mu_;
+    };
+
+    // the prox of GroupL2Norm: every group is scaled by max(0, 1 - t mu w_g / ||x_g||),
+    // in parallel over the groups
+    class ShrinkageGroupL2 : public Proximal<Scalar> {
+        public:
+            ShrinkageGroupL2(const GroupIndex& groups, Scalar mu = 1, Vec weights = Vec());
+            ~ShrinkageGroupL2() = default;
+
+            void   operator()(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+            bool   is_reentrant() const { return true; }
+            // the conjugate is finite only at zero on free rows, so there is
+            // no gap without a covering. Groups of zero weight are free too:
+            // dual_scale takes g as zero on them once it is below
+            // 1e-10 ||g||, and the gap is then approximate, not a bound
+            bool   has_conjugate() const { return groups_.covering(); }
+            Scalar dual_scale(const Ref<const mat_t> g) const;
+            bool   has_jacobian() const { return true; }
+            void   jacobian(const Ref<const mat_t>, const Ref<const mat_t>, Scalar,
+                            const Ref<const mat_t>, Ref<mat_t>) const;
+
+        private:
+            GroupIndex groups_;
+            Vec        weights_;
+            Scalar     mu_;
+    };
+
+    // mu * sum_i |x_{i+1,j} - x_{i,j}|, the total variation of every column of x
+    class TV1DNorm : public Func<Scalar> {
+        public:
+            inline TV1DNorm(Scalar mu = 1) : mu_(mu) {}
+            Scalar operator()(const Ref<const mat_t>);
+            bool is_reentrant() const { return true; }
+
+        private:
+            Scalar mu_;
+    };
+
+    // the prox of TV1DNorm, exact in O(n) per column by the dynamic
+    // programming of Johnson, columns in parallel
+    class TV1DProx : public Proximal<Scalar> {
+        public:
+            inline TV1DProx(Scalar mu = 1) : mu_(mu) {}
+            ~TV1DProx() = default;
+
+            void operator()(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+            bool is_reentrant() const { return true; }
+            Index work_per_entry() const { return 8; }
+
+        private:
+            Scalar mu_;
+    };
+
+    // the total variation of an image x with forward differences along the
+    // columns (d1) and the rows (d2): mu * sum |d1| + |d2| for
+    // TVType::Anisotropic, mu * sum sqrt(d1^2 + d2^2) for TVType::Isotropic
+    enum class TVType {
+        Anisotropic,
+        Isotropic,
+    };
+
+    class TV2DNorm : public Func<Scalar> {
+        public:
+            inline TV2DNorm(Scalar mu = 1, TVType type = TVType::Anisotropic)
+                : mu_(mu), type_(type) {}
+            Scalar operator()(const Ref<const mat_t>);
+            bool is_reentrant() const { return true; }
+
+        private:
+            Scalar mu_;
+            TVType type_;
+    };
+
+    // the prox of TV2DNorm by an iterative method of at most maxit iterations:
+    // - Anisotropic: Dykstra's splitting into the exact 1D prox of the
+    //   columns and of the rows, each in parallel, stopped when the relative
+    //   change of y is below tol,
+    // - Isotropic: the fast gradient projection of Beck and Teboulle on the
+    //   dual (Chambolle's formulation), in parallel over the columns, stopped
+    //   when the duality gap is below tol * max(1, objective); the dual
+    //   variables are kept as the warm start of the next call.
+    // y may be x.
+    class TV2DProx : public Proximal<Scalar> {
+        public:
+            TV2DProx(Scalar mu = 1, TVType type = TVType::Anisotropic, Index maxit = 500,
+                     Scalar tol = 1e-8)
+                : mu_(mu), type_(type), maxit_(maxit), tol_(tol) {}
+            ~TV2DProx() = default;
+
+            void operator()(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+            // iterations of the last call
+            inline Index iters() const { return iters_; }
+
+        private:
+            void dykstra(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+            void fgp(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+
+            Scalar mu_;
+            TVType type_;
+            Index  maxit_;
+            Scalar tol_;
+            Index  iters_ = 0;
+            mat_t  p_, q_, r_, s_, z_, x_;
+    };
+
+    // the sorted l1 norm of SLOPE, mu * sum_i lambda_i |x|_(i) with |x|_(1) >=
+    // |x|_(2) >= ... the entries of a column by magnitude, for every column of x;
+    // lambda is nonincreasing and nonnegative with one entry per row
+    class SortedL1Norm : public Func<Scalar> {
+        public:
+            SortedL1Norm(const Ref<const Vec> lambda, Scalar mu = 1);
+            Scalar operator()(const Ref<const mat_t>);
+            bool is_reentrant() const { return true; }
+
+        private:
+            Vec    lambda_;
+            Scalar mu_;
+    };
+
+    // the prox of SortedL1Norm in O(n log n) per column: the magnitudes are
+    // sorted, shifted by t mu lambda and projected onto the nonincreasing
+    // nonnegative vectors by pool adjacent violators on a stack of blocks
+    class SortedL1Prox : public Proximal<Scalar> {
+        public:
+            SortedL1Prox(const Ref<const Vec> lambda, Scalar mu = 1);
+            ~SortedL1Prox() = default;
+
+            void   operator()(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+            bool   is_reentrant() const { return true; }
+            Index  work_per_entry() const { return 32; }
+            // the conjugate is the indicator of the dual ball: the partial sums
+            // of the sorted magnitudes are bounded by those of mu lambda
+            bool   has_conjugate() const { return true; }
+            Scalar dual_scale(const Ref<const mat_t> g) const;
+            // the average over the entries of a block of equal magnitude, with
+            // their signs, and zero off the support
+            bool   has_jacobian() const { return true; }
+            void   jacobian(const Ref<const mat_t>, const Ref<const mat_t>, Scalar,
+                            const Ref<const mat_t>, Ref<mat_t>) const;
+
+        private:
+            Vec    lambda_;
+            Scalar mu_;
+    };
+
     class ShrinkageNuclear : public Proximal<Scalar> {
         using vec_t = Vec;
         using fmat_t = FactorizedMat<Scalar>;
         using smat_t = SpMatWrapper<Scalar>;
+        using ssmat_t = SharedSpMat<Scalar>;
         vec_t d;
         Eigen::JacobiSVD<mat_t> svd; // JacobiSVD is using LAPACKE/MKL
         LinAlg::LANSVD<Scalar> lansvd;
@@ -304,6 +682,9 @@ namespace OptSuite { namespace Base {
                       Eigen::DecompositionOptions::ComputeThinV;
 
         Index compute_rank() const;
+        // x = prox(xp - tau * gp) for a sparse gp of either storage
+        template<typename S>
+        void factorized(const fmat_t&, Scalar, const S&, Scalar, fmat_t&);
 
         public:
             inline ShrinkageNuclear(Scalar mu_ = 1) : mu(mu_) {}
@@ -313,7 +694,10 @@ namespace OptSuite { namespace Base {
 
             void operator()(const Ref<const mat_t>, Scalar, Ref<mat_t>);
             void operator()(const fmat_t&, Scalar, const smat_t&, Scalar, fmat_t&);
+            void operator()(const fmat_t&, Scalar, const ssmat_t&, Scalar, fmat_t&);
             void operator()(const var_t&, Scalar, const var_t&, Scalar, var_t&);
+            bool   has_conjugate() const { return true; }
+            Scalar dual_scale(const Ref<const mat_t>) const;
 
             Scalar mu;
 
@@ -337,28 +721,110 @@ namespace OptSuite { namespace Base {
             virtual Scalar operator()(const mat_wrapper_t&, mat_wrapper_t&, bool = true);
             virtual Scalar operator()(const var_t&);
             virtual Scalar operator()(const var_t&, var_t&, bool = true);
+            // see Func::is_reentrant and Func::work_per_entry
+            virtual bool is_reentrant() const { return false; }
+            virtual Index work_per_entry() const { return 1; }
+            // f(x) = L(Ax) with a known conjugate: dual_objective(x, f(x), s) is
+            // -L*(s u), u the gradient of L at Ax, the loss part of the dual
+            // objective of the duality gap, see SolverOptions::gap_tol
+            virtual bool has_dual() const { return false; }
+            virtual Scalar dual_objective(const Ref<const mat_t>, Scalar, Scalar);
+            // hessian(x, v, y) sets y = H v, H the Hessian of f at x, for the
+            // Newton solvers; a function may keep data of x between calls
+            virtual bool has_hessian() const { return false; }
+            virtual void hessian(const Ref<const mat_t>, const Ref<const mat_t>, Ref<mat_t>);
+            // prox(v, t, y) sets y = argmin_x f(x) + ||x - v||^2 / (2 t), for
+            // the splitting solvers
+            virtual bool has_prox() const { return false; }
+            virtual void prox(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+    };
 
+    // f(x) = sum_{i < num_samples()} f_i(x)
+    //
+    // batch() sums f_i and their gradients over a subset B of the samples, so
+    // that N / |B| * batch() is an unbiased estimate of f and of its gradient
+    // when B is drawn uniformly. The indices may repeat.
+    //
+    // In a linear model the gradient of f_i is a_i d_i(x), with a fixed column
+    // a_i and a row d_i of the width of x. Such functions return true from
+    // is_linear_model() and give access to d_i and to sum_i a_i d_i, which
+    // lets the stochastic solvers keep one row per sample.
+    template<typename dtype>
+    class FiniteSumFuncGrad : public FuncGrad<dtype> {
+        public:
+            using typename FuncGrad<dtype>::mat_t;
+            FiniteSumFuncGrad() = default;
+            ~FiniteSumFuncGrad() = default;
+
+            virtual Index num_samples() const = 0;
+            // returns sum_{i in batch} f_i(x), y = sum_{i in batch} grad f_i(x)
+            virtual Scalar batch(const Ref<const mat_t>, const std::vector<Index>&,
+                                 Ref<mat_t>, bool = true) = 0;
+            // batch() of one sample
+            Scalar sample(const Ref<const mat_t>, Index, Ref<mat_t>, bool = true);
+
+            virtual bool is_linear_model() const { return false; }
+            // D.row(j) = d_{batch[j]}(x)
+            virtual void sample_derivative(const Ref<const mat_t>, const std::vector<Index>&,
+                                           Ref<mat_t>);
+            // y += alpha * sum_j a_{batch[j]} D.row(j)
+            virtual void add_samples(const std::vector<Index>&, const Ref<const mat_t>,
+                                     Scalar, Ref<mat_t>);
     };
 
+    // one sample per row of A
     template<typename dtype = Scalar>
-    class AxmbNormSqr : public FuncGrad<dtype> {
+    class AxmbNormSqr : public FiniteSumFuncGrad<dtype> {
         public:
             using typename FuncGrad<dtype>::mat_t;
             AxmbNormSqr(const Ref<const mat_t>, const Ref<const mat_t>);
             ~AxmbNormSqr() = default;
 
             Scalar       operator()(const Ref<const mat_t>, Ref<mat_t>, bool = true);
+            Index        num_samples() const { return A.rows(); }
+            Scalar       batch(const Ref<const mat_t>, const std::vector<Index>&, Ref<mat_t>,
+                               bool = true);
+            bool         is_linear_model() const { return true; }
+            void         sample_derivative(const Ref<const mat_t>, const std::vector<Index>&,
+                                           Ref<mat_t>);
+            void         add_samples(const std::vector<Index>&, const Ref<const mat_t>, Scalar,
+                                     Ref<mat_t>);
             const mat_t &get_A() const;
             const mat_t &get_b() const;
+            bool         has_dual() const { return true; }
+            Scalar       dual_objective(const Ref<const mat_t>, Scalar, Scalar);
+            bool         has_hessian() const { return true; }
+            void         hessian(const Ref<const mat_t>, const Ref<const mat_t>, Ref<mat_t>);
+            // solves (I + t A'A) y = v + t A'b by a Cholesky factorization of
+            // I + t A'A, or of I + t AA' and the Woodbury identity when A has
+            // fewer rows than columns; the factorization is kept until t changes
+            bool         has_prox() const { return true; }
+            void         prox(const Ref<const mat_t>, Scalar, Ref<mat_t>);
+            // Ax - b at the last evaluation
+            const mat_t &residual() const { return r; }
+
+            // restricts the evaluation to the given columns of A, the other
+            // rows of x are taken as zero and get a zero gradient. Used by the
+            // screening rules, operator() only.
+            void set_active(const std::vector<Index>&);
+            void clear_active();
 
         private:
             mat_t A;
             mat_t b;
             mat_t r;
+            bool               screened = false;
+            std::vector<Index> active;
+            mat_t              A_active;
+            mat_t              Atb;   // A'b, for the dual objective and the prox
+            mat_t              gram;      // A'A, or AA' when A is wide
+            Scalar             prox_t = 0;
+            Eigen::LLT<mat_t>  prox_llt;  // I + prox_t * gram
     };
 
+    // one sample per column of A
     template<typename dtype = Scalar>
-    class LogisticRegression : public FuncGrad<dtype> {
+    class LogisticRegression : public FiniteSumFuncGrad<dtype> {
     public:
         using typename FuncGrad<dtype>::mat_wrapper_t;
         using typename FuncGrad<dtype>::mat_t;
@@ -367,14 +833,31 @@ namespace OptSuite { namespace Base {
         ~LogisticRegression() = default;
 
         Scalar operator()(Ref<const mat_t>, Ref<mat_t>, bool = true);
+        bool is_reentrant() const { return true; }
+        // every feature touches all samples
+        Index work_per_entry() const { return A_.cols(); }
+
+        Index  num_samples() const { return A_.cols(); }
+        Scalar batch(const Ref<const mat_t>, const std::vector<Index>&, Ref<mat_t>, bool = true);
+        bool   is_linear_model() const { return true; }
+        void   sample_derivative(const Ref<const mat_t>, const std::vector<Index>&, Ref<mat_t>);
+        void   add_samples(const std::vector<Index>&, const Ref<const mat_t>, Scalar, Ref<mat_t>);
 
         const mat_t &    get_A() const { return A_; }
         const col_vec_t &get_b() const { return b_; }
+        bool             has_dual() const { return true; }
+        // one more product with A
+        Scalar           dual_objective(Ref<const mat_t>, Scalar, Scalar);
+        // the weights of the samples are kept for the last x, not reentrant
+        bool             has_hessian() const { return true; }
+        void             hessian(const Ref<const mat_t>, const Ref<const mat_t>, Ref<mat_t>);
 
     private:
         mat_t     A_;
         col_vec_t b_;
         mat_t     mbA_;
+        mat_t     hess_x_;   // the point of hess_w_
+        col_vec_t hess_w_;   // sigmoid'(margins) / num_samples()
     };
 
     template<typename dtype = Scalar>
@@ -387,6 +870,8 @@ namespace OptSuite { namespace Base {
     public:
         // construction by referencing a sparse object
         ProjectionOmega(const Ref<const spmat_t>, const Ref<const mat_t>);
+        // construction by sharing the pattern of a SharedSpMat
+        ProjectionOmega(const SharedSpMat<dtype>&, const Ref<const mat_t>);
 
         ~ProjectionOmega() = default;
 
@@ -396,10 +881,12 @@ namespace OptSuite { namespace Base {
     private:
         void                     projection(const Ref<const mat_t>);
         void                     projection(const fmat_t &);
-        std::vector<SparseIndex> outerIndexPtr;
-        std::vector<SparseIndex> innerIndexPtr;
-        mat_t                    b;
-        mat_t                    r;
+        using index_ptr_t = typename SharedSpMat<dtype>::index_ptr_t;
+        // the sampling pattern, shared with the sparse gradients
+        index_ptr_t outerIndexPtr;
+        index_ptr_t innerIndexPtr;
+        mat_t       b;
+        mat_t       r;
     };
 
     }   // namespace Base
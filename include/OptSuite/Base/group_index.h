@@ -0,0 +1,86 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  group_index.h
+ *
+ *    Description:  arbitrary, possibly overlapping groups of the rows of a
+ *                  variable, for the group lasso operators
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 10:41:17 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_BASE_GROUP_INDEX_H
+#define OPTSUITE_BASE_GROUP_INDEX_H
+
+#include <vector>
+#include "OptSuite/core_n.h"
+
+namespace OptSuite { namespace Base {
+    // Groups of the rows of an n x c variable as a CSR map: group g holds the
+    // rows index(k) for k in [ptr(g), ptr(g + 1)). Groups may have any size,
+    // may overlap and need not cover every row.
+    //
+    // Overlapping groups are handled by duplicating the rows (the latent group
+    // lasso): every group gets its own copy v of its rows, x = D v sums the
+    // copies and the penalty on v is separable in the groups of latent().
+    // Rows in no group have no copy, add them as groups of their own with a
+    // zero weight to leave them free.
+    class GroupIndex {
+        public:
+            GroupIndex() = default;
+            // ptr of length num_groups + 1 from 0, idx of length ptr.back()
+            GroupIndex(Index dim, std::vector<Index> ptr, std::vector<Index> idx);
+            // the rows of every group
+            GroupIndex(Index dim, const std::vector<std::vector<Index>>& groups);
+            // row i in group labels[i], or in none for a negative label
+            static GroupIndex from_labels(const std::vector<Index>& labels);
+
+            inline Index dim() const { return dim_; }
+            inline Index num_groups() const { return static_cast<Index>(ptr_.size()) - 1; }
+            // total size of the groups, the number of rows of the latent variable
+            inline Index latent_dim() const { return static_cast<Index>(idx_.size()); }
+            inline Index ptr(Index g) const { return ptr_[g]; }
+            inline Index size(Index g) const { return ptr_[g + 1] - ptr_[g]; }
+            inline Index index(Index k) const { return idx_[k]; }
+            // a row in several groups
+            inline bool overlapping() const { return overlapping_; }
+            // every row in a group
+            inline bool covering() const { return covering_; }
+            // every group is a range of consecutive rows, index(ptr(g)) on
+            inline bool contiguous() const { return contiguous_; }
+
+            // bounds of consecutive groups with about grain entries of an
+            // n x cols variable each, see MatArray_t::Layout::chunks
+            std::vector<Index> chunks(Size grain, Index cols = 1) const;
+
+            // the groups of the latent variable: group g is the range
+            // [ptr(g), ptr(g + 1)) of its rows
+            GroupIndex latent() const;
+            // v.row(k) = x.row(index(k))
+            void duplicate(const Ref<const Mat> x, Ref<Mat> v) const;
+            // x = D v: row i of x is the sum of the copies of row i in v
+            void collapse(const Ref<const Mat> v, Ref<Mat> x) const;
+            // A D, the design of the latent problem for a design A of x
+            Mat duplicate_columns(const Ref<const Mat> A) const;
+
+        private:
+            void init();
+
+            Index dim_ = 0;
+            std::vector<Index> ptr_ = std::vector<Index>(1, 0);
+            std::vector<Index> idx_;
+            bool overlapping_ = false;
+            bool covering_ = true;
+            bool contiguous_ = true;
+    };
+}}
+
+#endif
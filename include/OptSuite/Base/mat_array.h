@@ -21,33 +21,129 @@
 
 #include <vector>
 #include <iostream>
+#include <memory>
 #include "OptSuite/core_n.h"
 #include "OptSuite/Base/variable.h"
+#include "OptSuite/Utils/aligned_allocator.h"
 
+// The blocks of a MatArray_t are stored one after another in a single buffer.
+// To build an array of many blocks, describe the blocks with a Layout first
+// and allocate once:
+//     MatArray::Layout layout(64);   // each block starts on a 64-byte boundary
+//     layout.add_blocks(4, 4, 1000);
+//     layout.add_blocks(16, 1, 10);
+//     MatArray x(layout);            // zero-initialized
+//
+// With an alignment the blocks are separated by zero padding. vec() views the
+// blocks as one vector and is only available when there is no padding; the
+// reductions (dot, norm, ...) and the expressions of var_expr.h work on the
+// whole buffer and rely on the padding staying zero.
+
+#ifndef OPTSUITE_MAT_ARRAY_ALIGN
+#define OPTSUITE_MAT_ARRAY_ALIGN 64
+#endif
+
+// entries per unit of work of the block-wise parallel kernels
+#ifndef OPTSUITE_MAT_ARRAY_GRAIN
+#define OPTSUITE_MAT_ARRAY_GRAIN 16384
+#endif
 
 namespace OptSuite { namespace Base {
     template<typename dtype>
     class MatArray_t : public Variable<dtype>{
         using mat_t = Eigen::Matrix<dtype, Dynamic, Dynamic>;
         using vec_t = Eigen::Matrix<dtype, Dynamic, 1>;
-        std::vector<dtype> _data;
-        std::vector<std::pair<Size,Size>> _block_info;
-        std::vector<Index> _offset;
-        mutable std::vector<Map<const mat_t>> _blocks_it;
 
-        void gen_blocks_it() const;
+        public:
+            // shapes and offsets of the blocks, without storage
+            class Layout {
+                public:
+                    // every block starts at a multiple of align_bytes (at most
+                    // OPTSUITE_MAT_ARRAY_ALIGN) from the start of the buffer,
+                    // 0 packs the blocks
+                    explicit Layout(Size align_bytes = 0);
+
+                    Layout& add_blocks(Size, Size, Size = 1);
+                    void reserve(Size);
+
+                    inline Size total_blocks() const { return _block_info.size(); }
+                    // number of entries of the blocks
+                    inline Size total_size() const { return _size; }
+                    // number of entries including the padding
+                    inline Size storage_size() const { return _storage; }
+                    inline bool padded() const { return _storage != _size; }
+                    // alignment in entries
+                    inline Size alignment() const { return _align; }
+
+                    inline Index offset(Index i) const { return _offset[i]; }
+                    inline Size rows(Index i) const { return _block_info[i].first; }
+                    inline Size cols(Index i) const { return _block_info[i].second; }
+
+                    // block boundaries 0 = c_0 < c_1 < ... < c_k = total_blocks()
+                    // such that each range [c_j, c_{j+1}) holds about grain
+                    // entries (or a single larger block). Depends only on the
+                    // shapes, so that chunked reductions are reproducible.
+                    std::vector<Index> chunks(Size = OPTSUITE_MAT_ARRAY_GRAIN) const;
+
+                    bool operator==(const Layout&) const;
+                    inline bool operator!=(const Layout& other) const { return !(*this == other); }
+
+                private:
+                    std::vector<std::pair<Size,Size>> _block_info;
+                    std::vector<Index> _offset;
+                    Size _align = 1;
+                    Size _size = 0;
+                    Size _storage = 0;
+            };
+
+        private:
+            std::vector<dtype, Utils::AlignedAllocator<dtype, OPTSUITE_MAT_ARRAY_ALIGN>> _data;
+            // shared by the copies and the zeros_like of an array, so that
+            // comparing layouts is usually a pointer comparison
+            std::shared_ptr<Layout> _layout = std::make_shared<Layout>();
+            // one Map per block into _data, kept in sync with _layout
+            std::vector<Map<const mat_t>> _blocks_it;
+
+            void allocate();
+            void update_blocks_it(Index);
 
         public:
             using iterator = typename std::vector<Map<const mat_t>>::const_iterator;
 
-            MatArray_t() = default;
+            MatArray_t() : Variable<dtype>(VariableKind::Array) {}
+            explicit MatArray_t(const Layout&);
             MatArray_t(const MatArray_t<dtype>&);
+            MatArray_t(MatArray_t<dtype>&&);
+            template<int N>
+            MatArray_t(const LinCombExpr<MatArray_t, N>& e) : Variable<dtype>(VariableKind::Array) {
+                e.eval_to(*this);
+            }
+
+            static constexpr VariableKind static_kind() { return VariableKind::Array; }
+
             MatArray_t<dtype>& operator=(const MatArray_t<dtype>&);
+            MatArray_t<dtype>& operator=(MatArray_t<dtype>&&);
             Variable<dtype>& operator=(const Variable<dtype>&);
+            // evaluates x = sum_k c_k x_k in one pass over the storage, see var_expr.h
+            template<int N>
+            MatArray_t<dtype>& operator=(const LinCombExpr<MatArray_t, N>& e){
+                e.eval_to(*this);
+                return *this;
+            }
             Size total_size() const;
             Size total_blocks() const;
+            // appends count blocks of size m x n, the storage grows geometrically
             void add_blocks(Size, Size, Size = 1);
             void reserve(Size);
+            // replaces the blocks with the given layout, zero-initialized
+            void set_layout(const Layout&);
+            inline const Layout& layout() const { return *_layout; }
+            // true if the blocks of other have the same shapes as ours
+            bool same_layout(const MatArray_t<dtype>&) const;
+            // whole buffer, including the padding
+            inline Size storage_size() const { return _layout->storage_size(); }
+            inline dtype* data() { return _data.data(); }
+            inline const dtype* data() const { return _data.data(); }
             Map<vec_t> vec();
             Map<const vec_t> vec() const;
             Map<mat_t> operator[](Index);
@@ -21,6 +21,7 @@
 
 #include "OptSuite/core_n.h"
 #include "OptSuite/Base/spmat_wrapper.h"
+#include "OptSuite/Base/shared_spmat.h"
 #include "OptSuite/Base/factorized_mat.h"
 
 namespace OptSuite { namespace Base {
@@ -49,34 +50,53 @@ namespace OptSuite { namespace Base {
     template<typename dtype>
     class FactorizePSpMatOp : public MatOp<dtype> {
         using mat_t = Eigen::Matrix<dtype, Dynamic, Dynamic>;
+        using spmat_t = Eigen::SparseMatrix<dtype, ColMajor, SparseIndex>;
         Scalar tau;
         const FactorizedMat<dtype>* mat_F;
-        const SpMatWrapper<dtype>* mat_S;
+        // the sparse term is viewed through its compressed arrays, so that
+        // both SpMatWrapper and SharedSpMat can be used without a copy
+        Index nnz_S;
+        const SparseIndex* outer_S;
+        const SparseIndex* inner_S;
+        const dtype* value_S;
+
+        inline Map<const spmat_t> mat_S() const {
+            return Map<const spmat_t>(this->rows(), this->cols(), nnz_S, outer_S, inner_S, value_S);
+        }
 
         public:
-            FactorizePSpMatOp() : mat_F(NULL), mat_S(NULL), tau(0_s) {}
+            FactorizePSpMatOp() : tau(0_s), mat_F(NULL), nnz_S(0),
+                outer_S(NULL), inner_S(NULL), value_S(NULL) {}
             FactorizePSpMatOp(Index m, Index n) : MatOp<dtype>(m, n) {}
             FactorizePSpMatOp(const FactorizedMat<dtype>& mf, Scalar t, const SpMatWrapper<dtype>& ms)
-                : MatOp<dtype>(mf.rows(), mf.cols()), tau(t), mat_F(&mf), mat_S(&ms) {}
+                : MatOp<dtype>(mf.rows(), mf.cols()), tau(t), mat_F(&mf),
+                nnz_S(ms.spmat().nonZeros()), outer_S(ms.spmat().outerIndexPtr()),
+                inner_S(ms.spmat().innerIndexPtr()), value_S(ms.spmat().valuePtr()) {
+                OPTSUITE_ASSERT(ms.spmat().isCompressed());
+            }
+            FactorizePSpMatOp(const FactorizedMat<dtype>& mf, Scalar t, const SharedSpMat<dtype>& ms)
+                : MatOp<dtype>(mf.rows(), mf.cols()), tau(t), mat_F(&mf),
+                nnz_S(ms.nonZeros()), outer_S(ms.outerIndexPtr()),
+                inner_S(ms.innerIndexPtr()), value_S(ms.valuePtr()) {}
 
             inline void apply(const Ref<const mat_t> in, Ref<mat_t> out) const {
-                OPTSUITE_ASSERT(mat_F && mat_S);
+                OPTSUITE_ASSERT(mat_F && outer_S);
                 // (UV' + tauS)X = U(V'X) + tau (SX)
                 if (tau == 0_s)
                     out = mat_F->U() * (mat_F->V().transpose() * in);
                 else
                     out = mat_F->U() * (mat_F->V().transpose() * in) +
-                        tau * (mat_S->spmat() * in);
+                        tau * (mat_S() * in);
             }
 
             inline void apply_transpose(const Ref<const mat_t> in, Ref<mat_t> out) const {
-                OPTSUITE_ASSERT(mat_F && mat_S);
+                OPTSUITE_ASSERT(mat_F && outer_S);
                 // (UV' + tauS)'X = V(U'X) + tau (S'X)
                 if (tau == 0_s)
                     out = mat_F->V() * (mat_F->U().transpose() * in);
                 else
                     out = mat_F->V() * (mat_F->U().transpose() * in) +
-                        tau * (mat_S->spmat().transpose() * in);
+                        tau * (mat_S().transpose() * in);
             }
     };
 }}
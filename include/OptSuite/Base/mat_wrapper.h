@@ -32,9 +32,15 @@ namespace OptSuite { namespace Base {
         mat_t data_;
 
         public:
-            MatWrapper() = default;
+            MatWrapper() : Variable<dtype>(VariableKind::Dense) {}
             ~MatWrapper() = default;
-            MatWrapper(const Ref<const mat_t> A) : data_{A} {}
+            MatWrapper(const Ref<const mat_t> A) : Variable<dtype>(VariableKind::Dense), data_{A} {}
+            template<int N>
+            MatWrapper(const LinCombExpr<MatWrapper, N>& e) : Variable<dtype>(VariableKind::Dense) {
+                e.eval_to(*this);
+            }
+
+            static constexpr VariableKind static_kind() { return VariableKind::Dense; }
 
             inline mat_t& mat() { return data_; }
             inline const mat_t& mat() const { return data_; }
@@ -50,20 +56,32 @@ namespace OptSuite { namespace Base {
 
             // operations
             Variable<dtype>& operator=(const Variable<dtype>& other){
-                const MatWrapper* other_ptr = dynamic_cast<const MatWrapper*>(&other);
+                const MatWrapper* other_ptr = variable_cast<MatWrapper>(&other);
                 OPTSUITE_ASSERT(other_ptr);
                 data_ = other_ptr->data_;
                 return *this;
             }
 
+            // evaluates x = sum_k c_k x_k in one pass, see var_expr.h
+            template<int N>
+            MatWrapper& operator=(const LinCombExpr<MatWrapper, N>& e){
+                e.eval_to(*this);
+                return *this;
+            }
+
             inline dtype dot(const Variable<dtype>& other) const {
-                const MatWrapper* other_ptr = dynamic_cast<const MatWrapper*>(&other);
-                const SpMatWrapper<dtype>* other_ptr_s = dynamic_cast<const SpMatWrapper<dtype>*>(&other);
-                OPTSUITE_ASSERT(other_ptr || other_ptr_s);
-                if (other_ptr)
-                    return this->dot(*other_ptr);
-                else
-                    return this->dot(*other_ptr_s);
+                switch (other.kind()){
+                    case VariableKind::Dense:
+                        return this->dot(static_cast<const MatWrapper&>(other));
+                    case VariableKind::Sparse:
+                        return this->dot(static_cast<const SpMatWrapper<dtype>&>(other));
+                    case VariableKind::SharedSparse:
+                        // conj(<S, x>), SharedSpMat implements the mixed products
+                        return Eigen::numext::conj(other.dot(*this));
+                    default:
+                        OPTSUITE_ASSERT(false);
+                        return dtype(0);
+                }
             }
 
             inline void set_zero_like(const Ref<const mat_t> other) {
@@ -71,7 +89,7 @@ namespace OptSuite { namespace Base {
                 data_.setZero();
             }
             inline void set_zero_like(const Variable<dtype>& other) {
-                const MatWrapper* other_ptr = dynamic_cast<const MatWrapper*>(&other);
+                const MatWrapper* other_ptr = variable_cast<MatWrapper>(&other);
                 OPTSUITE_ASSERT(other_ptr);
 
                 data_.resize(other_ptr->data_.rows(), other_ptr->data_.cols());
@@ -80,7 +98,7 @@ namespace OptSuite { namespace Base {
 
             inline
             virtual Scalar squared_norm_diff(const Variable<dtype>& other) const {
-                const MatWrapper* other_ptr = dynamic_cast<const MatWrapper*>(&other);
+                const MatWrapper* other_ptr = variable_cast<MatWrapper>(&other);
                 OPTSUITE_ASSERT(other_ptr);
                 return (data_ - other_ptr->data_).squaredNorm();
             }
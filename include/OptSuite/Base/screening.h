@@ -0,0 +1,68 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  screening.h
+ *
+ *    Description:  safe feature elimination for l1 and l1,2 regularized
+ *                  least squares
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 08:02:37 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_BASE_SCREENING_H
+#define OPTSUITE_BASE_SCREENING_H
+
+#include <vector>
+#include "OptSuite/core_n.h"
+#include "OptSuite/Base/functional.h"
+
+namespace OptSuite { namespace Base {
+    // Gap-safe sphere test for
+    //   min 0.5 * ||Ax - b||_F^2 + mu * sum_j ||x_j||,
+    // x_j the j-th row of x, with the l_inf norm of the row for
+    // PenaltyGroups::Entries (l1 norm of x) and the l_2 norm for
+    // PenaltyGroups::Rows (group lasso). theta = (b - Ax) / max(mu, max_j ||A_j' r||_*)
+    // is dual feasible, and every solution has x_j = 0 when
+    //   ||A_j' theta||_* + ||A_j||_2 sqrt(2 gap) / mu < 1,
+    // with gap the duality gap at x and theta. Rows dropped earlier are zero
+    // at every solution, so the test on the remaining ones stays safe.
+    class GapSafeScreening {
+        public:
+            // col_norms: ||A_j||_2
+            GapSafeScreening(Vec col_norms, const Ref<const Mat> b, PenaltyGroups, Scalar mu);
+
+            // x, r = Ax - b and g = A'r, read on the rows in active only. Removes
+            // the rows that pass the test from active and returns the gap.
+            Scalar operator()(const Ref<const Mat> x, const Ref<const Mat> r,
+                              const Ref<const Mat> g, std::vector<Index>& active);
+            // the same from ||r||^2 and <b, r> instead of r
+            Scalar operator()(const Ref<const Mat> x, Scalar r_sqr, Scalar b_r,
+                              const Ref<const Mat> g, std::vector<Index>& active);
+
+            // duality gap at x, without screening
+            Scalar gap(const Ref<const Mat> x, const Ref<const Mat> r, const Ref<const Mat> g,
+                       const std::vector<Index>& active) const;
+
+        private:
+            Scalar group_norm(const Ref<const Mat> x, Index j) const;
+            Scalar dual_norm(const Ref<const Mat> g, Index j) const;
+            Scalar dual_scale(const Ref<const Mat> g, const std::vector<Index>& active) const;
+            Scalar gap(const Ref<const Mat> x, Scalar r_sqr, Scalar b_r, Scalar s,
+                       const std::vector<Index>& active) const;
+
+            Vec col_norms_;
+            Mat b_;
+            PenaltyGroups groups_;
+            Scalar mu_;
+    };
+}}
+
+#endif
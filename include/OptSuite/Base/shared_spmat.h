@@ -23,40 +23,104 @@
 #include <memory>
 #include "OptSuite/core_n.h"
 #include "OptSuite/Base/variable.h"
+#include "OptSuite/Base/mat_wrapper.h"
+#include "OptSuite/Base/factorized_mat.h"
+
+// A column-major sparse matrix whose sparsity pattern (outer and inner index
+// arrays) is shared with other SharedSpMats, e.g. the iterates, gradients and
+// residuals of a matrix completion problem on one sampling pattern. Copies,
+// set_zero_like and the expressions of var_expr.h share the pattern; only the
+// values are stored per matrix. Operations between matrices of the same
+// pattern (dot, norms, axpy) are dense vector kernels on the values.
+//
+// The pattern is copied on write: the non-const index accessors, resize and
+// reserve detach the matrix from the other owners first. spmat() exposes the
+// matrix to Eigen read-only; the values are modified through values() or
+// valuePtr().
 
 namespace OptSuite { namespace Base {
     template<typename dtype>
     class SharedSpMat : public Variable<dtype> {
         using spmat_t = Eigen::SparseMatrix<dtype, ColMajor, SparseIndex>;
-        std::vector<dtype> data_;
-        std::shared_ptr<std::vector<SparseIndex>> outer_;
-        std::shared_ptr<std::vector<SparseIndex>> inner_;
+        using vec_t = Eigen::Matrix<dtype, Dynamic, 1>;
+        public:
+            using index_ptr_t = std::shared_ptr<const std::vector<SparseIndex>>;
+
+        private:
+            Index rows_ = 0;
+            std::vector<dtype> data_;
+            index_ptr_t outer_;
+            index_ptr_t inner_;
+
+            // copy on write of the pattern
+            std::vector<SparseIndex>& own_outer();
+            std::vector<SparseIndex>& own_inner();
+
         public:
-            SharedSpMat() = default;
+            SharedSpMat();
             SharedSpMat(Index, Index);
+            // copies the pattern and the values of a sparse matrix
+            explicit SharedSpMat(const spmat_t&);
+            // rows, outer and inner index arrays to share, zero values
+            SharedSpMat(Index, index_ptr_t, index_ptr_t);
+            template<int N>
+            SharedSpMat(const LinCombExpr<SharedSpMat, N>& e) : SharedSpMat() {
+                e.eval_to(*this);
+            }
+
+            static constexpr VariableKind static_kind() { return VariableKind::SharedSparse; }
+
             SharedSpMat& operator=(const SharedSpMat&);
             Variable<dtype>& operator=(const Variable<dtype>&);
+            // evaluates x = sum_k c_k x_k on the values, see var_expr.h
+            template<int N>
+            SharedSpMat& operator=(const LinCombExpr<SharedSpMat, N>& e){
+                e.eval_to(*this);
+                return *this;
+            }
 
             Index rows() const;
             Index cols() const;
             Index nonZeros() const;
 
+            // empty rows x cols matrix with a pattern of its own
             void resize(Index, Index);
+            // room for nnz entries, to be filled through the pointers
             void reserve(Index);
 
+            // shares the given pattern, the values are set to zero
+            void set_pattern(Index, index_ptr_t, index_ptr_t);
+            inline const index_ptr_t& outer_index() const { return outer_; }
+            inline const index_ptr_t& inner_index() const { return inner_; }
+            // same pattern, usually a pointer comparison
+            bool same_pattern(const SharedSpMat&) const;
+
             const SparseIndex* outerIndexPtr() const;
             SparseIndex* outerIndexPtr();
 
             const SparseIndex* innerIndexPtr() const;
             SparseIndex* innerIndexPtr();
 
-            const Scalar* valuePtr() const;
-            Scalar* valuePtr();
+            const dtype* valuePtr() const;
+            dtype* valuePtr();
+
+            Map<const vec_t> values() const;
+            Map<vec_t> values();
 
             Map<const spmat_t> spmat() const;
-            Map<spmat_t> spmat();
+
+            dtype dot(const SharedSpMat&) const;
+            dtype dot(const MatWrapper<dtype>&) const;
+            dtype dot(const SpMatWrapper<dtype>&) const;
+            dtype dot(const FactorizedMat<dtype>&) const;
+            dtype dot(const Variable<dtype>&) const;
+            Scalar squaredNorm() const;
+            Scalar norm() const;
+
+            void set_zero_like(const Variable<dtype>&);
+            inline bool has_squared_norm_diff() const { return true; }
+            Scalar squared_norm_diff(const Variable<dtype>&) const;
     };
 }}
 
 #endif
-
@@ -20,6 +20,7 @@
 #define OPTSUITE_BASE_SOLVER_H
 
 #include "OptSuite/Base/functional.h"
+#include "OptSuite/Utils/arena.h"
 #include "OptSuite/core_n.h"
 #include <functional>
 #include <string>
@@ -121,6 +122,8 @@ public:
     const StepSizeStrategy &    step_size_strategy() { return step_size_strategy_; }
     BBStepSize &                bb() {return bb_;}
     Verbosity                   verbosity();
+    Index                       screening() const { return screening_; }
+    Scalar                      gap_tol() const { return gap_tol_; }
 
     // setter
     void ftol(Scalar);
@@ -136,6 +139,15 @@ public:
     void deminishing2(const Deminishing2StepSize &deminishing2) { deminishing2_ = deminishing2; }
     void fixed(const FixedStepSize &fixed) { fixed_ = fixed; }
     void bb(BBStepSize &bb) { bb_ = bb; }
+    // iterations between the screening tests of the solvers that have them,
+    // 0 disables screening
+    void screening(Index interval) { screening_ = interval; }
+    // the solvers that certify their result stop once the duality gap is at
+    // most gap_tol * max(1, |obj|), 0 keeps the ftol test
+    void gap_tol(Scalar gap_tol) {
+        OPTSUITE_ASSERT(gap_tol >= 0);
+        gap_tol_ = gap_tol;
+    }
 
 protected:
     Scalar ftol_;   ///< The objective value variation tolerance
@@ -150,26 +162,297 @@ protected:
     Deminishing2StepSize deminishing2_;
     FixedStepSize        fixed_;
     BBStepSize           bb_;
+    Index                screening_ = 0;
+    Scalar               gap_tol_   = 0;
 };
 
 struct SolverRecords {
     Index               n_iters = 0;
     std::vector<Scalar> obj_hist;
+    std::vector<time_t> time_hist_us;   ///< elapsed time at each entry of obj_hist
     time_t              elapsed_time_us = 0;
+    Size                arena_bytes = 0;   ///< peak memory of the temporaries of the solver
+    Scalar              data_passes = 0;   ///< sample gradients / num_samples, stochastic solvers only
+    Index               screened = 0;      ///< columns dropped by the screening rules
+    /// duality gap at the result, -1 if not certified. A bound on the distance to the optimal
+    /// value, except with zero-weight groups in ShrinkageGroupL2 where it is approximate
+    Scalar              gap = -1;
+    Index               cg_iters = 0;      ///< inner conjugate gradient iterations, Newton solvers only
+    Index               rho_updates = 0;   ///< changes of the penalty, ADMM only
 
     Index  get_n_iters() { return n_iters; }
     time_t get_elapsed_time_us() { return elapsed_time_us; }
 };
 
+// min f(x) + t * h(x) with h_prox the prox of t * h. When h_prox has a
+// conjugate and func_f a dual (see Proximal::has_conjugate and
+// FuncGrad::has_dual), records.gap certifies the result and
+// options.gap_tol() > 0 replaces the ftol test by a test on the gap.
 class ProximalGradSolver : public SolverBase {
 public:
     ProximalGradSolver(std::string name, SolverOptions options)
         : SolverBase(std::move(name)), options_(options) {}
     void operator()(Ref<const Mat> x0, FuncGrad<Scalar> &func_f, Func<Scalar> &func_h,
                     Proximal<Scalar> &h_prox, Scalar t, Ref<Mat> result, SolverRecords &records);
+    // least squares with an l1 or l1,2 prox (see PenaltyGroups): with
+    // options.screening() > 0, every options.screening() iterations the rows
+    // of x that are zero at every solution are found by GapSafeScreening, set
+    // to zero and dropped from func_f, so that an iteration only multiplies
+    // the remaining columns of A
+    void operator()(Ref<const Mat> x0, AxmbNormSqr<Scalar> &func_f, Func<Scalar> &func_h,
+                    Proximal<Scalar> &h_prox, Scalar t, Ref<Mat> result, SolverRecords &records);
+
+    // memory for the temporaries of a run, kept between runs
+    const Utils::Arena &arena() const { return arena_; }
+
+protected:
+    // called with x and the gradient at x, returns true if it changed x
+    using screen_t = std::function<bool(Ref<Mat>, const Ref<const Mat>)>;
+
+    void solve(Ref<const Mat> x0, FuncGrad<Scalar> &func_f, Func<Scalar> &func_h,
+               Proximal<Scalar> &h_prox, Scalar t, Ref<Mat> result, SolverRecords &records,
+               const screen_t &screen);
+
+    SolverOptions options_;
+    Utils::Arena  arena_;
+};
+
+struct StochasticOptions {
+    Index         batch_size   = 1;
+    Index         epoch_length = 0;   ///< iterations per epoch, 0 for num_samples / batch_size
+    unsigned long seed         = 0;
+};
+
+// Proximal stochastic variance-reduced methods for f = sum_i f_i, see
+// FiniteSumFuncGrad. The step size is options.fixed(), maxit counts epochs
+// and the stopping test on the objective is made once per epoch.
+class StochasticSolverBase : public SolverBase {
+public:
+    StochasticSolverBase(std::string name, SolverOptions options, StochasticOptions stoch)
+        : SolverBase(std::move(name)), options_(options), stoch_(stoch) {}
+
+    const Utils::Arena &arena() const { return arena_; }
+
+protected:
+    Index epoch_length(Index n_samples) const;
+
+    SolverOptions     options_;
+    StochasticOptions stoch_;
+    Utils::Arena      arena_;
+};
+
+// prox-SVRG: a full gradient at a snapshot, taken at the start of every
+// epoch, corrects the mini-batch gradients
+class ProxSVRGSolver : public StochasticSolverBase {
+public:
+    ProxSVRGSolver(std::string name, SolverOptions options,
+                   StochasticOptions stoch = StochasticOptions())
+        : StochasticSolverBase(std::move(name), options, stoch) {}
+    void operator()(Ref<const Mat> x0, FiniteSumFuncGrad<Scalar> &func_f, Func<Scalar> &func_h,
+                    Proximal<Scalar> &h_prox, Scalar t, Ref<Mat> result, SolverRecords &records);
+};
+
+// prox-SAGA: keeps the last gradient of every sample, one row per sample
+// for linear models (FiniteSumFuncGrad::is_linear_model) and the full
+// gradient otherwise
+class ProxSAGASolver : public StochasticSolverBase {
+public:
+    ProxSAGASolver(std::string name, SolverOptions options,
+                   StochasticOptions stoch = StochasticOptions())
+        : StochasticSolverBase(std::move(name), options, stoch) {}
+    void operator()(Ref<const Mat> x0, FiniteSumFuncGrad<Scalar> &func_f, Func<Scalar> &func_h,
+                    Proximal<Scalar> &h_prox, Scalar t, Ref<Mat> result, SolverRecords &records);
+};
+
+enum class CDUpdate
+{
+    Auto,         ///< Covariance when A has more rows than columns, Residual otherwise
+    Residual,     ///< keep r = Ax - b, O(rows) per update
+    Covariance,   ///< keep A'(Ax - b) and the Gram columns of the nonzeros, O(cols) per update
+};
+
+struct CoordinateDescentOptions {
+    CDUpdate      update     = CDUpdate::Auto;
+    bool          active_set = true;    ///< sweep the nonzeros until they settle, then all coordinates
+    bool          shuffle    = false;   ///< random order in every sweep instead of a cyclic one
+    unsigned long seed       = 0;
+    /// threads of the asynchronous mode, 1 for the serial solver and 0 for
+    /// the size of the global thread pool. Sparse A only, and the serial
+    /// solver runs when the pool has a single thread.
+    int           num_threads = 1;
+};
+
+// min 0.5 * ||Ax - b||_2^2 + h(x) for a separable h, e.g. L1Norm with
+// ShrinkageL1, ElasticNet with ShrinkageElasticNet or Zero with BoxProj.
+// Every coordinate is minimized exactly by x_j = prox_{h / L_j}(x_j - g_j / L_j)
+// with L_j = ||A_j||^2 and g_j = A_j'(Ax - b), see Proximal::prox_entry.
+// maxit counts the sweeps. The solver stops when a sweep over all
+// coordinates changes the objective by less than about xtol * ||b||^2, i.e.
+// max_j L_j dx_j^2 < xtol * ||b||^2.
+// For the lasso (h_prox.penalty_groups() is Entries) and options.screening()
+// > 0 every full sweep is followed by a GapSafeScreening test, and the
+// coordinates that are zero at every solution are no longer swept.
+//
+// With num_threads != 1 and a sparse A the sweeps are asynchronous
+// (Hogwild): the threads update disjoint slices of the coordinates (of the
+// nonzeros in the active sweeps, shuffled as in the serial solver) without
+// locks, x_j by compare-and-swap and the residual by
+// atomic adds, so that x and Ax - b stay consistent while the gradients are
+// computed from stale values. Convergence is confirmed by one serial sweep.
+// h_prox.prox_entry must be safe to call concurrently, as it is for the
+// operators of functional.h.
+class CoordinateDescentSolver : public SolverBase {
+public:
+    CoordinateDescentSolver(std::string name, SolverOptions options,
+                            CoordinateDescentOptions cd = CoordinateDescentOptions())
+        : SolverBase(std::move(name)), options_(options), cd_(cd) {}
+
+    void operator()(Ref<const Mat> x0, const AxmbNormSqr<Scalar> &func_f, Func<Scalar> &func_h,
+                    Proximal<Scalar> &h_prox, Ref<Mat> result, SolverRecords &records);
+    void operator()(Ref<const Mat> x0, const Mat &A, Ref<const Mat> b, Func<Scalar> &func_h,
+                    Proximal<Scalar> &h_prox, Ref<Mat> result, SolverRecords &records);
+    void operator()(Ref<const Mat> x0, const SpMat &A, Ref<const Mat> b, Func<Scalar> &func_h,
+                    Proximal<Scalar> &h_prox, Ref<Mat> result, SolverRecords &records);
+
+protected:
+    // products of A and b, shared by the solves of a path
+    struct Cache {
+        Vec              L;      ///< ||A_j||^2
+        Vec              c;      ///< A'b, covariance updates only
+        std::vector<Vec> gram;   ///< columns of A'A, empty until used
+        std::vector<Index> working;   ///< coordinates to sweep, all if empty
+    };
+
+    template <typename MatType>
+    void solve(Ref<const Mat> x0, const MatType &A, Ref<const Mat> b, Func<Scalar> &func_h,
+               Proximal<Scalar> &h_prox, Ref<Mat> result, SolverRecords &records, Cache &cache);
+    void solve_async(Ref<const Mat> x0, const SpMat &A, Ref<const Mat> b, Func<Scalar> &func_h,
+                     Proximal<Scalar> &h_prox, Ref<Mat> result, SolverRecords &records);
+
+    SolverOptions            options_;
+    CoordinateDescentOptions cd_;
+};
+
+struct PathOptions {
+    Index  num_lambdas      = 100;
+    Scalar lambda_min_ratio = 1e-3;   ///< lambda_min / lambda_max
+    Scalar l1_ratio         = 1;      ///< alpha below, 1 for the lasso
+};
+
+struct RegularizationPath {
+    Vec   lambdas;   ///< decreasing
+    SpMat coefs;     ///< column k is the solution at lambdas[k]
+};
+
+// min 0.5 * ||Ax - b||_2^2 + lambda * (alpha ||x||_1 + 0.5 * (1 - alpha) ||x||_2^2)
+// over a log-spaced grid from lambda_max = ||A'b||_inf / alpha, the smallest
+// lambda with a zero solution, down to lambda_min_ratio * lambda_max.
+// Every point is solved by the serial coordinate descent warm-started at the
+// previous solution, and the column norms, A'b and the Gram columns are
+// computed once for the whole path. Only the coordinates kept by the
+// sequential strong rule are swept, and the KKT conditions of the others
+// are checked at the solution. records.obj_hist holds the objective at
+// every lambda and n_iters the sweeps of all points.
+class RegularizationPathSolver : public CoordinateDescentSolver {
+public:
+    RegularizationPathSolver(std::string name, SolverOptions options,
+                             PathOptions              path = PathOptions(),
+                             CoordinateDescentOptions cd   = CoordinateDescentOptions())
+        : CoordinateDescentSolver(std::move(name), options, cd), path_(path) {}
+
+    void operator()(const Mat &A, Ref<const Mat> b, RegularizationPath &path,
+                    SolverRecords &records);
+    void operator()(const SpMat &A, Ref<const Mat> b, RegularizationPath &path,
+                    SolverRecords &records);
+
+protected:
+    template <typename MatType>
+    void solve_path(const MatType &A, Ref<const Mat> b, RegularizationPath &path,
+                    SolverRecords &records);
+
+    PathOptions path_;
+};
+
+struct NewtonOptions {
+    Index  cg_maxit = 200;    ///< conjugate gradient iterations per Newton step
+    Scalar cg_tol   = 0.1;    ///< relative residual of the inner solves, at most sqrt(||F|| / gamma)
+    Scalar reg      = 1;      ///< initial shift of the Newton system, relative to ||F||
+    Scalar sigma    = 1e-4;   ///< Armijo constant of the line search, in (0, 1)
+};
+
+// min f(x) + t * h(x) with h_prox the prox of t * h, to high accuracy.
+// x = prox(x - gamma grad f(x)) is solved by a semismooth Newton method on
+// F(x) = x - prox(x - gamma grad f(x)): with H the Hessian of f and D the
+// generalized Jacobian of the prox (FuncGrad::hessian, Proximal::jacobian),
+// the step d solves the symmetric system
+//   (I - gamma H)(I - D (I - gamma H)) d = -(I - gamma H) F
+// by conjugate gradients on a MatOp, shifted by reg * ||F|| with reg
+// adapted to the steps taken. The left-hand side is the generalized Hessian
+// of the forward-backward envelope, which has the minimizers of the problem
+// as its minimizers. An Armijo line search on the envelope along d falls back
+// to the proximal gradient point, which always decreases it, so that the
+// method is globally convergent and superlinear near a nondegenerate
+// solution. gamma < 1 / L is found by backtracking from the curvature of f
+// at x0. Small penalties are best reached by continuation, as for
+// ProximalGradSolver.
+// The solver stops when ||F|| / gamma <= gtol, or on the duality gap when
+// options.gap_tol() > 0 and the pair is certified, see ProximalGradSolver.
+// The result is the last prox point.
+class SemismoothNewtonSolver : public SolverBase {
+public:
+    SemismoothNewtonSolver(std::string name, SolverOptions options,
+                           NewtonOptions newton = NewtonOptions())
+        : SolverBase(std::move(name)), options_(options), newton_(newton) {}
+
+    void operator()(Ref<const Mat> x0, FuncGrad<Scalar> &func_f, Func<Scalar> &func_h,
+                    Proximal<Scalar> &h_prox, Scalar t, Ref<Mat> result, SolverRecords &records);
+
+    const Utils::Arena &arena() const { return arena_; }
+
+protected:
+    SolverOptions options_;
+    NewtonOptions newton_;
+    Utils::Arena  arena_;
+};
+
+struct ADMMOptions {
+    Scalar rho          = 1;      ///< initial penalty
+    bool   adaptive     = true;   ///< balance the residuals by changing rho
+    Scalar balance      = 10;     ///< rho changes when a residual exceeds balance times the other
+    Scalar factor       = 2;      ///< by this factor
+    Index  newton_steps = 1;      ///< Newton-CG steps of the x-update when f has no prox
+    Index  cg_maxit     = 50;     ///< conjugate gradient iterations per Newton step
+};
+
+// min f(x) + t * h(z) s.t. x = z by the scaled ADMM
+//   x = argmin f(x) + rho / 2 ||x - z + u||^2,
+//   z = prox of t * h / rho at x + u,
+//   u = u + x - z,
+// with h_prox the prox of t * h as for ProximalGradSolver. h may be any
+// function with a prox, e.g. a nonseparable regularizer or the indicator of a
+// constraint set given by its projection. The x-update is func_f.prox when
+// func_f has one, AxmbNormSqr keeps its factorization as long as rho does not
+// change, and newton_steps Newton-CG steps from the previous x otherwise.
+// With adaptive rho the primal and dual residuals r = ||x - z|| and
+// s = rho ||z - z_prev|| are balanced, and u is rescaled with rho.
+// The solver stops when r <= xtol * max(1, ||x||, ||z||) and
+// s <= xtol * max(1, rho ||u||), or on the duality gap at z when
+// options.gap_tol() > 0 and the pair is certified, see ProximalGradSolver.
+// The result is z.
+class ADMMSolver : public SolverBase {
+public:
+    ADMMSolver(std::string name, SolverOptions options, ADMMOptions admm = ADMMOptions())
+        : SolverBase(std::move(name)), options_(options), admm_(admm) {}
+
+    void operator()(Ref<const Mat> x0, FuncGrad<Scalar> &func_f, Func<Scalar> &func_h,
+                    Proximal<Scalar> &h_prox, Scalar t, Ref<Mat> result, SolverRecords &records);
+
+    const Utils::Arena &arena() const { return arena_; }
 
 protected:
     SolverOptions options_;
+    ADMMOptions   admm_;
+    Utils::Arena  arena_;
 };
 }   // namespace Base
 }   // namespace OptSuite
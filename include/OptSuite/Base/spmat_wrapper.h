@@ -19,6 +19,7 @@
 #ifndef OPTSUITE_BASE_SPMAT_WRAPPER_H
 #define OPTSUITE_BASE_SPMAT_WRAPPER_H
 
+#include <algorithm>
 #include "OptSuite/core_n.h"
 #include "OptSuite/Base/variable.h"
 #include "OptSuite/Base/mat_wrapper.h"
@@ -32,15 +33,17 @@ namespace OptSuite { namespace Base {
         spmat_t data_;
         
         public:
-            SpMatWrapper() = default;
-            SpMatWrapper(const Ref<const spmat_t> A) : data_(A) {}
+            SpMatWrapper() : Variable<dtype>(VariableKind::Sparse) {}
+            SpMatWrapper(const Ref<const spmat_t> A) : Variable<dtype>(VariableKind::Sparse), data_(A) {}
             ~SpMatWrapper() = default;
 
+            static constexpr VariableKind static_kind() { return VariableKind::Sparse; }
+
             inline spmat_t& spmat() { return data_; }
             inline const spmat_t& spmat() const { return data_; }
 
             Variable<dtype>& operator=(const Variable<dtype>& other){
-                const SpMatWrapper<dtype>* other_ptr = dynamic_cast<const SpMatWrapper<dtype>*>(&other);
+                const SpMatWrapper<dtype>* other_ptr = variable_cast<SpMatWrapper<dtype>>(&other);
                 OPTSUITE_ASSERT(other_ptr);
                 data_ = other_ptr->data_;
                 return *this;
@@ -55,14 +58,18 @@ namespace OptSuite { namespace Base {
             }
 
             inline dtype dot(const Variable<dtype>& other) const {
-                const MatWrapper<dtype>* other_ptr = dynamic_cast<const MatWrapper<dtype>*>(&other);
-                const SpMatWrapper* other_ptr_s = dynamic_cast<const SpMatWrapper*>(&other);
-                OPTSUITE_ASSERT(other_ptr || other_ptr_s);
-                if (other_ptr)
-                    return this->dot(*other_ptr);
-                else
-                    return this->dot(*other_ptr_s);
-
+                switch (other.kind()){
+                    case VariableKind::Dense:
+                        return this->dot(static_cast<const MatWrapper<dtype>&>(other));
+                    case VariableKind::Sparse:
+                        return this->dot(static_cast<const SpMatWrapper&>(other));
+                    case VariableKind::SharedSparse:
+                        // conj(<S, x>), SharedSpMat implements the mixed products
+                        return Eigen::numext::conj(other.dot(*this));
+                    default:
+                        OPTSUITE_ASSERT(false);
+                        return dtype(0);
+                }
             }
 
             inline void set_zero_like(const Ref<const spmat_t>& other){
@@ -71,7 +78,7 @@ namespace OptSuite { namespace Base {
             }
 
             inline void set_zero_like(const Variable<dtype>& other){
-                const SpMatWrapper* other_ptr = dynamic_cast<const SpMatWrapper*>(&other);
+                const SpMatWrapper* other_ptr = variable_cast<SpMatWrapper>(&other);
                 OPTSUITE_ASSERT(other_ptr);
                 data_ = other_ptr->data_;
                 data_.setZero();
@@ -79,9 +86,12 @@ namespace OptSuite { namespace Base {
 
             inline void set_zero_like(Index rows, Index cols, Index nnz,
                     const SparseIndex* outer, const SparseIndex* inner){
-                Scalar *buff = new Scalar[nnz];
-                data_ = Map<const spmat_t>(rows, cols, nnz, outer, inner, buff);
-                delete []buff;
+                // fill the compressed arrays in place, no temporary values
+                data_.resize(rows, cols);
+                data_.resizeNonZeros(nnz);
+                std::copy(outer, outer + cols + 1, data_.outerIndexPtr());
+                std::copy(inner, inner + nnz, data_.innerIndexPtr());
+                std::fill(data_.valuePtr(), data_.valuePtr() + nnz, dtype(0));
             }
 
     };
@@ -0,0 +1,271 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  var_expr.h
+ *
+ *    Description:  lazy linear combinations of variables
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 10:05:14 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_BASE_VAR_EXPR_H
+#define OPTSUITE_BASE_VAR_EXPR_H
+
+#include <type_traits>
+#include "OptSuite/core_n.h"
+#include "OptSuite/Base/variable.h"
+#include "OptSuite/Base/mat_wrapper.h"
+#include "OptSuite/Base/mat_array.h"
+#include "OptSuite/Base/factorized_mat.h"
+#include "OptSuite/Base/shared_spmat.h"
+
+// usage:
+//     MatWrapper<Scalar> x, g, x_new;
+//     x_new = x - t * g;               // one pass, no temporary
+//     x_new = 2 * x - y + t * g;       // up to OPTSUITE_EXPR_MAX_TERMS terms
+//
+// The arithmetic operators on MatWrapper, MatArray_t, FactorizedMat and
+// SharedSpMat only
+// record the operands and the coefficients. The work is done when the
+// expression is assigned to a variable of the same type:
+//   - MatWrapper: one loop over the entries;
+//   - MatArray_t: one loop over the whole buffer, so that the blocks may have
+//     different shapes and be padded (see mat_array.h). All operands must share the same layout;
+//     the destination is reshaped to it if needed;
+//   - FactorizedMat: sum_k c_k U_k V_k' = [c_1 U_1, ...] [V_1, ...]', the
+//     factors are concatenated and the rank of the result is the sum of the
+//     ranks of the operands;
+//   - SharedSpMat: one loop over the values. All operands must have the same
+//     pattern; the destination shares it.
+// The destination may be one of the operands. The operands are held by
+// reference, so an expression must not outlive them (do not store it with
+// auto).
+
+#ifndef OPTSUITE_EXPR_MAX_TERMS
+#define OPTSUITE_EXPR_MAX_TERMS 4
+#endif
+
+namespace OptSuite { namespace Base {
+    // types that may appear in an expression
+    template<typename V>
+    struct expr_operand_traits {
+        static constexpr bool value = false;
+    };
+
+    template<typename T>
+    struct expr_operand_traits<MatWrapper<T>> {
+        static constexpr bool value = true;
+        using dtype = T;
+    };
+
+    template<typename T>
+    struct expr_operand_traits<MatArray_t<T>> {
+        static constexpr bool value = true;
+        using dtype = T;
+    };
+
+    template<typename T>
+    struct expr_operand_traits<FactorizedMat<T>> {
+        static constexpr bool value = true;
+        using dtype = T;
+    };
+
+    template<typename T>
+    struct expr_operand_traits<SharedSpMat<T>> {
+        static constexpr bool value = true;
+        using dtype = T;
+    };
+
+    // sum_{k < N} coeff[k] * var[k]
+    template<typename V, int N>
+    class LinCombExpr {
+        static_assert(N >= 1 && N <= OPTSUITE_EXPR_MAX_TERMS,
+                "too many terms in a variable expression");
+        public:
+            using var_t = V;
+            using dtype = typename expr_operand_traits<V>::dtype;
+            static constexpr int size = N;
+
+            dtype coeff[N];
+            const V* var[N];
+
+            // evaluate into dst
+            inline void eval_to(V& dst) const;
+    };
+
+    // maps an operand (a variable or an expression) to its expression type
+    template<typename A, typename = void>
+    struct expr_of {};
+
+    template<typename V>
+    struct expr_of<V, typename std::enable_if<expr_operand_traits<V>::value>::type> {
+        using type = LinCombExpr<V, 1>;
+        using dtype = typename expr_operand_traits<V>::dtype;
+        static inline type get(const V& v){
+            type e;
+            e.coeff[0] = dtype(1);
+            e.var[0] = &v;
+            return e;
+        }
+    };
+
+    template<typename V, int N>
+    struct expr_of<LinCombExpr<V, N>> {
+        using type = LinCombExpr<V, N>;
+        using dtype = typename type::dtype;
+        static inline const type& get(const type& e){ return e; }
+    };
+
+    // type of a + b, defined only when both sides combine the same type
+    template<typename A, typename B, typename = void>
+    struct expr_sum {};
+
+    template<typename V, int N, int M>
+    struct expr_sum<LinCombExpr<V, N>, LinCombExpr<V, M>,
+        typename std::enable_if<(N + M <= OPTSUITE_EXPR_MAX_TERMS)>::type> {
+        using type = LinCombExpr<V, N + M>;
+    };
+
+    template<typename V, int N, int M>
+    inline LinCombExpr<V, N + M> concat_expr(const LinCombExpr<V, N>& a,
+            const LinCombExpr<V, M>& b, typename LinCombExpr<V, N>::dtype sb){
+        LinCombExpr<V, N + M> e;
+        for (int k = 0; k < N; ++k){
+            e.coeff[k] = a.coeff[k];
+            e.var[k] = a.var[k];
+        }
+        for (int k = 0; k < M; ++k){
+            e.coeff[N + k] = sb * b.coeff[k];
+            e.var[N + k] = b.var[k];
+        }
+        return e;
+    }
+
+    template<typename A, typename B>
+    inline typename expr_sum<typename expr_of<A>::type, typename expr_of<B>::type>::type
+    operator+(const A& a, const B& b){
+        using dtype = typename expr_of<A>::dtype;
+        return concat_expr(expr_of<A>::get(a), expr_of<B>::get(b), dtype(1));
+    }
+
+    template<typename A, typename B>
+    inline typename expr_sum<typename expr_of<A>::type, typename expr_of<B>::type>::type
+    operator-(const A& a, const B& b){
+        using dtype = typename expr_of<A>::dtype;
+        return concat_expr(expr_of<A>::get(a), expr_of<B>::get(b), dtype(-1));
+    }
+
+    template<typename A>
+    inline typename expr_of<A>::type operator*(typename expr_of<A>::dtype s, const A& a){
+        typename expr_of<A>::type e = expr_of<A>::get(a);
+        for (int k = 0; k < expr_of<A>::type::size; ++k)
+            e.coeff[k] *= s;
+        return e;
+    }
+
+    template<typename A>
+    inline typename expr_of<A>::type operator*(const A& a, typename expr_of<A>::dtype s){
+        return s * a;
+    }
+
+    template<typename A>
+    inline typename expr_of<A>::type operator/(const A& a, typename expr_of<A>::dtype s){
+        return (typename expr_of<A>::dtype(1) / s) * a;
+    }
+
+    template<typename A>
+    inline typename expr_of<A>::type operator-(const A& a){
+        return typename expr_of<A>::dtype(-1) * a;
+    }
+
+    namespace internal {
+        // dst[i] = sum_k c[k] * src[k][i], the loop over k is unrolled
+        template<typename T, int N>
+        inline void lincomb_kernel(T* dst, const T* const* src, const T* c, Index n){
+            for (Index i = 0; i < n; ++i){
+                T s = c[0] * src[0][i];
+                for (int k = 1; k < N; ++k)
+                    s += c[k] * src[k][i];
+                dst[i] = s;
+            }
+        }
+
+        template<typename T, int N>
+        inline void lincomb_assign(MatWrapper<T>& dst, const LinCombExpr<MatWrapper<T>, N>& e){
+            const auto& x0 = e.var[0]->mat();
+            const T* src[N];
+            for (int k = 0; k < N; ++k){
+                OPTSUITE_ASSERT(e.var[k]->mat().rows() == x0.rows() &&
+                        e.var[k]->mat().cols() == x0.cols());
+                src[k] = e.var[k]->mat().data();
+            }
+            // no-op when dst is one of the operands
+            dst.mat().resize(x0.rows(), x0.cols());
+            lincomb_kernel<T, N>(dst.mat().data(), src, e.coeff, x0.size());
+        }
+
+        template<typename T, int N>
+        inline void lincomb_assign(MatArray_t<T>& dst, const LinCombExpr<MatArray_t<T>, N>& e){
+            const MatArray_t<T>& x0 = *e.var[0];
+            const T* src[N];
+            for (int k = 0; k < N; ++k){
+                OPTSUITE_ASSERT(e.var[k]->same_layout(x0));
+                src[k] = e.var[k]->data();
+            }
+            // dst is not an operand when its layout differs
+            if (!dst.same_layout(x0))
+                dst.set_zero_like(x0);
+            // the padding between the blocks stays zero
+            lincomb_kernel<T, N>(dst.data(), src, e.coeff, x0.storage_size());
+        }
+
+        template<typename T, int N>
+        inline void lincomb_assign(FactorizedMat<T>& dst, const LinCombExpr<FactorizedMat<T>, N>& e){
+            using mat_t = Eigen::Matrix<T, Dynamic, Dynamic>;
+            Index m = e.var[0]->rows(), n = e.var[0]->cols(), r = 0;
+            for (int k = 0; k < N; ++k){
+                OPTSUITE_ASSERT(e.var[k]->rows() == m && e.var[k]->cols() == n);
+                r += e.var[k]->rank();
+            }
+            // dst may be an operand, build the factors aside
+            mat_t U(m, r), V(n, r);
+            Index j = 0;
+            for (int k = 0; k < N; ++k){
+                Index rk = e.var[k]->rank();
+                U.middleCols(j, rk) = e.coeff[k] * e.var[k]->U();
+                V.middleCols(j, rk) = e.var[k]->V();
+                j += rk;
+            }
+            dst.set_UV(U, V);
+        }
+
+        template<typename T, int N>
+        inline void lincomb_assign(SharedSpMat<T>& dst, const LinCombExpr<SharedSpMat<T>, N>& e){
+            const SharedSpMat<T>& x0 = *e.var[0];
+            const T* src[N];
+            for (int k = 0; k < N; ++k){
+                OPTSUITE_ASSERT(e.var[k]->same_pattern(x0));
+                src[k] = e.var[k]->valuePtr();
+            }
+            // dst is not an operand when its pattern differs
+            if (!dst.same_pattern(x0))
+                dst.set_pattern(x0.rows(), x0.outer_index(), x0.inner_index());
+            lincomb_kernel<T, N>(dst.valuePtr(), src, e.coeff, x0.nonZeros());
+        }
+    }
+
+    template<typename V, int N>
+    inline void LinCombExpr<V, N>::eval_to(V& dst) const {
+        internal::lincomb_assign(dst, *this);
+    }
+}}
+
+#endif
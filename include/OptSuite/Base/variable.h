@@ -21,12 +21,27 @@
 #include "OptSuite/core_n.h"
 
 namespace OptSuite { namespace Base {
+    // concrete type of a Variable. Each derived class passes its kind to the
+    // constructor of Variable and reports it from static_kind(), so that the
+    // mixed-type operations can dispatch with a switch (or variable_cast)
+    // instead of a chain of dynamic_casts.
+    enum class VariableKind {
+        Generic,
+        Dense,
+        Sparse,
+        SharedSparse,
+        Factorized,
+        Array
+    };
+
     template<typename T>
     class Variable {
         public:
             Variable() = default;
             ~Variable() = default;
 
+            inline VariableKind kind() const { return kind_; }
+
             // operations
             virtual Variable<T>& operator=(const Variable<T>&) { return *this; } ;
             virtual T dot(const Variable<T>&) const = 0;
@@ -38,7 +53,28 @@ namespace OptSuite { namespace Base {
             inline
             virtual bool has_squared_norm_diff() const { return false; }
 
+        protected:
+            explicit Variable(VariableKind kind) : kind_(kind) {}
+
+        private:
+            VariableKind kind_ = VariableKind::Generic;
     };
+
+    // checked downcast: returns nullptr unless the kind tag of v equals
+    // To::static_kind(). A derived class passes only if it keeps the tag of
+    // To. Costs one comparison, unlike dynamic_cast.
+    template<typename To, typename T>
+    inline const To* variable_cast(const Variable<T>* v){
+        return v->kind() == To::static_kind() ? static_cast<const To*>(v) : nullptr;
+    }
+
+    template<typename To, typename T>
+    inline To* variable_cast(Variable<T>* v){
+        return v->kind() == To::static_kind() ? static_cast<To*>(v) : nullptr;
+    }
+
+    // lazy linear combination of N variables of type V, see var_expr.h
+    template<typename V, int N> class LinCombExpr;
 }}
 
 #endif
@@ -0,0 +1,70 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  problem_gen.h
+ *
+ *    Description:  random test problems with known ground truth
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 05:41:26 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_LINALG_PROBLEM_GEN_H
+#define OPTSUITE_LINALG_PROBLEM_GEN_H
+
+#include "OptSuite/core_n.h"
+
+// All generators reseed the global generator (see rng()) with `seed`, so a
+// problem is fully determined by its parameters.
+//
+// `cond` controls the conditioning of the data matrix: the columns (features)
+// are scaled geometrically from 1 down to 1/cond. cond = 1 gives a standard
+// gaussian matrix.
+
+namespace OptSuite { namespace LinAlg {
+    // least squares data: 0.5 * |Ax - b|_F^2
+    struct RegressionProblem {
+        Mat A;       // m x n
+        Mat b;       // m x l
+        Mat x_true;  // n x l
+    };
+
+    // matrix completion data: 0.5 * |P_omega(x) - b|_2^2
+    struct CompletionProblem {
+        SpMat omega; // sampling pattern, m x n
+        Mat b;       // observed values in the order of omega, nnz x 1
+        Mat x_true;  // m x n, rank r
+    };
+
+    // logistic regression data, in the layout of Base::LogisticRegression
+    struct ClassificationProblem {
+        Mat A;       // n x m, one sample per column
+        Mat b;       // m x 1, labels in {-1, 1}
+        Mat x_true;  // n x 1
+    };
+
+    // x_true has round(n * sparsity) nonzero entries, b = A x_true + noise
+    RegressionProblem gen_lasso(Index m, Index n, Scalar sparsity, Scalar cond = 1,
+            Scalar noise = 0, unsigned long seed = 0);
+
+    // x_true (n x l) has round(n * sparsity) nonzero rows
+    RegressionProblem gen_group_lasso(Index m, Index n, Index l, Scalar sparsity,
+            Scalar cond = 1, Scalar noise = 0, unsigned long seed = 0);
+
+    // x_true = U V^T of rank r, a fraction `sample_ratio` of the entries is observed
+    CompletionProblem gen_low_rank_completion(Index m, Index n, Index r,
+            Scalar sample_ratio, Scalar noise = 0, unsigned long seed = 0);
+
+    // m samples with n features, the labels are sign(A^T x_true + noise)
+    ClassificationProblem gen_logistic(Index m, Index n, Scalar sparsity,
+            Scalar cond = 1, Scalar noise = 0, unsigned long seed = 0);
+}}
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  aligned_allocator.h
+ *
+ *    Description:  std allocator with a fixed over-alignment
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 10:48:26 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_UTILS_ALIGNED_ALLOCATOR_H
+#define OPTSUITE_UTILS_ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// usage:
+// std::vector<double, AlignedAllocator<double, 64>> v(n);  // v.data() % 64 == 0
+//
+// Eigen::aligned_allocator only guarantees EIGEN_MAX_ALIGN_BYTES, which is 16
+// on builds without AVX. This allocator aligns to Align bytes (a power of
+// two) on any build, e.g. to a cache line.
+
+namespace OptSuite { namespace Utils {
+    template<typename T, std::size_t Align>
+    class AlignedAllocator {
+        static_assert((Align & (Align - 1)) == 0 && Align >= sizeof(void*),
+                "Align must be a power of two not smaller than a pointer");
+        public:
+            using value_type = T;
+            template<typename U>
+            struct rebind { using other = AlignedAllocator<U, Align>; };
+
+            AlignedAllocator() = default;
+            template<typename U>
+            AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+            T* allocate(std::size_t n) {
+                // over-allocate and keep the address returned by operator new
+                // right before the aligned block
+                void* raw = ::operator new(n * sizeof(T) + Align);
+                std::uintptr_t p = (reinterpret_cast<std::uintptr_t>(raw) + Align) & ~(Align - 1);
+                reinterpret_cast<void**>(p)[-1] = raw;
+                return reinterpret_cast<T*>(p);
+            }
+
+            void deallocate(T* p, std::size_t) {
+                if (p != nullptr)
+                    ::operator delete(reinterpret_cast<void**>(p)[-1]);
+            }
+
+            template<typename U>
+            bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+            template<typename U>
+            bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+    };
+}}
+
+#endif
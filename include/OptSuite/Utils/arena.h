@@ -0,0 +1,134 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  arena.h
+ *
+ *    Description:  bump allocator for the temporaries of a solver
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 03:12:40 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_UTILS_ARENA_H
+#define OPTSUITE_UTILS_ARENA_H
+
+#include <type_traits>
+#include <vector>
+#include "OptSuite/core_n.h"
+#include "OptSuite/Utils/aligned_allocator.h"
+
+// usage:
+// Arena& arena = Arena::current();
+// Arena::Scope scope(arena);                 // released at the end of the block
+// auto t = arena.mat<Scalar>(m, n);          // Map on arena memory, uninitialized
+// t.noalias() = A * x;
+//
+// An arena hands out memory by bumping an offset in large blocks, and a Scope
+// gives back everything allocated since it was opened. Scopes must be nested,
+// so the memory of a function is released when it returns and reused by the
+// next call. Once every scope is closed the blocks are merged into one, so an
+// iterative method reaches a fixed footprint after its first iteration
+// (high_water()).
+//
+// Every thread has a current arena: the one bound to it by Arena::Bind (a
+// solver binds its own for the duration of a run), or a thread-local default.
+// An arena must only be used by one thread at a time.
+
+#ifndef OPTSUITE_ARENA_ALIGN
+#define OPTSUITE_ARENA_ALIGN 64
+#endif
+
+#ifndef OPTSUITE_ARENA_MIN_BLOCK
+#define OPTSUITE_ARENA_MIN_BLOCK 65536
+#endif
+
+namespace OptSuite { namespace Utils {
+    class Arena {
+        using block_t = std::vector<char, AlignedAllocator<char, OPTSUITE_ARENA_ALIGN>>;
+        public:
+            // position of the arena, see rewind
+            struct Checkpoint {
+                Size block;
+                Size offset;
+                Size used;
+            };
+
+            // rewinds the arena to its state at construction
+            class Scope {
+                public:
+                    explicit Scope(Arena& a) : arena_(a), cp_(a.checkpoint()) {}
+                    ~Scope() { arena_.rewind(cp_); }
+                    Scope(const Scope&) = delete;
+                    Scope& operator=(const Scope&) = delete;
+                private:
+                    Arena& arena_;
+                    Checkpoint cp_;
+            };
+
+            // makes an arena the current one of the calling thread
+            class Bind {
+                public:
+                    explicit Bind(Arena&);
+                    ~Bind();
+                    Bind(const Bind&) = delete;
+                    Bind& operator=(const Bind&) = delete;
+                private:
+                    Arena* prev_;
+            };
+
+            // capacity of the first block, 0 allocates it on first use
+            explicit Arena(Size bytes = 0);
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            static Arena& current();
+
+            // bytes rounded up to OPTSUITE_ARENA_ALIGN, aligned to it
+            void* allocate(Size bytes);
+
+            template<typename T>
+            inline T* allocate(Size n){
+                static_assert(std::is_trivially_destructible<T>::value,
+                        "the arena does not run destructors");
+                return static_cast<T*>(allocate(n * static_cast<Size>(sizeof(T))));
+            }
+
+            template<typename T>
+            inline Map<Eigen::Matrix<T, Dynamic, Dynamic>, Eigen::AlignedMax> mat(Index m, Index n){
+                return Map<Eigen::Matrix<T, Dynamic, Dynamic>, Eigen::AlignedMax>(allocate<T>(m * n), m, n);
+            }
+
+            template<typename T>
+            inline Map<Eigen::Matrix<T, Dynamic, 1>, Eigen::AlignedMax> vec(Index n){
+                return Map<Eigen::Matrix<T, Dynamic, 1>, Eigen::AlignedMax>(allocate<T>(n), n);
+            }
+
+            inline Checkpoint checkpoint() const { return {block_, offset_, used_}; }
+            // releases everything allocated after cp
+            void rewind(const Checkpoint& cp);
+
+            // bytes in use
+            inline Size used() const { return used_; }
+            // largest used() so far
+            inline Size high_water() const { return high_water_; }
+            // bytes held by the blocks
+            Size capacity() const;
+            inline Size num_blocks() const { return blocks_.size(); }
+
+        private:
+            std::vector<block_t> blocks_;
+            Size block_ = 0;
+            Size offset_ = 0;
+            Size used_ = 0;
+            Size high_water_ = 0;
+    };
+}}
+
+#endif
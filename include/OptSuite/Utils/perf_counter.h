@@ -0,0 +1,84 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  perf_counter.h
+ *
+ *    Description:  hardware performance counters (Linux perf_event)
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 02:05:11 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_UTILS_PERF_COUNTER_H
+#define OPTSUITE_UTILS_PERF_COUNTER_H
+
+#include <cstdint>
+
+// usage:
+// PerfCounterGroup pc;
+// stopwatch.start();
+// pc.start();
+// ... region ...
+// pc.stop();
+// auto v = pc.values(); // v.ipc(), v.llc_misses, ...
+//
+// The counters count the calling thread only, in user space. On systems
+// where perf_event_open is not available (non-Linux, seccomp, restrictive
+// perf_event_paranoid) available() returns false and all values stay zero.
+
+namespace OptSuite { namespace Utils {
+    struct PerfCounterValues {
+        uint64_t cycles       = 0;
+        uint64_t instructions = 0;
+        uint64_t llc_misses   = 0;
+
+        inline double ipc() const {
+            return cycles == 0 ? 0. : static_cast<double>(instructions) / cycles;
+        }
+
+        PerfCounterValues& operator+=(const PerfCounterValues&);
+        PerfCounterValues& operator-=(const PerfCounterValues&);
+    };
+
+    PerfCounterValues operator-(PerfCounterValues, const PerfCounterValues&);
+
+    class PerfCounterGroup {
+        public:
+            PerfCounterGroup();
+            ~PerfCounterGroup();
+
+            PerfCounterGroup(const PerfCounterGroup&) = delete;
+            PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+            inline bool available() const { return fd_cycles_ >= 0; }
+
+            // raw counter readings since the group was opened
+            PerfCounterValues read() const;
+
+            // accumulate the counts between start() and stop() into values()
+            void start();
+            void stop();
+            inline void clear() { acc_ = PerfCounterValues(); }
+            inline const PerfCounterValues& values() const { return acc_; }
+
+        private:
+            int fd_cycles_       = -1;
+            int fd_instructions_ = -1;
+            int fd_llc_misses_   = -1;
+
+            PerfCounterValues start_;
+            PerfCounterValues acc_;
+    };
+
+    // a counter group owned by the calling thread, opened on first use
+    PerfCounterGroup& thread_perf_counters();
+}}
+
+#endif
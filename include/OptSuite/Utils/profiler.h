@@ -0,0 +1,183 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  profiler.h
+ *
+ *    Description:  hierarchical scoped profiler
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 09:12:40 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_UTILS_PROFILER_H
+#define OPTSUITE_UTILS_PROFILER_H
+
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "OptSuite/core_n.h"
+#include "OptSuite/Utils/perf_counter.h"
+
+// usage:
+// void foo() {
+//     OPTSUITE_PROFILE_SCOPE("foo");
+//     ...
+// }
+//
+// Regions opened while another region is alive become its children, so the
+// report is a call tree. Each thread records into its own tree; the trees are
+// merged when the report is generated. The profiler is compiled in only when
+// OPTSUITE_ENABLE_PROFILER is defined (cmake -DENABLE_PROFILER=ON), otherwise
+// the macros expand to nothing.
+//
+// Hardware counters (cycles, instructions, LLC misses) are read at the
+// boundaries of every region when enabled with set_counters_enabled(true) or
+// the environment variable OPTSUITE_PERF_COUNTERS=1. Kernels may declare
+// their floating-point work with OPTSUITE_PROFILE_FLOPS(n) so that the
+// report shows the achieved GFLOP/s of the enclosing region.
+
+namespace OptSuite { namespace Utils {
+    // one node of the call tree. Times are in nanoseconds.
+    struct ProfileNode {
+        const char* name;
+        ProfileNode* parent;
+        std::vector<std::unique_ptr<ProfileNode>> children;
+
+        Index  count    = 0;
+        time_t total_ns = 0;
+        time_t min_ns   = 0;
+        time_t max_ns   = 0;
+
+        // hardware counters, including the children
+        PerfCounterValues counters;
+        Index counted = 0;
+        // declared floating point operations, excluding the children
+        double flops = 0;
+
+        ProfileNode(const char* name_, ProfileNode* parent_) : name(name_), parent(parent_) {}
+
+        // find or create the child with the given name
+        ProfileNode* child(const char*);
+        // accumulate one finished call
+        void add(time_t);
+        void add(time_t, const PerfCounterValues&);
+        // merge the statistics (and the subtree) of another node into this node
+        void merge(const ProfileNode&);
+
+        time_t self_ns() const;
+        // flops of the node and its children
+        double total_flops() const;
+    };
+
+    class Profiler {
+        public:
+            using ClockType = std::chrono::high_resolution_clock;
+
+            static Profiler& instance();
+
+            // open/close a region on the calling thread
+            ProfileNode* enter(const char*);
+            void leave(ProfileNode*, time_t);
+            void leave(ProfileNode*, time_t, const PerfCounterValues&);
+
+            // add flops to the innermost open region of the calling thread
+            void add_flops(double);
+
+            // runtime switch, enabled by default
+            inline bool enabled() const { return enabled_; }
+            inline void set_enabled(bool v) { enabled_ = v; }
+
+            // hardware counters, disabled by default. Enabling has no effect
+            // when the counters are not available on this system.
+            inline bool counters_enabled() const { return counters_enabled_; }
+            void set_counters_enabled(bool);
+
+            // merged call tree of all threads
+            std::unique_ptr<ProfileNode> merged_tree() const;
+
+            // print the merged tree. Should be called when no region is open
+            // on other threads.
+            void report(std::ostream&) const;
+            void report_to_file(const std::string&) const;
+
+            // drop all recorded data
+            void reset();
+
+        private:
+            struct ThreadState {
+                ProfileNode root{"<thread>", nullptr};
+                ProfileNode* current = &root;
+            };
+
+            Profiler();
+            ThreadState& local_state();
+
+            mutable std::mutex mutex_;
+            std::vector<std::shared_ptr<ThreadState>> threads_;
+            bool enabled_ = true;
+            bool counters_enabled_ = false;
+    };
+
+    // RAII region. The elapsed time between construction and destruction is
+    // recorded under the name given to the constructor. name must outlive
+    // the profiler (a string literal is the intended use).
+    class ScopedRegion {
+        public:
+            explicit ScopedRegion(const char* name) {
+                Profiler& p = Profiler::instance();
+                node_ = p.enabled() ? p.enter(name) : nullptr;
+                if (node_ == nullptr)
+                    return;
+                use_counters_ = p.counters_enabled();
+                if (use_counters_)
+                    counters_ = thread_perf_counters().read();
+                tstart_ = Profiler::ClockType::now();
+            }
+
+            ~ScopedRegion() {
+                if (node_ == nullptr)
+                    return;
+                auto duration = Profiler::ClockType::now() - tstart_;
+                time_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+                if (use_counters_)
+                    Profiler::instance().leave(node_, ns, thread_perf_counters().read() - counters_);
+                else
+                    Profiler::instance().leave(node_, ns);
+            }
+
+            ScopedRegion(const ScopedRegion&) = delete;
+            ScopedRegion& operator=(const ScopedRegion&) = delete;
+
+        private:
+            ProfileNode* node_;
+            Profiler::ClockType::time_point tstart_;
+            bool use_counters_ = false;
+            PerfCounterValues counters_;
+    };
+}}
+
+#define OPTSUITE_PROFILE_CONCAT_IMPL(x, y) x##y
+#define OPTSUITE_PROFILE_CONCAT(x, y) OPTSUITE_PROFILE_CONCAT_IMPL(x, y)
+
+#ifdef OPTSUITE_ENABLE_PROFILER
+#define OPTSUITE_PROFILE_SCOPE(name) \
+    ::OptSuite::Utils::ScopedRegion OPTSUITE_PROFILE_CONCAT(optsuite_region_, __LINE__)(name)
+#define OPTSUITE_PROFILE_FLOPS(n) \
+    ::OptSuite::Utils::Profiler::instance().add_flops(static_cast<double>(n))
+#else
+#define OPTSUITE_PROFILE_SCOPE(name) ((void)0)
+#define OPTSUITE_PROFILE_FLOPS(n) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  thread_pool.h
+ *
+ *    Description:  work-stealing thread pool for block-wise kernels
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 11:32:08 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#ifndef OPTSUITE_UTILS_THREAD_POOL_H
+#define OPTSUITE_UTILS_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "OptSuite/core_n.h"
+
+// usage:
+// ThreadPool::global().parallel_for(n_chunks, [&](Index i){
+//     ... work on chunk i ...
+// });
+//
+// The tasks [0, n) are split into one contiguous range per thread. A thread
+// takes its tasks from the front of its own range and, once it is empty,
+// steals from the back of the range of another thread, so that uneven tasks
+// are balanced without a central queue. The calling thread takes part in
+// the work and parallel_for returns when all tasks are done.
+//
+// A parallel_for issued from inside a task, or while the pool is busy with
+// another caller, runs serially on the calling thread. Tasks must not throw.
+//
+// The size of the global pool is taken from the environment variable
+// OPTSUITE_NUM_THREADS, or the number of hardware threads when unset.
+
+namespace OptSuite { namespace Utils {
+    class ThreadPool {
+        public:
+            // num_threads counts the calling thread, 0 selects default_num_threads()
+            explicit ThreadPool(int num_threads = 0);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            static ThreadPool& global();
+            static int default_num_threads();
+
+            inline int num_threads() const { return static_cast<int>(workers_.size()) + 1; }
+            // must not be called during a parallel_for
+            void set_num_threads(int);
+
+            void parallel_for(Index, const std::function<void(Index)>&);
+
+        private:
+            // tasks [begin, end) not yet taken from one thread
+            struct TaskRange {
+                std::mutex mutex;
+                Index begin = 0;
+                Index end = 0;
+            };
+
+            void start_workers(int);
+            void stop_workers();
+            void worker_loop(int, unsigned long);
+            // run tasks of the current job as thread `id` until none is left
+            void run_tasks(int);
+            bool take(int, Index&);
+
+            std::vector<std::thread> workers_;
+            std::vector<std::unique_ptr<TaskRange>> ranges_;
+
+            // the current job
+            std::mutex run_mutex_;
+            std::mutex mutex_;
+            std::condition_variable cv_start_;
+            std::condition_variable cv_done_;
+            const std::function<void(Index)>* task_ = nullptr;
+            unsigned long generation_ = 0;
+            int active_ = 0;
+            bool stop_ = false;
+    };
+
+    // f(i) for every i in [0, n) on the global pool
+    inline void parallel_for(Index n, const std::function<void(Index)>& f){
+        ThreadPool::global().parallel_for(n, f);
+    }
+}}
+
+#endif
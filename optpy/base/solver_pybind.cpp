@@ -57,7 +57,15 @@ static void BindSolver(py::module &m) {
 
     py::class_<ProximalGradSolver, SolverBase>(m, "ProximalGradSolver")
             .def(py::init<std::string, SolverOptions>())
-            .def("__call__", &ProximalGradSolver::operator());
+            // the least squares overload first, it screens when asked to
+            .def("__call__",
+                 overload_cast_<Ref<const Mat>, AxmbNormSqr<Scalar> &, Func<Scalar> &,
+                                Proximal<Scalar> &, Scalar, Ref<Mat>, SolverRecords &>()(
+                         &ProximalGradSolver::operator()))
+            .def("__call__",
+                 overload_cast_<Ref<const Mat>, FuncGrad<Scalar> &, Func<Scalar> &,
+                                Proximal<Scalar> &, Scalar, Ref<Mat>, SolverRecords &>()(
+                         &ProximalGradSolver::operator()));
 }
 
 PYBIND11_MODULE(solver, m) {
@@ -16,13 +16,366 @@
  * ==========================================================================
  */
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
 #include "OptSuite/core_n.h"
 #include "OptSuite/Base/functional.h"
 #include "OptSuite/Base/mat_op.h"
+#include "OptSuite/Base/var_expr.h"
+#include "OptSuite/Utils/arena.h"
+#include "OptSuite/Utils/profiler.h"
+#include "OptSuite/Utils/thread_pool.h"
 #include "OptSuite/Utils/tictoc.h"
 
 namespace OptSuite { namespace Base {
+    namespace {
+        // run task(c) for the chunks c of blocks, concurrently if allowed
+        void run_chunks(Index n_chunks, bool parallel, const std::function<void(Index)>& task){
+            if (parallel){
+                Utils::parallel_for(n_chunks, task);
+                return;
+            }
+            for (Index c = 0; c < n_chunks; ++c)
+                task(c);
+        }
+
+        // entries per chunk for a functional
+        template<typename F>
+        Size grain_of(const F& f){
+            return std::max(1_i, OPTSUITE_MAT_ARRAY_GRAIN / std::max(1_i, f.work_per_entry()));
+        }
+
+        // sum of f(c) over the chunks. The partial sums are added in the order
+        // of the chunks, so the result does not depend on the number of threads.
+        Scalar chunked_sum(Index n_chunks, bool parallel, const std::function<Scalar(Index)>& f){
+            std::vector<Scalar> partial(n_chunks);
+            run_chunks(n_chunks, parallel, [&](Index c){ partial[c] = f(c); });
+            Scalar r = 0;
+            for (Scalar p : partial)
+                r += p;
+            return r;
+        }
+
+        // largest singular value
+        Scalar spectral_norm(const Ref<const Mat> g){
+            if (g.size() == 0)
+                return 0;
+            Eigen::BDCSVD<Mat> svd(g);
+            return svd.singularValues()(0);
+        }
+
+        // x log x, 0 at 0
+        inline Scalar xlogx(Scalar x){
+            return x > 0 ? x * std::log(x) : 0_s;
+        }
+
+        // the tau with sum_i max(a_i - tau, 0) = radius by the algorithm of
+        // L. Condat, Math. Program. 158 (2016), expected O(n); buf holds n entries
+        template<typename dtype>
+        dtype simplex_threshold(const dtype* a, Index n, dtype radius, dtype* buf){
+            // buf[0, nv) are the candidates above tau, buf[nw, n) the entries
+            // dropped from them that may come back
+            Index nv = 1, nw = n;
+            dtype tau = a[0] - radius;
+            buf[0] = a[0];
+            for (Index i = 1; i < n; ++i){
+                if (a[i] <= tau)
+                    continue;
+                tau += (a[i] - tau) / (nv + 1);
+                if (tau > a[i] - radius){
+                    buf[nv++] = a[i];
+                } else {
+                    std::copy_backward(buf, buf + nv, buf + nw);
+                    nw -= nv;
+                    buf[0] = a[i];
+                    nv = 1;
+                    tau = a[i] - radius;
+                }
+            }
+            for (Index k = nw; k < n; ++k){
+                if (buf[k] > tau){
+                    buf[nv++] = buf[k];
+                    tau += (buf[k] - tau) / nv;
+                }
+            }
+            // drop the candidates below tau until none is left
+            for (Index cnt = nv, prev = 0; cnt != prev; nv = cnt){
+                prev = cnt;
+                Index j = 0;
+                for (Index k = 0; k < nv; ++k){
+                    if (buf[k] > tau){
+                        buf[j++] = buf[k];
+                    } else {
+                        --cnt;
+                        tau += (tau - buf[k]) / cnt;
+                    }
+                }
+            }
+            return tau;
+        }
+
+        // the groups of an operator: the latent groups when they overlap
+        GroupIndex operator_groups(const GroupIndex& groups){
+            return groups.overlapping() ? groups.latent() : groups;
+        }
+
+        Vec group_weights(const GroupIndex& groups, Vec weights){
+            if (weights.size() == 0)
+                return Vec::Ones(groups.num_groups());
+            OPTSUITE_ASSERT(weights.size() == groups.num_groups() && (weights.array() >= 0).all());
+            return weights;
+        }
+
+        // ||x_g||_F^2
+        Scalar group_sqr_norm(const GroupIndex& groups, const Ref<const Mat> x, Index g){
+            if (groups.size(g) == 0)
+                return 0;
+            if (groups.contiguous())
+                return x.middleRows(groups.index(groups.ptr(g)), groups.size(g)).squaredNorm();
+            Scalar r = 0;
+            for (Index k = groups.ptr(g); k < groups.ptr(g + 1); ++k)
+                r += x.row(groups.index(k)).squaredNorm();
+            return r;
+        }
+
+        // <x_g, v_g>
+        Scalar group_dot(const GroupIndex& groups, const Ref<const Mat> x,
+                         const Ref<const Mat> v, Index g){
+            if (groups.size(g) == 0)
+                return 0;
+            if (groups.contiguous()){
+                Index i = groups.index(groups.ptr(g)), m = groups.size(g);
+                return x.middleRows(i, m).cwiseProduct(v.middleRows(i, m)).sum();
+            }
+            Scalar r = 0;
+            for (Index k = groups.ptr(g); k < groups.ptr(g + 1); ++k)
+                r += x.row(groups.index(k)).dot(v.row(groups.index(k)));
+            return r;
+        }
+
+        // y_g = a x_g + b v_g
+        void group_axpby(const GroupIndex& groups, Scalar a, const Ref<const Mat> x,
+                         Scalar b, const Ref<const Mat> v, Ref<Mat> y, Index g){
+            if (groups.size(g) == 0)
+                return;
+            if (groups.contiguous()){
+                Index i = groups.index(groups.ptr(g)), m = groups.size(g);
+                y.middleRows(i, m) = a * x.middleRows(i, m) + b * v.middleRows(i, m);
+                return;
+            }
+            for (Index k = groups.ptr(g); k < groups.ptr(g + 1); ++k){
+                Index i  = groups.index(k);
+                y.row(i) = a * x.row(i) + b * v.row(i);
+            }
+        }
+
+        // the prox of lambda * sum_i |x_{i+1} - x_i| at the n entries of in, by
+        // the dynamic programming of N. Johnson, J. Comput. Graph. Stat. 22
+        // (2013): exact in O(n), every scan stays inside the knots found so
+        // far. in and out may be the same.
+        void tv1d_prox(const Scalar* in, Index n, Scalar lambda, Scalar* out){
+            if (n < 2 || lambda == 0){
+                std::copy(in, in + n, out);
+                return;
+            }
+            // the derivative of the message is piecewise linear: slope a and
+            // intercept b change by a[i], b[i] at the knot x[i], i in [l, r]
+            Utils::Arena&       arena = Utils::Arena::current();
+            Utils::Arena::Scope scope(arena);
+            Scalar* x  = arena.allocate<Scalar>(2 * n);
+            Scalar* a  = arena.allocate<Scalar>(2 * n);
+            Scalar* b  = arena.allocate<Scalar>(2 * n);
+            // out[k] is clipped to [tm[k], tp[k]] in the backward pass
+            Scalar* tm = arena.allocate<Scalar>(n - 1);
+            Scalar* tp = arena.allocate<Scalar>(n - 1);
+
+            Index l = n - 1, r = n, lo, hi;
+            tm[0] = in[0] - lambda;
+            tp[0] = in[0] + lambda;
+            x[l]  = tm[0];
+            x[r]  = tp[0];
+            a[l]  = 1;
+            b[l]  = -in[0] + lambda;
+            a[r]  = -1;
+            b[r]  = in[0] + lambda;
+            Scalar afirst = 1, bfirst = -lambda - in[1], alast = -1, blast = -lambda + in[1];
+            Scalar alo, blo, ahi, bhi;
+            for (Index k = 1; k < n - 1; ++k){
+                // the negative knot, stepping up from l to a derivative above -lambda
+                alo = afirst;
+                blo = bfirst;
+                for (lo = l; lo <= r; ++lo){
+                    if (alo * x[lo] + blo > -lambda)
+                        break;
+                    alo += a[lo];
+                    blo += b[lo];
+                }
+                tm[k] = (-lambda - blo) / alo;
+                l     = lo - 1;
+                x[l]  = tm[k];
+
+                // the positive knot, stepping down from r to a derivative below lambda
+                ahi = alast;
+                bhi = blast;
+                for (hi = r; hi >= l; --hi){
+                    if (-ahi * x[hi] - bhi < lambda)
+                        break;
+                    ahi += a[hi];
+                    bhi += b[hi];
+                }
+                tp[k] = (lambda + bhi) / (-ahi);
+                r     = hi + 1;
+                x[r]  = tp[k];
+
+                a[l]   = alo;
+                b[l]   = blo + lambda;
+                a[r]   = ahi;
+                b[r]   = bhi + lambda;
+                afirst = 1;
+                bfirst = -lambda - in[k + 1];
+                alast  = -1;
+                blast  = -lambda + in[k + 1];
+            }
+            // the last entry is the zero of the derivative
+            alo = afirst;
+            blo = bfirst;
+            for (lo = l; lo <= r; ++lo){
+                if (alo * x[lo] + blo > 0)
+                    break;
+                alo += a[lo];
+                blo += b[lo];
+            }
+            out[n - 1] = -blo / alo;
+            for (Index k = n - 2; k >= 0; --k)
+                out[k] = std::min(tp[k], std::max(tm[k], out[k + 1]));
+        }
+
+        // tv1d_prox on every column of x
+        void tv1d_cols(const Ref<const Mat> x, Scalar lambda, Ref<Mat> y){
+            Index cols = x.cols();
+            run_chunks(cols, cols > 1 && x.size() >= OPTSUITE_MAT_ARRAY_GRAIN / 8, [&](Index j){
+                tv1d_prox(x.col(j).data(), x.rows(), lambda, y.col(j).data());
+            });
+        }
+
+        // tv1d_prox on every row of x, through a contiguous copy of the row
+        void tv1d_rows(const Ref<const Mat> x, Scalar lambda, Ref<Mat> y){
+            Index rows = x.rows();
+            run_chunks(rows, rows > 1 && x.size() >= OPTSUITE_MAT_ARRAY_GRAIN / 8, [&](Index i){
+                Utils::Arena&       arena = Utils::Arena::current();
+                Utils::Arena::Scope scope(arena);
+                auto                row = arena.vec<Scalar>(x.cols());
+                row = x.row(i).transpose();
+                tv1d_prox(row.data(), row.size(), lambda, row.data());
+                y.row(i) = row.transpose();
+            });
+        }
+
+        // the indexes of the k entries of a largest in magnitude, in no order,
+        // to idx[0, k); idx holds n entries, 0 < k < n
+        template<typename dtype>
+        void top_k(const dtype* a, Index n, Index k, Index* idx){
+            auto larger = [a](Index i, Index j){ return std::fabs(a[i]) > std::fabs(a[j]); };
+            if (k <= n / 64){
+                // a min-heap of the k largest so far, O(n log k) with few moves
+                std::iota(idx, idx + k, Index(0));
+                std::make_heap(idx, idx + k, larger);
+                for (Index i = k; i < n; ++i){
+                    if (std::fabs(a[i]) <= std::fabs(a[idx[0]]))
+                        continue;
+                    std::pop_heap(idx, idx + k, larger);
+                    idx[k - 1] = i;
+                    std::push_heap(idx, idx + k, larger);
+                }
+                return;
+            }
+            std::iota(idx, idx + n, Index(0));
+            std::nth_element(idx, idx + k - 1, idx + n, larger);
+        }
+
+        // top_k on long vectors: every thread selects the top k of a chunk,
+        // then the top k of the candidates are selected
+        template<typename dtype>
+        void parallel_top_k(const dtype* a, Index n, Index k, Index* idx){
+            Index n_chunks = Utils::ThreadPool::global().num_threads();
+            Index len      = (n + n_chunks - 1) / n_chunks;
+            if (n_chunks == 1 || k >= len / 2){
+                top_k(a, n, k, idx);
+                return;
+            }
+            Utils::Arena&       arena = Utils::Arena::current();
+            Utils::Arena::Scope scope(arena);
+            Index* cand = arena.allocate<Index>(n_chunks * k);
+            Utils::parallel_for(n_chunks, [&](Index c){
+                Index begin = c * len, size = std::max(0_i, std::min(len, n - begin));
+                if (size > k){
+                    top_k(a + begin, size, k, idx + begin);
+                    for (Index j = 0; j < k; ++j)
+                        cand[c * k + j] = begin + idx[begin + j];
+                    return;
+                }
+                for (Index j = 0; j < k; ++j)
+                    cand[c * k + j] = j < size ? begin + j : -1;
+            });
+            Index m = std::remove(cand, cand + n_chunks * k, Index(-1)) - cand;
+            std::nth_element(cand, cand + k - 1, cand + m,
+                    [a](Index i, Index j){ return std::fabs(a[i]) > std::fabs(a[j]); });
+            std::copy(cand, cand + k, idx);
+        }
+
+        // nonincreasing and nonnegative, the weights of the sorted l1 norm
+        bool is_slope_sequence(const Ref<const Vec> lambda){
+            for (Index i = 1; i < lambda.size(); ++i)
+                if (lambda(i) > lambda(i - 1))
+                    return false;
+            return lambda.size() == 0 || lambda(lambda.size() - 1) >= 0;
+        }
+
+        // the magnitudes of the n entries of a with their indexes, decreasing
+        using Magnitude = std::pair<Scalar, Index>;
+        void sort_by_magnitude(const Scalar* a, Index n, Magnitude* order){
+            for (Index i = 0; i < n; ++i)
+                order[i] = Magnitude(std::fabs(a[i]), i);
+            std::sort(order, order + n,
+                    [](const Magnitude& u, const Magnitude& v){ return u.first > v.first; });
+        }
+
+        // the prox of sum_i lambda_i |x|_(i) at the n entries of in, by the
+        // stack based algorithm of Bogdan et al., Ann. Appl. Stat. 9 (2015): the
+        // sorted magnitudes minus lambda are pooled into blocks of decreasing
+        // averages, a block is merged into the one below while its average is
+        // not smaller. in and out may be the same.
+        void sorted_l1_prox(const Scalar* in, Index n, const Scalar* lambda, Scalar* out){
+            Utils::Arena&       arena = Utils::Arena::current();
+            Utils::Arena::Scope scope(arena);
+            Magnitude* order = arena.allocate<Magnitude>(n);
+            Index*     start = arena.allocate<Index>(n + 1);
+            Scalar*    sum   = arena.allocate<Scalar>(n);
+            sort_by_magnitude(in, n, order);
+
+            Index top = 0;
+            for (Index k = 0; k < n; ++k){
+                start[top] = k;
+                sum[top]   = order[k].first - lambda[k];
+                ++top;
+                while (top > 1 && sum[top - 1] * (start[top - 1] - start[top - 2]) >=
+                                  sum[top - 2] * (k + 1 - start[top - 1])){
+                    sum[top - 2] += sum[top - 1];
+                    --top;
+                }
+            }
+            start[top] = n;
+            for (Index b = 0; b < top; ++b){
+                Scalar w = std::max(0_s, sum[b] / (start[b + 1] - start[b]));
+                for (Index k = start[b]; k < start[b + 1]; ++k){
+                    Index i = order[k].second;
+                    out[i]  = in[i] > 0 ? w : (in[i] < 0 ? -w : 0_s);
+                }
+            }
+        }
+    }
+
     template<typename dtype>
     Scalar Func<dtype>::operator()(const Ref<const mat_t>){
         OPTSUITE_ASSERT(0);
@@ -36,15 +389,18 @@ namespace OptSuite { namespace Base {
 
     template<typename dtype>
     Scalar Func<dtype>::operator()(const mat_array_t& ma){
-        Scalar r = 0;
-        for (const auto& i : ma)
-            r += (*this)(i);
-        return r;
+        std::vector<Index> chunks = ma.layout().chunks(grain_of(*this));
+        return chunked_sum(chunks.size() - 1, this->is_reentrant(), [&](Index c){
+            Scalar r = 0;
+            for (Index i = chunks[c]; i < chunks[c + 1]; ++i)
+                r += (*this)(ma[i]);
+            return r;
+        });
     }
 
     template<typename dtype>
     Scalar Func<dtype>::operator()(const var_t& var){
-        const mat_wrapper_t* var_ptr = dynamic_cast<const mat_wrapper_t*>(&var);
+        const mat_wrapper_t* var_ptr = variable_cast<mat_wrapper_t>(&var);
         OPTSUITE_ASSERT(var_ptr);
         return (*this)(*var_ptr);
     }
@@ -61,23 +417,40 @@ namespace OptSuite { namespace Base {
 
     template<typename dtype>
     void Proximal<dtype>::operator()(const mat_array_t& ma, Scalar v, mat_array_t& ma_out){
-        for (int i = 0; i < ma.total_blocks(); ++i)
-            (*this)(ma[i], v, ma_out[i]);
+        OPTSUITE_ASSERT(ma.total_blocks() == ma_out.total_blocks());
+        std::vector<Index> chunks = ma.layout().chunks(grain_of(*this));
+        run_chunks(chunks.size() - 1, this->is_reentrant(), [&](Index c){
+            for (Index i = chunks[c]; i < chunks[c + 1]; ++i)
+                (*this)(ma[i], v, ma_out[i]);
+        });
     }
 
     template<typename dtype>
     void Proximal<dtype>::operator()(const var_t& xp, Scalar tau, const var_t& gp,
                                      Scalar v, var_t& x){
-        const mat_wrapper_t* xp_ptr = dynamic_cast<const mat_wrapper_t*>(&xp);
-        const mat_wrapper_t* gp_ptr = dynamic_cast<const mat_wrapper_t*>(&gp);
-              mat_wrapper_t*  x_ptr = dynamic_cast<mat_wrapper_t*>(&x);
+        const mat_wrapper_t* xp_ptr = variable_cast<mat_wrapper_t>(&xp);
+        const mat_wrapper_t* gp_ptr = variable_cast<mat_wrapper_t>(&gp);
+              mat_wrapper_t*  x_ptr = variable_cast<mat_wrapper_t>(&x);
 
         OPTSUITE_ASSERT(xp_ptr != NULL && gp_ptr != NULL && x_ptr != NULL);
-        // x_tmp is created on every call of operator()
-        mat_wrapper_t x_tmp;
-        x_tmp.set_zero_like(*xp_ptr);
-        x_tmp.mat() = xp_ptr->mat() - tau * gp_ptr->mat();
-        (*this)(x_tmp, v, *x_ptr);
+        // x_tmp lives in the arena of the calling solver
+        Utils::Arena& arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        auto x_tmp = arena.mat<dtype>(xp_ptr->mat().rows(), xp_ptr->mat().cols());
+        x_tmp = xp_ptr->mat() - tau * gp_ptr->mat();
+        (*this)(x_tmp, v, x_ptr->mat());
+    }
+
+    template<typename dtype>
+    dtype Proximal<dtype>::prox_entry(dtype, Scalar) const {
+        OPTSUITE_ASSERT(0);
+        return dtype(0);
+    }
+
+    template<typename dtype>
+    void Proximal<dtype>::jacobian(const Ref<const mat_t>, const Ref<const mat_t>, Scalar,
+                                   const Ref<const mat_t>, Ref<mat_t>) const {
+        OPTSUITE_ASSERT(0);
     }
 
     // template instantiation
@@ -91,6 +464,10 @@ namespace OptSuite { namespace Base {
     }
 
 
+    Scalar ElasticNet::operator()(const Ref<const mat_t> x){
+        return mu1 * x.lpNorm<1>() + 0.5_s * mu2 * x.squaredNorm();
+    }
+
     Scalar L2Norm::operator()(const Ref<const mat_t> x) { return mu * x.norm(); }
 
     Scalar LInfNorm::operator()(const Ref<const mat_t> x) {return mu * x.array().abs().maxCoeff();}
@@ -113,8 +490,8 @@ namespace OptSuite { namespace Base {
     }
 
     Scalar NuclearNorm::operator()(const var_t &x) {
-        const mat_wrapper_t *x_ptr   = dynamic_cast<const mat_wrapper_t *>(&x);
-        const fmat_t *       x_ptr_f = dynamic_cast<const fmat_t *>(&x);
+        const mat_wrapper_t *x_ptr   = variable_cast<mat_wrapper_t>(&x);
+        const fmat_t *       x_ptr_f = variable_cast<fmat_t>(&x);
 
         OPTSUITE_ASSERT(x_ptr || x_ptr_f);
 
@@ -124,36 +501,373 @@ namespace OptSuite { namespace Base {
     }
 
     void NuclearNormProx::operator()(Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("NuclearNormProx");
         using Eigen::DecompositionOptions;
         svd.compute(x, DecompositionOptions::ComputeThinU | DecompositionOptions::ComputeThinV);
         y = svd.matrixU() * ((svd.singularValues().array() - t * mu_).matrix().asDiagonal()) *
             svd.matrixV().transpose();
     }
 
+    Scalar NuclearNormProx::dual_scale(const Ref<const mat_t> g) const {
+        Scalar d = spectral_norm(g);
+        return d > mu_ ? mu_ / d : 1_s;
+    }
+
     void ShrinkageL1::operator()(const Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("ShrinkageL1");
+        OPTSUITE_PROFILE_FLOPS(4 * x.size());
         y.array() = x.array().sign() * (x.array().abs() - t * mu).max(0);
     }
 
+    void ShrinkageElasticNet::operator()(const Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("ShrinkageElasticNet");
+        OPTSUITE_PROFILE_FLOPS(5 * x.size());
+        y.array() = x.array().sign() * (x.array().abs() - t * mu1).max(0) / (1 + t * mu2);
+    }
+
+    void BoxProj::operator()(const Ref<const mat_t> x, Scalar, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("BoxProj");
+        OPTSUITE_PROFILE_FLOPS(2 * x.size());
+        y.array() = x.array().max(lo_).min(hi_);
+    }
+
     void ShrinkageL2::operator()(const Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("ShrinkageL2");
+        OPTSUITE_PROFILE_FLOPS(3 * x.size());
         Scalar lambda = 1 - t * mu / x.norm();
         y.array()     = x.array() * std::max(0_s, lambda);
     }
 
     void ShrinkageLInf::operator()(const Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("ShrinkageLInf");
+        OPTSUITE_PROFILE_FLOPS(x.size());
         L1NormBallProj<Scalar> l1(t * mu_);
         l1(x.array(), 1, y);
         y.array() = x.array() - y.array();
     }
 
     void ShrinkageL0::operator()(Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("ShrinkageL0");
+        OPTSUITE_PROFILE_FLOPS(3 * x.size());
         y.array() = x.array() * (x.array().pow(2) > 2_s * t * mu_).cast<Scalar>().array();
     }
 
     void ShrinkageL2Rowwise::operator()(const Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("ShrinkageL2Rowwise");
+        OPTSUITE_PROFILE_FLOPS(3 * x.size() + 2 * x.rows());
         lambda = 1 - t * mu / x.rowwise().norm().array();
         y      = x.array().colwise() * lambda.array().max(0);
     }
 
+    void ShrinkageL2Rowwise::jacobian(const Ref<const mat_t> x, const Ref<const mat_t> p, Scalar,
+                                      const Ref<const mat_t> v, Ref<mat_t> y) const {
+        // a I + (1 - a) nn' on the rows that are not set to zero, with
+        // n = x_i / ||x_i|| and a = ||p_i|| / ||x_i||
+        for (Index i = 0; i < x.rows(); ++i) {
+            Scalar pn = p.row(i).norm();
+            if (pn == 0) {
+                y.row(i).setZero();
+                continue;
+            }
+            Scalar xn = x.row(i).norm();
+            Scalar a  = pn / xn;
+            Scalar nv = x.row(i).dot(v.row(i)) / (xn * xn);
+            y.row(i)  = a * v.row(i) + ((1 - a) * nv) * x.row(i);
+        }
+    }
+
+    GroupL2Norm::GroupL2Norm(const GroupIndex& groups, Scalar mu, Vec weights)
+        : groups_(operator_groups(groups)), weights_(group_weights(groups, std::move(weights))),
+          mu_(mu) {}
+
+    Scalar GroupL2Norm::operator()(const Ref<const mat_t> x) {
+        OPTSUITE_PROFILE_SCOPE("GroupL2Norm");
+        OPTSUITE_PROFILE_FLOPS(2 * x.size());
+        OPTSUITE_ASSERT(x.rows() == groups_.dim());
+        std::vector<Index> chunks = groups_.chunks(OPTSUITE_MAT_ARRAY_GRAIN, x.cols());
+        return mu_ * chunked_sum(chunks.size() - 1, x.size() >= OPTSUITE_MAT_ARRAY_GRAIN, [&](Index c){
+            Scalar r = 0;
+            for (Index g = chunks[c]; g < chunks[c + 1]; ++g)
+                r += weights_(g) * std::sqrt(group_sqr_norm(groups_, x, g));
+            return r;
+        });
+    }
+
+    ShrinkageGroupL2::ShrinkageGroupL2(const GroupIndex& groups, Scalar mu, Vec weights)
+        : groups_(operator_groups(groups)), weights_(group_weights(groups, std::move(weights))),
+          mu_(mu) {}
+
+    void ShrinkageGroupL2::operator()(const Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("ShrinkageGroupL2");
+        OPTSUITE_PROFILE_FLOPS(3 * x.size());
+        OPTSUITE_ASSERT(x.rows() == groups_.dim());
+        if (!groups_.covering())
+            y = x;
+        // a row is in one group only, so the chunks write to disjoint rows
+        std::vector<Index> chunks = groups_.chunks(OPTSUITE_MAT_ARRAY_GRAIN, x.cols());
+        run_chunks(chunks.size() - 1, x.size() >= OPTSUITE_MAT_ARRAY_GRAIN, [&](Index c){
+            for (Index g = chunks[c]; g < chunks[c + 1]; ++g){
+                Scalar xn = std::sqrt(group_sqr_norm(groups_, x, g));
+                Scalar a  = xn > 0 ? std::max(0_s, 1 - t * mu_ * weights_(g) / xn) : 0_s;
+                group_axpby(groups_, a, x, 0, x, y, g);
+            }
+        });
+    }
+
+    Scalar ShrinkageGroupL2::dual_scale(const Ref<const mat_t> g) const {
+        // a group of zero weight is free: h*(-s g) is finite only for s = 0
+        // unless g vanishes on it, as it does at a solution. It is left out
+        // once g is below 1e-10 ||g|| there, which makes the gap approximate,
+        // see has_conjugate
+        Scalar s = 1, free_tol = 1e-10 * g.norm();
+        for (Index k = 0; k < groups_.num_groups(); ++k){
+            Scalar gn = std::sqrt(group_sqr_norm(groups_, g, k));
+            if (weights_(k) == 0){
+                if (gn > free_tol)
+                    return 0;
+                continue;
+            }
+            if (gn > mu_ * weights_(k))
+                s = std::min(s, mu_ * weights_(k) / gn);
+        }
+        return s;
+    }
+
+    void ShrinkageGroupL2::jacobian(const Ref<const mat_t> x, const Ref<const mat_t> p, Scalar,
+                                    const Ref<const mat_t> v, Ref<mat_t> y) const {
+        // a I + (1 - a) nn' on the groups that are not set to zero, as in
+        // ShrinkageL2Rowwise::jacobian, and I on the free rows
+        if (!groups_.covering())
+            y = v;
+        for (Index g = 0; g < groups_.num_groups(); ++g){
+            Scalar pn = std::sqrt(group_sqr_norm(groups_, p, g));
+            if (pn == 0){
+                group_axpby(groups_, 0, v, 0, v, y, g);
+                continue;
+            }
+            Scalar xn = std::sqrt(group_sqr_norm(groups_, x, g));
+            Scalar a  = pn / xn;
+            Scalar nv = group_dot(groups_, x, v, g) / (xn * xn);
+            group_axpby(groups_, a, v, (1 - a) * nv, x, y, g);
+        }
+    }
+
+    SortedL1Norm::SortedL1Norm(const Ref<const Vec> lambda, Scalar mu) : lambda_(lambda), mu_(mu) {
+        OPTSUITE_ASSERT(is_slope_sequence(lambda));
+    }
+
+    Scalar SortedL1Norm::operator()(const Ref<const mat_t> x) {
+        OPTSUITE_PROFILE_SCOPE("SortedL1Norm");
+        OPTSUITE_ASSERT(x.rows() == lambda_.size());
+        Index n = x.rows();
+        return mu_ * chunked_sum(x.cols(), x.cols() > 1 && x.size() >= OPTSUITE_MAT_ARRAY_GRAIN, [&](Index j){
+            Utils::Arena&       arena = Utils::Arena::current();
+            Utils::Arena::Scope scope(arena);
+            auto                a = arena.vec<Scalar>(n);
+            a = x.col(j).cwiseAbs();
+            std::sort(a.data(), a.data() + n, std::greater<Scalar>());
+            return a.dot(lambda_);
+        });
+    }
+
+    SortedL1Prox::SortedL1Prox(const Ref<const Vec> lambda, Scalar mu) : lambda_(lambda), mu_(mu) {
+        OPTSUITE_ASSERT(is_slope_sequence(lambda));
+    }
+
+    void SortedL1Prox::operator()(const Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("SortedL1Prox");
+        OPTSUITE_ASSERT(x.rows() == lambda_.size());
+        Index n = x.rows();
+        Vec   lambda = (t * mu_) * lambda_;
+        run_chunks(x.cols(), x.cols() > 1 && x.size() >= grain_of(*this), [&](Index j){
+            sorted_l1_prox(x.col(j).data(), n, lambda.data(), y.col(j).data());
+        });
+    }
+
+    Scalar SortedL1Prox::dual_scale(const Ref<const mat_t> g) const {
+        // the largest s with sum_{i <= k} s |g|_(i) <= mu sum_{i <= k} lambda_i
+        Utils::Arena&       arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        Index               n = g.rows();
+        auto                a = arena.vec<Scalar>(n);
+        Scalar              s = 1;
+        for (Index j = 0; j < g.cols(); ++j){
+            a = g.col(j).cwiseAbs();
+            std::sort(a.data(), a.data() + n, std::greater<Scalar>());
+            Scalar gs = 0, ls = 0;
+            for (Index k = 0; k < n; ++k){
+                gs += a(k);
+                ls += mu_ * lambda_(k);
+                if (gs * s > ls)
+                    s = ls / gs;
+            }
+        }
+        return s;
+    }
+
+    void SortedL1Prox::jacobian(const Ref<const mat_t>, const Ref<const mat_t> p, Scalar,
+                                const Ref<const mat_t> v, Ref<mat_t> y) const {
+        // the blocks of the pooling are the runs of equal magnitude in p
+        Utils::Arena&       arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        Index               n     = p.rows();
+        Magnitude*          order = arena.allocate<Magnitude>(n);
+        for (Index j = 0; j < p.cols(); ++j){
+            y.col(j).setZero();
+            sort_by_magnitude(p.col(j).data(), n, order);
+            for (Index b = 0, e; b < n && order[b].first > 0; b = e){
+                Scalar r = 0;
+                for (e = b; e < n && order[e].first == order[b].first; ++e){
+                    Index i = order[e].second;
+                    r += p(i, j) > 0 ? v(i, j) : -v(i, j);
+                }
+                r /= e - b;
+                for (Index k = b; k < e; ++k){
+                    Index i = order[k].second;
+                    y(i, j) = p(i, j) > 0 ? r : -r;
+                }
+            }
+        }
+    }
+
+    Scalar TV1DNorm::operator()(const Ref<const mat_t> x) {
+        OPTSUITE_PROFILE_SCOPE("TV1DNorm");
+        OPTSUITE_PROFILE_FLOPS(2 * x.size());
+        if (x.rows() < 2)
+            return 0;
+        return mu_ * (x.bottomRows(x.rows() - 1) - x.topRows(x.rows() - 1)).cwiseAbs().sum();
+    }
+
+    void TV1DProx::operator()(const Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("TV1DProx");
+        OPTSUITE_PROFILE_FLOPS(8 * x.size());
+        tv1d_cols(x, t * mu_, y);
+    }
+
+    Scalar TV2DNorm::operator()(const Ref<const mat_t> x) {
+        OPTSUITE_PROFILE_SCOPE("TV2DNorm");
+        OPTSUITE_PROFILE_FLOPS(4 * x.size());
+        Index m = x.rows(), n = x.cols();
+        if (type_ == TVType::Anisotropic){
+            Scalar r = 0;
+            if (m > 1) r += (x.bottomRows(m - 1) - x.topRows(m - 1)).cwiseAbs().sum();
+            if (n > 1) r += (x.rightCols(n - 1) - x.leftCols(n - 1)).cwiseAbs().sum();
+            return mu_ * r;
+        }
+        // zero differences past the last row and column
+        Mat d1 = Mat::Zero(m, n), d2 = Mat::Zero(m, n);
+        if (m > 1) d1.topRows(m - 1) = x.bottomRows(m - 1) - x.topRows(m - 1);
+        if (n > 1) d2.leftCols(n - 1) = x.rightCols(n - 1) - x.leftCols(n - 1);
+        return mu_ * (d1.array().square() + d2.array().square()).sqrt().sum();
+    }
+
+    void TV2DProx::operator()(const Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("TV2DProx");
+        if (type_ == TVType::Isotropic)
+            fgp(x, t * mu_, y);
+        else
+            dykstra(x, t * mu_, y);
+    }
+
+    void TV2DProx::dykstra(const Ref<const mat_t> x, Scalar lambda, Ref<mat_t> y) {
+        // y = prox_rows(z + q), z = prox_cols(y + p)
+        Index m = x.rows(), n = x.cols();
+        p_.setZero(m, n);
+        q_.setZero(m, n);
+        z_.resize(m, n);
+        y = x;
+        for (iters_ = 1; iters_ <= maxit_; ++iters_){
+            r_ = y + p_;
+            tv1d_cols(r_, lambda, z_);
+            p_ = r_ - z_;
+            r_ = z_ + q_;
+            s_ = y;
+            tv1d_rows(r_, lambda, y);
+            Scalar change = (y - s_).norm();
+            q_ = r_ - y;
+            if (change <= tol_ * std::max(1_s, y.norm()))
+                break;
+        }
+        iters_ = std::min(iters_, maxit_);
+    }
+
+    void TV2DProx::fgp(const Ref<const mat_t> x_in, Scalar lambda, Ref<mat_t> y) {
+        // min ||x - lambda L(p, q)||^2 over |(p_ij, q_ij)| <= 1, y = x - lambda L(p, q)
+        // with L(p, q)_ij = p_ij + q_ij - p_i-1,j - q_i,j-1 the adjoint of the
+        // forward differences; p has a zero last row and q a zero last column.
+        // The momentum restarts when it points uphill (O'Donoghue and Candes)
+        // and the iteration stops on the duality gap, checked every few steps.
+        if (lambda == 0 || maxit_ == 0){
+            iters_ = 0;
+            y = x_in;
+            return;
+        }
+        // y may be x, which is read until the end
+        x_ = x_in;
+        const mat_t& x = x_;
+        Index m = x.rows(), n = x.cols();
+        if (p_.rows() != m || p_.cols() != n){
+            p_.setZero(m, n);
+            q_.setZero(m, n);
+        }
+        r_ = p_;
+        s_ = q_;
+        z_.resize(m, n);
+        bool     parallel = n > 1 && x.size() >= OPTSUITE_MAT_ARRAY_GRAIN;
+        Scalar   step = 1 / (8 * lambda), tk = 1;
+        TV2DNorm tv(lambda, type_);
+        // out = x - lambda L(a, b) on the column j
+        auto primal = [&](const Mat& a, const Mat& b, Ref<Mat> out, Index j){
+            out.col(j) = x.col(j) - lambda * (a.col(j) + b.col(j));
+            if (m > 1) out.col(j).tail(m - 1) += lambda * a.col(j).head(m - 1);
+            if (j > 0) out.col(j) += lambda * b.col(j - 1);
+        };
+        std::vector<Scalar> uphill(n);
+        Scalar x_sqr = x.squaredNorm();
+        for (iters_ = 1; iters_ <= maxit_; ++iters_){
+            run_chunks(n, parallel, [&](Index j){ primal(r_, s_, z_, j); });
+            Scalar tn = (1 + std::sqrt(1 + 4 * tk * tk)) / 2;
+            run_chunks(n, parallel, [&](Index j){
+                // gradient step and projection on the column j
+                Scalar u = 0;
+                for (Index i = 0; i < m; ++i){
+                    Scalar a = i + 1 < m ? r_(i, j) + step * (z_(i, j) - z_(i + 1, j)) : 0_s;
+                    Scalar b = j + 1 < n ? s_(i, j) + step * (z_(i, j) - z_(i, j + 1)) : 0_s;
+                    Scalar nrm = std::max(1_s, std::sqrt(a * a + b * b));
+                    a /= nrm;
+                    b /= nrm;
+                    Scalar da = a - p_(i, j), db = b - q_(i, j);
+                    u += (r_(i, j) - a) * da + (s_(i, j) - b) * db;
+                    p_(i, j) = a;
+                    q_(i, j) = b;
+                    r_(i, j) = a + (tk - 1) / tn * da;
+                    s_(i, j) = b + (tk - 1) / tn * db;
+                }
+                uphill[j] = u;
+            });
+            tk = tn;
+            if (std::accumulate(uphill.begin(), uphill.end(), 0_s) > 0){
+                tk = 1;
+                r_ = p_;
+                s_ = q_;
+            }
+            if (iters_ % 10 != 0 && iters_ < maxit_)
+                continue;
+            // gap between 0.5 ||y - x||^2 + lambda tv(y) and 0.5 ||x||^2 - 0.5 ||y||^2
+            run_chunks(n, parallel, [&](Index j){ primal(p_, q_, y, j); });
+            Scalar primal_obj = 0.5 * (y - x).squaredNorm() + tv(y);
+            Scalar gap = primal_obj - 0.5 * (x_sqr - y.squaredNorm());
+            if (gap <= tol_ * std::max(1_s, primal_obj))
+                break;
+        }
+        iters_ = std::min(iters_, maxit_);
+    }
+
+    Scalar ShrinkageNuclear::dual_scale(const Ref<const mat_t> g) const {
+        Scalar d = spectral_norm(g);
+        return d > mu ? mu / d : 1_s;
+    }
+
     Index ShrinkageNuclear::compute_rank() const {
         // find the first index < threshold
         // using binary search algorithm
@@ -170,6 +884,7 @@ namespace OptSuite { namespace Base {
     }
 
     void ShrinkageNuclear::operator()(const Ref<const mat_t> x, Scalar t, Ref<mat_t> y){
+        OPTSUITE_PROFILE_SCOPE("ShrinkageNuclear");
         const vec_t& sv = svd.compute(x, op).singularValues();
         const mat_t& U = svd.matrixU();
         const mat_t& V = svd.matrixV();
@@ -177,16 +892,30 @@ namespace OptSuite { namespace Base {
         d.array() = (sv.array() - t * mu).max(0);
 
         Index rank = compute_rank();
+        // the cost of the SVD itself is not declared
+        OPTSUITE_PROFILE_FLOPS(2 * x.rows() * x.cols() * rank);
         if (rank == 0)
             y = mat_t::Zero(x.rows(), x.cols());
         else
             y = (U.array().block(0, 0, x.rows(), rank).rowwise() *
-                d.array().block(0, 0, rank, 1).transpose()).matrix() *
+                d.head(rank).transpose().array()).matrix() *
                 V.block(0, 0, x.cols(), rank).transpose();
     }
 
     void ShrinkageNuclear::operator()(const fmat_t& xp, Scalar tau, const smat_t& gp,
             Scalar v, fmat_t& x){
+        factorized(xp, tau, gp, v, x);
+    }
+
+    void ShrinkageNuclear::operator()(const fmat_t& xp, Scalar tau, const ssmat_t& gp,
+            Scalar v, fmat_t& x){
+        factorized(xp, tau, gp, v, x);
+    }
+
+    template<typename S>
+    void ShrinkageNuclear::factorized(const fmat_t& xp, Scalar tau, const S& gp,
+            Scalar v, fmat_t& x){
+        OPTSUITE_PROFILE_SCOPE("ShrinkageNuclear::factorized");
         // construct mat op
         FactorizePSpMatOp<Scalar> Aop(xp, -tau, gp);
 
@@ -203,20 +932,21 @@ namespace OptSuite { namespace Base {
         Index rank = compute_rank();
 
         x.set_UV(
-                (U.array().block(0, 0, x.rows(), rank).rowwise() * d.array().block(0, 0, rank, 1).transpose().sqrt()).matrix(),
-                (V.array().block(0, 0, x.cols(), rank).rowwise() * d.array().block(0, 0, rank, 1).transpose().sqrt()).matrix()
+                (U.array().block(0, 0, x.rows(), rank).rowwise() * d.head(rank).transpose().array().sqrt()).matrix(),
+                (V.array().block(0, 0, x.cols(), rank).rowwise() * d.head(rank).transpose().array().sqrt()).matrix()
                 );
 
     }
 
     void ShrinkageNuclear::operator()(const var_t& xp, Scalar tau, const var_t& gp,
             Scalar v, var_t& x){
-        const mat_wrapper_t* xp_ptr = dynamic_cast<const mat_wrapper_t*>(&xp);
-        const fmat_t* xp_ptr_f = dynamic_cast<const fmat_t*>(&xp);
-        const mat_wrapper_t* gp_ptr = dynamic_cast<const mat_wrapper_t*>(&gp);
-        const spmat_wrapper_t* gp_ptr_s = dynamic_cast<const spmat_wrapper_t*>(&gp);
-              mat_wrapper_t*  x_ptr = dynamic_cast<mat_wrapper_t*>(&x);
-              fmat_t* x_ptr_f = dynamic_cast<fmat_t*>(&x);
+        const mat_wrapper_t* xp_ptr = variable_cast<mat_wrapper_t>(&xp);
+        const fmat_t* xp_ptr_f = variable_cast<fmat_t>(&xp);
+        const mat_wrapper_t* gp_ptr = variable_cast<mat_wrapper_t>(&gp);
+        const spmat_wrapper_t* gp_ptr_s = variable_cast<spmat_wrapper_t>(&gp);
+        const ssmat_t* gp_ptr_ss = variable_cast<ssmat_t>(&gp);
+              mat_wrapper_t*  x_ptr = variable_cast<mat_wrapper_t>(&x);
+              fmat_t* x_ptr_f = variable_cast<fmat_t>(&x);
 
         // only the following combination is supported:
         // 1) dense + dense -> 0b0101
@@ -225,21 +955,28 @@ namespace OptSuite { namespace Base {
         bool is_dense_x = xp_ptr && x_ptr;
         bool is_factor_x = xp_ptr_f && x_ptr_f;
         bool is_dense_g = gp_ptr != NULL;
-        bool is_sparse_g = gp_ptr_s != NULL;
+        bool is_sparse_g = gp_ptr_s != NULL || gp_ptr_ss != NULL;
 
         if (is_dense_x && (is_dense_g || is_sparse_g)) {
-            // x_tmp is created on every call of operator()
-            mat_wrapper_t x_tmp;
-            x_tmp.set_zero_like(*xp_ptr);
+            // x_tmp lives in the arena of the calling solver
+            Utils::Arena& arena = Utils::Arena::current();
+            Utils::Arena::Scope scope(arena);
+            auto x_tmp = arena.mat<Scalar>(xp_ptr->mat().rows(), xp_ptr->mat().cols());
             if (is_dense_g){
-                x_tmp.mat() = xp_ptr->mat() - tau * gp_ptr->mat();
+                x_tmp = xp_ptr->mat() - tau * gp_ptr->mat();
+            } else if (gp_ptr_s) {
+                x_tmp = xp_ptr->mat();
+                x_tmp -= tau * gp_ptr_s->spmat();
             } else {
-                x_tmp.mat() = xp_ptr->mat();
-                x_tmp.mat() -= tau * gp_ptr_s->spmat();
+                x_tmp = xp_ptr->mat();
+                x_tmp -= tau * gp_ptr_ss->spmat();
             }
-            (*this)(x_tmp.mat(), v, x_ptr->mat());
+            (*this)(x_tmp, v, x_ptr->mat());
         } else if (is_factor_x && is_sparse_g) {
-            (*this)(*xp_ptr_f, tau, *gp_ptr_s, v, *x_ptr_f);
+            if (gp_ptr_s)
+                factorized(*xp_ptr_f, tau, *gp_ptr_s, v, *x_ptr_f);
+            else
+                factorized(*xp_ptr_f, tau, *gp_ptr_ss, v, *x_ptr_f);
         }
     }
 
@@ -248,57 +985,187 @@ namespace OptSuite { namespace Base {
 
     template<typename dtype>
     void L1NormBallProj<dtype>::operator()( Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("L1NormBallProj");
+        OPTSUITE_PROFILE_FLOPS(5 * x.size());
         OPTSUITE_ASSERT(x.cols() == 1);
         dtype l1_norm = x.template lpNorm<1>();
         if (l1_norm <= mu_) {
             y = x;
             return;
         }
-        std::vector<SparseIndex> indexes(x.rows());
-        std::iota(indexes.begin(), indexes.end(), 0);
-        std::sort(indexes.begin(), indexes.end(),
-                  [&x](SparseIndex a, SparseIndex b) { return std::fabs(x.coeff(a, 0)) > std::fabs(x.coeff(b, 0)); });
-        bool  root_found = false;
-        dtype prefix_sum = 0, lambda;
-        for (SparseIndex i = 0; i < indexes.size(); i++) {
-            prefix_sum += indexes[i];
-            lambda = (prefix_sum - mu_) / (i + 1);
-            if (lambda <= indexes[i] && (i + 1 == indexes.size() || indexes[i + 1] <= lambda)) {
-                root_found = true;
-                break;
-            }
-        }
-        OPTSUITE_ASSERT(root_found);
+        // the buffers live in the arena of the calling solver
+        Utils::Arena&       arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        Index               n = x.rows();
+        auto                a = arena.vec<dtype>(n);
+        a                     = x.col(0).cwiseAbs();
+        dtype lambda = simplex_threshold(a.data(), n, dtype(mu_), arena.allocate<dtype>(n));
         y = x.array().sign() * (x.array().abs() - lambda).max(0_s);
     }
 
+    template<typename dtype>
+    void L1NormBallProj<dtype>::jacobian(const Ref<const mat_t> x, const Ref<const mat_t> p,
+                                         Scalar, const Ref<const mat_t> v, Ref<mat_t> y) const {
+        if (x.template lpNorm<1>() <= mu_) {
+            y = v;
+            return;
+        }
+        // projection onto the face of the ball through p: the entries of the
+        // support S with the mean of sign(x) .* v over S removed along sign(x)
+        auto   on = (p.array() != 0);
+        Index  k  = on.count();
+        Scalar m  = on.select(x.array().sign() * v.array(), 0).sum() / std::max(k, 1_i);
+        y         = on.select(v.array() - m * x.array().sign(), 0);
+    }
+
     template class L1NormBallProj<Scalar>;
 
+    template<typename dtype>
+    void SimplexProj<dtype>::operator()( Ref<const mat_t> x, Scalar, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("SimplexProj");
+        OPTSUITE_PROFILE_FLOPS(4 * x.size());
+        OPTSUITE_ASSERT(x.cols() == 1 && x.rows() > 0);
+        Utils::Arena&       arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        dtype tau = simplex_threshold(x.data(), x.rows(), dtype(radius_),
+                                      arena.allocate<dtype>(x.rows()));
+        y = (x.array() - tau).max(0_s);
+    }
+
+    template<typename dtype>
+    void SimplexProj<dtype>::jacobian(const Ref<const mat_t>, const Ref<const mat_t> p,
+                                      Scalar, const Ref<const mat_t> v, Ref<mat_t> y) const {
+        // v on the support of p with its mean over the support removed
+        auto   on = (p.array() > 0);
+        Scalar m  = on.select(v, 0).sum() / std::max(on.count(), 1_i);
+        y         = on.select(v.array() - m, 0);
+    }
+
+    template class SimplexProj<Scalar>;
+
+    template<typename dtype>
+    void WeightedL1NormBallProj<dtype>::operator()( Ref<const mat_t> x, Scalar, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("WeightedL1NormBallProj");
+        OPTSUITE_PROFILE_FLOPS(8 * x.size());
+        OPTSUITE_ASSERT(x.cols() == 1 && x.rows() == w_.size());
+        if (x.col(0).cwiseAbs().dot(w_) <= mu_) {
+            y = x;
+            return;
+        }
+        // y_i = sign(x_i) max(|x_i| - lambda w_i, 0) with the lambda making
+        // sum_i w_i |y_i| = mu, found by pivoting on the breakpoints |x_i| / w_i;
+        // the entries known to be active add up to s1 = sum w_i |x_i| and
+        // s2 = sum w_i^2, lambda = (s1 - mu) / s2 at the end
+        Utils::Arena&       arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        Index               n   = x.rows();
+        auto                r   = arena.vec<dtype>(n);
+        Index*              idx = arena.allocate<Index>(n);
+        r                       = x.col(0).cwiseAbs().cwiseQuotient(w_);
+        std::iota(idx, idx + n, Index(0));
+        dtype s1 = 0, s2 = 0;
+        Index lo = 0, hi = n;
+        while (lo < hi) {
+            dtype  pivot = r(idx[lo + (hi - lo) / 2]);
+            Index* gt    = std::partition(idx + lo, idx + hi, [&](Index i) { return r(i) > pivot; });
+            Index* eq    = std::partition(gt, idx + hi, [&](Index i) { return r(i) == pivot; });
+            dtype  g1 = 0, g2 = 0;
+            for (Index* k = idx + lo; k != eq; ++k) {
+                g1 += w_(*k) * std::fabs(x(*k, 0));
+                g2 += w_(*k) * w_(*k);
+            }
+            if (s1 + g1 - pivot * (s2 + g2) > mu_) {
+                // lambda > pivot, the active entries are above the pivot
+                hi = gt - idx;
+            } else {
+                s1 += g1;
+                s2 += g2;
+                lo = eq - idx;
+            }
+        }
+        dtype lambda = (s1 - mu_) / s2;
+        y = x.array().sign() * (x.col(0).array().abs() - lambda * w_.array()).max(0_s);
+    }
+
+    template<typename dtype>
+    void WeightedL1NormBallProj<dtype>::jacobian(const Ref<const mat_t> x, const Ref<const mat_t> p,
+                                                 Scalar, const Ref<const mat_t> v,
+                                                 Ref<mat_t> y) const {
+        if (x.col(0).cwiseAbs().dot(w_) <= mu_) {
+            y = v;
+            return;
+        }
+        // v on the support of p with its component along sign(x) .* w removed
+        auto   on = (p.col(0).array() != 0);
+        vec_t  n  = on.select(x.col(0).array().sign() * w_.array(), 0);
+        Scalar nn = n.squaredNorm();
+        y         = on.select(v.col(0) - (nn > 0 ? n.dot(v.col(0)) / nn : 0) * n, 0);
+    }
+
+    template class WeightedL1NormBallProj<Scalar>;
+
     template<typename dtype>
     void L0NormBallProj<dtype>::operator()( Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
-        OPTSUITE_ASSERT(x.cols() == 1);
-        SparseIndex              count = std::floor(mu_);
-        std::vector<SparseIndex> indexes(x.rows());
-        std::iota(indexes.begin(), indexes.end(), 0);
-        std::sort(indexes.begin(), indexes.end(),
-                  [&x](SparseIndex a, SparseIndex b) { return std::fabs(x.coeff(a, 0)) > std::fabs(x.coeff(b, 0)); });
-        y = x;
-        for (SparseIndex i = count; i < indexes.size(); i++) { y.coeffRef(indexes[i],0) = 0; }
+        OPTSUITE_PROFILE_SCOPE("L0NormBallProj");
+        OPTSUITE_PROFILE_FLOPS(2 * x.size());
+        Index n = x.rows(), k = std::max(0_i, Index(std::floor(mu_)));
+        if (k >= n) {
+            y = x;
+            return;
+        }
+        if (k == 0) {
+            y.setZero();
+            return;
+        }
+        // a selection per column, the buffers live in the arena of the calling
+        // thread; the kept entries are saved first as y may alias x
+        auto column = [&](Index j) {
+            Utils::Arena&       arena = Utils::Arena::current();
+            Utils::Arena::Scope scope(arena);
+            Index*              idx  = arena.allocate<Index>(n);
+            dtype*              kept = arena.allocate<dtype>(k);
+            const dtype*        a    = x.col(j).data();
+            if (n >= OPTSUITE_TOP_K_PARALLEL)
+                parallel_top_k(a, n, k, idx);
+            else
+                top_k(a, n, k, idx);
+            for (Index i = 0; i < k; ++i) kept[i] = a[idx[i]];
+            y.col(j).setZero();
+            for (Index i = 0; i < k; ++i) y(idx[i], j) = kept[i];
+        };
+        run_chunks(x.cols(), x.cols() > 1 && x.size() >= OPTSUITE_MAT_ARRAY_GRAIN, column);
     }
 
     template class L0NormBallProj<Scalar>;
     
     template<typename dtype>
     void L2NormBallProj<dtype>::operator()( Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("L2NormBallProj");
+        OPTSUITE_PROFILE_FLOPS(3 * x.size());
         y = x.array() * (mu_ / std::max(mu_, x.norm()));
     }
 
+    template<typename dtype>
+    void L2NormBallProj<dtype>::jacobian(const Ref<const mat_t> x, const Ref<const mat_t>,
+                                         Scalar, const Ref<const mat_t> v, Ref<mat_t> y) const {
+        Scalar xn = x.norm();
+        if (xn <= mu_) {
+            y = v;
+            return;
+        }
+        // (mu / ||x||) (I - nn') with n = x / ||x||
+        Scalar nv = x.cwiseProduct(v).sum() / (xn * xn);
+        y         = (mu_ / xn) * (v - nv * x);
+    }
+
     template class L2NormBallProj<Scalar>;
 
 
     template<typename dtype>
     void LInfBallProj<dtype>::operator()( Ref<const mat_t> x, Scalar t, Ref<mat_t> y) {
-        y = x.array().sign() * x.array().abs().max(mu_);
+        OPTSUITE_PROFILE_SCOPE("LInfBallProj");
+        OPTSUITE_PROFILE_FLOPS(2 * x.size());
+        y = x.array().sign() * x.array().abs().min(mu_);
     }
 
     template class LInfBallProj<Scalar>;
@@ -315,6 +1182,22 @@ namespace OptSuite { namespace Base {
         return 0;
     }
 
+    template<typename dtype>
+    Scalar FuncGrad<dtype>::dual_objective(const Ref<const mat_t>, Scalar, Scalar) {
+        OPTSUITE_ASSERT(0);
+        return 0;
+    }
+
+    template<typename dtype>
+    void FuncGrad<dtype>::hessian(const Ref<const mat_t>, const Ref<const mat_t>, Ref<mat_t>) {
+        OPTSUITE_ASSERT(0);
+    }
+
+    template<typename dtype>
+    void FuncGrad<dtype>::prox(const Ref<const mat_t>, Scalar, Ref<mat_t>) {
+        OPTSUITE_ASSERT(0);
+    }
+
     template<typename dtype>
     Scalar FuncGrad<dtype>::operator()(const mat_wrapper_t& x){
         mat_wrapper_t dummy_y;
@@ -330,18 +1213,25 @@ namespace OptSuite { namespace Base {
 
     template<typename dtype>
     Scalar FuncGrad<dtype>::operator()(const mat_array_t& ma){
-        Scalar r = 0;
-        for(const auto& i : ma)
-            r += (*this)(i);
-        return r;
+        std::vector<Index> chunks = ma.layout().chunks(grain_of(*this));
+        return chunked_sum(chunks.size() - 1, this->is_reentrant(), [&](Index c){
+            Scalar r = 0;
+            for (Index i = chunks[c]; i < chunks[c + 1]; ++i)
+                r += (*this)(ma[i]);
+            return r;
+        });
     }
 
     template<typename dtype>
     Scalar FuncGrad<dtype>::operator()(const mat_array_t& x, mat_array_t& y, bool compute_grad){
-        Scalar r = 0;
-        for(int i = 0; i < x.total_blocks(); ++i)
-            r += (*this)(x[i], y[i], compute_grad);
-        return r;
+        OPTSUITE_ASSERT(x.total_blocks() == y.total_blocks());
+        std::vector<Index> chunks = x.layout().chunks(grain_of(*this));
+        return chunked_sum(chunks.size() - 1, this->is_reentrant(), [&](Index c){
+            Scalar r = 0;
+            for (Index i = chunks[c]; i < chunks[c + 1]; ++i)
+                r += (*this)(x[i], y[i], compute_grad);
+            return r;
+        });
     }
 
     template<typename dtype>
@@ -352,13 +1242,34 @@ namespace OptSuite { namespace Base {
 
     template<typename dtype>
     Scalar FuncGrad<dtype>::operator()(const var_t& x, var_t& y, bool compute_grad){
-        const mat_wrapper_t* x_ptr = dynamic_cast<const mat_wrapper_t*>(&x);
-              mat_wrapper_t* y_ptr = dynamic_cast<mat_wrapper_t*>(&y);
+        const mat_wrapper_t* x_ptr = variable_cast<mat_wrapper_t>(&x);
+              mat_wrapper_t* y_ptr = variable_cast<mat_wrapper_t>(&y);
 
         OPTSUITE_ASSERT(x_ptr != NULL && y_ptr != NULL);
         return (*this)(*x_ptr, *y_ptr, compute_grad);
     }
 
+    template<typename dtype>
+    Scalar FiniteSumFuncGrad<dtype>::sample(const Ref<const mat_t> x, Index i, Ref<mat_t> y,
+                                            bool compute_grad){
+        return batch(x, std::vector<Index>(1, i), y, compute_grad);
+    }
+
+    template<typename dtype>
+    void FiniteSumFuncGrad<dtype>::sample_derivative(const Ref<const mat_t>,
+                                                     const std::vector<Index>&, Ref<mat_t>){
+        OPTSUITE_ASSERT(0);
+    }
+
+    template<typename dtype>
+    void FiniteSumFuncGrad<dtype>::add_samples(const std::vector<Index>&, const Ref<const mat_t>,
+                                               Scalar, Ref<mat_t>){
+        OPTSUITE_ASSERT(0);
+    }
+
+    template class FiniteSumFuncGrad<Scalar>;
+    template class FiniteSumFuncGrad<ComplexScalar>;
+
     template<typename dtype>
     AxmbNormSqr<dtype>::AxmbNormSqr(const Ref<const mat_t> A, const Ref<const mat_t> b){
         OPTSUITE_ASSERT(A.rows() == b.rows());
@@ -368,12 +1279,108 @@ namespace OptSuite { namespace Base {
 
     template<typename dtype>
     Scalar AxmbNormSqr<dtype>::operator()(const Ref<const mat_t> x, Ref<mat_t> y, bool compute_grad){
+        OPTSUITE_PROFILE_SCOPE("AxmbNormSqr");
+        // A * x, - b, squared norm and A' * r
+        OPTSUITE_PROFILE_FLOPS((compute_grad ? 4 : 2) * A.rows() *
+                               (screened ? Index(active.size()) : A.cols()) * x.cols() +
+                               3 * A.rows() * x.cols());
+        if (screened){
+            Utils::Arena& arena = Utils::Arena::current();
+            Utils::Arena::Scope scope(arena);
+            auto xa = arena.mat<dtype>(active.size(), x.cols());
+            for (Index k = 0; k < xa.rows(); ++k)
+                xa.row(k) = x.row(active[k]);
+            r.noalias() = A_active * xa - b;
+            Scalar fun = 0.5 * r.squaredNorm();
+            if (compute_grad){
+                xa.noalias() = A_active.transpose() * r;
+                y.setZero();
+                for (Index k = 0; k < xa.rows(); ++k)
+                    y.row(active[k]) = xa.row(k);
+            }
+            return fun;
+        }
         r.noalias() = A * x - b;
         Scalar fun = 0.5 * r.squaredNorm();
         if (compute_grad) y = A.transpose() * r;
         return fun;
     }
 
+    template<typename dtype>
+    void AxmbNormSqr<dtype>::set_active(const std::vector<Index>& idx){
+        screened = true;
+        active = idx;
+        A_active.resize(A.rows(), active.size());
+        for (Index k = 0; k < A_active.cols(); ++k)
+            A_active.col(k) = A.col(active[k]);
+    }
+
+    template<typename dtype>
+    void AxmbNormSqr<dtype>::clear_active(){
+        screened = false;
+        active.clear();
+        A_active.resize(0, 0);
+    }
+
+    template<typename dtype>
+    Scalar AxmbNormSqr<dtype>::dual_objective(const Ref<const mat_t> x, Scalar f, Scalar s){
+        // L(z) = 0.5 ||z - b||^2, L*(u) = 0.5 ||u||^2 + <u, b> and u = r = Ax - b,
+        // with ||r||^2 = 2 f and <r, b> = <x, A'b> - ||b||^2
+        if (Atb.size() == 0)
+            Atb.noalias() = A.adjoint() * b;
+        Scalar rb = std::real(x.cwiseProduct(Atb.conjugate()).sum()) - b.squaredNorm();
+        return -(s * s * f + s * rb);
+    }
+
+    template<typename dtype>
+    void AxmbNormSqr<dtype>::hessian(const Ref<const mat_t>, const Ref<const mat_t> v,
+                                     Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("AxmbNormSqr::hessian");
+        OPTSUITE_PROFILE_FLOPS(4 * A.rows() * A.cols() * v.cols());
+        OPTSUITE_ASSERT(!screened);
+        Utils::Arena& arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        auto Av = arena.mat<dtype>(A.rows(), v.cols());
+        Av.noalias() = A * v;
+        y.noalias()  = A.adjoint() * Av;
+    }
+
+    template<typename dtype>
+    void AxmbNormSqr<dtype>::prox(const Ref<const mat_t> v, Scalar t, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("AxmbNormSqr::prox");
+        OPTSUITE_ASSERT(!screened && t > 0);
+        bool wide = A.rows() < A.cols();
+        if (gram.size() == 0) {
+            OPTSUITE_PROFILE_SCOPE("gram");
+            if (wide)
+                gram.noalias() = A * A.adjoint();
+            else
+                gram.noalias() = A.adjoint() * A;
+        }
+        if (Atb.size() == 0)
+            Atb.noalias() = A.adjoint() * b;
+        if (t != prox_t) {
+            OPTSUITE_PROFILE_SCOPE("factorize");
+            OPTSUITE_PROFILE_FLOPS(gram.rows() * gram.rows() * gram.rows() / 3);
+            prox_llt.compute(mat_t::Identity(gram.rows(), gram.cols()) + t * gram);
+            prox_t = t;
+        }
+        Utils::Arena& arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        auto w = arena.mat<dtype>(v.rows(), v.cols());
+        w = v + t * Atb;
+        if (!wide) {
+            y = prox_llt.solve(w);
+            return;
+        }
+        // (I + t A'A)^{-1} = I - t A' (I + t AA')^{-1} A
+        auto Aw = arena.mat<dtype>(A.rows(), v.cols());
+        Aw.noalias() = A * w;
+        prox_llt.solveInPlace(Aw);
+        y = w;
+        y.noalias() -= t * (A.adjoint() * Aw);
+    }
+
     template<typename dtype>
     const typename AxmbNormSqr<dtype>::mat_t& AxmbNormSqr<dtype>::get_A() const {
         return A;
@@ -384,6 +1391,42 @@ namespace OptSuite { namespace Base {
         return b;
     }
 
+    template<typename dtype>
+    Scalar AxmbNormSqr<dtype>::batch(const Ref<const mat_t> x, const std::vector<Index>& idx,
+                                     Ref<mat_t> y, bool compute_grad){
+        OPTSUITE_PROFILE_SCOPE("AxmbNormSqr::batch");
+        OPTSUITE_PROFILE_FLOPS((compute_grad ? 4 : 2) * A.cols() * x.cols() * Index(idx.size()));
+        Utils::Arena& arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        auto ri = arena.mat<dtype>(1, x.cols());
+        Scalar fun = 0;
+        if (compute_grad)
+            y.setZero();
+        for (Index i : idx){
+            // r_i = a_i' x - b_i, a row
+            ri.noalias() = A.row(i) * x - b.row(i);
+            fun += 0.5 * ri.squaredNorm();
+            if (compute_grad)
+                y.noalias() += A.row(i).transpose() * ri;
+        }
+        return fun;
+    }
+
+    template<typename dtype>
+    void AxmbNormSqr<dtype>::sample_derivative(const Ref<const mat_t> x,
+                                               const std::vector<Index>& idx, Ref<mat_t> D){
+        OPTSUITE_ASSERT(D.rows() == Index(idx.size()) && D.cols() == x.cols());
+        for (Index j = 0; j < Index(idx.size()); ++j)
+            D.row(j).noalias() = A.row(idx[j]) * x - b.row(idx[j]);
+    }
+
+    template<typename dtype>
+    void AxmbNormSqr<dtype>::add_samples(const std::vector<Index>& idx, const Ref<const mat_t> D,
+                                         Scalar alpha, Ref<mat_t> y){
+        for (Index j = 0; j < Index(idx.size()); ++j)
+            y.noalias() += alpha * A.row(idx[j]).transpose() * D.row(j);
+    }
+
     // instantiate
     template class AxmbNormSqr<Scalar>;
     template class AxmbNormSqr<ComplexScalar>;
@@ -399,38 +1442,131 @@ namespace OptSuite { namespace Base {
     template<typename dtype>
     Scalar LogisticRegression<dtype>::operator()(Ref<const mat_t> x, Ref<mat_t> y,
                                                  bool compute_grad) {
+        OPTSUITE_PROFILE_SCOPE("LogisticRegression");
         OPTSUITE_ASSERT(x.cols() == 1);
         OPTSUITE_ASSERT(x.rows() == A_.rows());
-        col_vec_t t     = mbA_.transpose() * x;
-        col_vec_t p     = t.array().exp();
-        col_vec_t q     = p.array() + 1;
-        col_vec_t r     = q.array().log();
-        Scalar    fun   = r.mean();
+        // one GEMV for the margins and one for the gradient, the
+        // transcendental functions are counted as one flop each
+        OPTSUITE_PROFILE_FLOPS((compute_grad ? 4 : 2) * A_.rows() * A_.cols() + 8 * A_.cols());
+        // the work vectors live in the arena of the calling thread
+        Utils::Arena& arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        Index n = A_.cols();
+        auto t = arena.vec<dtype>(n);
+        auto e = arena.vec<dtype>(n);
+        t.noalias() = mbA_.transpose() * x;
+        // log(1 + exp(t)) = max(t, 0) + log1p(exp(-|t|)) does not overflow
+        // for large margins, and exp(-|t|) gives the sigmoid as well
+        e = (-t.array().abs()).exp();
+        Scalar fun = (t.array().max(0) + e.array().log1p()).mean();
         if (compute_grad) {
-            col_vec_t s = p.array() / q.array();
-            mat_t     u = mbA_.array().rowwise() * s.transpose().array();
-            y           = u.array().rowwise().mean();
+            // t <- sigmoid(t) / n, then y = mbA_ * t
+            t = (t.array() >= 0).select(1 / (1 + e.array()), e.array() / (1 + e.array())) / n;
+            y.noalias() = mbA_ * t;
         }
         return fun;
     }
+    template<typename dtype>
+    Scalar LogisticRegression<dtype>::batch(const Ref<const mat_t> x, const std::vector<Index>& idx,
+                                            Ref<mat_t> y, bool compute_grad){
+        OPTSUITE_PROFILE_SCOPE("LogisticRegression::batch");
+        OPTSUITE_PROFILE_FLOPS((compute_grad ? 4 : 2) * A_.rows() * Index(idx.size()));
+        // f_i(x) = log(1 + exp(t_i)) / N with t_i = -b_i a_i' x
+        Scalar inv_n = 1_s / A_.cols(), fun = 0;
+        if (compute_grad)
+            y.setZero();
+        for (Index i : idx){
+            Scalar t = mbA_.col(i).dot(x.col(0));
+            Scalar e = std::exp(-std::abs(t));
+            fun += std::max(t, 0_s) + std::log1p(e);
+            if (compute_grad)
+                y.col(0) += (inv_n * (t >= 0 ? 1 / (1 + e) : e / (1 + e))) * mbA_.col(i);
+        }
+        return inv_n * fun;
+    }
+
+    template<typename dtype>
+    void LogisticRegression<dtype>::sample_derivative(const Ref<const mat_t> x,
+                                                      const std::vector<Index>& idx, Ref<mat_t> D){
+        OPTSUITE_ASSERT(D.rows() == Index(idx.size()) && D.cols() == 1);
+        // d_i = sigmoid(t_i) / N for the column a_i = -b_i A_i
+        Scalar inv_n = 1_s / A_.cols();
+        for (Index j = 0; j < Index(idx.size()); ++j){
+            Scalar t = mbA_.col(idx[j]).dot(x.col(0));
+            Scalar e = std::exp(-std::abs(t));
+            D(j, 0) = inv_n * (t >= 0 ? 1 / (1 + e) : e / (1 + e));
+        }
+    }
+
+    template<typename dtype>
+    void LogisticRegression<dtype>::add_samples(const std::vector<Index>& idx,
+                                                const Ref<const mat_t> D, Scalar alpha,
+                                                Ref<mat_t> y){
+        for (Index j = 0; j < Index(idx.size()); ++j)
+            y.col(0) += (alpha * D(j, 0)) * mbA_.col(idx[j]);
+    }
+
+    template<typename dtype>
+    Scalar LogisticRegression<dtype>::dual_objective(Ref<const mat_t> x, Scalar, Scalar s) {
+        OPTSUITE_PROFILE_SCOPE("LogisticRegression::dual_objective");
+        // L*(s u) = mean(q log q + (1 - q) log(1 - q)) with q = s * sigmoid(t)
+        Utils::Arena& arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        Index n = A_.cols();
+        auto t = arena.vec<dtype>(n);
+        t.noalias() = mbA_.transpose() * x;
+        Scalar ent = 0;
+        for (Index i = 0; i < n; ++i){
+            Scalar e = std::exp(-std::abs(t[i]));
+            Scalar q = s * (t[i] >= 0 ? 1 / (1 + e) : e / (1 + e));
+            ent += xlogx(q) + xlogx(1 - q);
+        }
+        return -ent / n;
+    }
+
+    template<typename dtype>
+    void LogisticRegression<dtype>::hessian(Ref<const mat_t> x, Ref<const mat_t> v, Ref<mat_t> y) {
+        OPTSUITE_PROFILE_SCOPE("LogisticRegression::hessian");
+        OPTSUITE_PROFILE_FLOPS(4 * A_.rows() * A_.cols());
+        Index n = A_.cols();
+        // mbA_ diag(s (1 - s)) mbA_' / n, s = sigmoid(mbA_' x)
+        if (hess_x_.size() != x.size() || hess_x_ != x) {
+            hess_x_ = x;
+            hess_w_.noalias() = mbA_.transpose() * x;
+            hess_w_ = (-hess_w_.array().abs()).exp();
+            hess_w_ = hess_w_.array() / (1 + hess_w_.array()).square() / n;
+        }
+        Utils::Arena& arena = Utils::Arena::current();
+        Utils::Arena::Scope scope(arena);
+        auto t = arena.vec<dtype>(n);
+        t.noalias() = mbA_.transpose() * v;
+        t.array() *= hess_w_.array();
+        y.noalias() = mbA_ * t;
+    }
+
     template class LogisticRegression<Scalar>;
 
     template<typename dtype>
     ProjectionOmega<dtype>::ProjectionOmega(const Ref<const spmat_t> ref,
                                             const Ref<const mat_t>   b_) {
-        outerIndexPtr.resize(ref.cols() + 1_i);
-        innerIndexPtr.resize(ref.nonZeros());
+        outerIndexPtr = std::make_shared<std::vector<SparseIndex>>(
+                ref.outerIndexPtr(), ref.outerIndexPtr() + ref.cols() + 1_i);
+        innerIndexPtr = std::make_shared<std::vector<SparseIndex>>(
+                ref.innerIndexPtr(), ref.innerIndexPtr() + ref.nonZeros());
 
-        std::memcpy(outerIndexPtr.data(), ref.outerIndexPtr(),
-                    sizeof(SparseIndex) * outerIndexPtr.size());
-        std::memcpy(innerIndexPtr.data(), ref.innerIndexPtr(),
-                    sizeof(SparseIndex) * innerIndexPtr.size());
+        b = b_;
+    }
 
+    template<typename dtype>
+    ProjectionOmega<dtype>::ProjectionOmega(const SharedSpMat<dtype>& ref,
+                                            const Ref<const mat_t>    b_)
+        : outerIndexPtr(ref.outer_index()), innerIndexPtr(ref.inner_index()) {
         b = b_;
     }
 
     template<typename dtype>
     Scalar ProjectionOmega<dtype>::operator()(const Ref<const mat_t> x, Ref<mat_t> y, bool compute_grad){
+        OPTSUITE_PROFILE_SCOPE("ProjectionOmega");
         // compute r = P(x)
         projection(x);
         r -= b;
@@ -438,8 +1574,8 @@ namespace OptSuite { namespace Base {
 
         if (compute_grad){
             // note: the gradient is sparse, convert it to dense
-            y = mat_t(Map<spmat_t>(x.rows(), x.cols(), r.size(),
-                        outerIndexPtr.data(), innerIndexPtr.data(), r.data()));
+            y = mat_t(Map<const spmat_t>(x.rows(), x.cols(), r.size(),
+                        outerIndexPtr->data(), innerIndexPtr->data(), r.data()));
         }
 
         return fun;
@@ -447,15 +1583,17 @@ namespace OptSuite { namespace Base {
 
     template<typename dtype>
     Scalar ProjectionOmega<dtype>::operator()(const var_t& x, var_t& y, bool compute_grad){
-        const MatWrapper<dtype>* x_ptr = dynamic_cast<const MatWrapper<dtype>*>(&x);
-        const fmat_t* x_ptr_f = dynamic_cast<const fmat_t*>(&x);
-        MatWrapper<dtype>* y_ptr = dynamic_cast<MatWrapper<dtype>*>(&y);
-        SpMatWrapper<dtype>* y_ptr_s = dynamic_cast<SpMatWrapper<dtype>*>(&y);
+        OPTSUITE_PROFILE_SCOPE("ProjectionOmega");
+        const MatWrapper<dtype>* x_ptr = variable_cast<MatWrapper<dtype>>(&x);
+        const fmat_t* x_ptr_f = variable_cast<fmat_t>(&x);
+        MatWrapper<dtype>* y_ptr = variable_cast<MatWrapper<dtype>>(&y);
+        SpMatWrapper<dtype>* y_ptr_s = variable_cast<SpMatWrapper<dtype>>(&y);
+        SharedSpMat<dtype>* y_ptr_ss = variable_cast<SharedSpMat<dtype>>(&y);
         Index m, n;
 
         if (x_ptr && y_ptr) // dense x + dense y
             return (*this)(x_ptr->mat(), y_ptr->mat(), compute_grad);
-        else if ((x_ptr_f || x_ptr) && (!compute_grad || y_ptr_s)) { // dense/factorized x + sparse y
+        else if ((x_ptr_f || x_ptr) && (!compute_grad || y_ptr_s || y_ptr_ss)) { // dense/factorized x + sparse y
             // compute r = P(x)
             if (x_ptr){ // dense
                 m = x_ptr->mat().rows();
@@ -472,11 +1610,17 @@ namespace OptSuite { namespace Base {
 
             // compute gradient
             // note: the gradient is sparse
-            if (compute_grad){
+            if (compute_grad && y_ptr_ss){
+                // share the pattern instead of copying it
+                if (y_ptr_ss->outer_index() != outerIndexPtr ||
+                        y_ptr_ss->inner_index() != innerIndexPtr || y_ptr_ss->rows() != m)
+                    y_ptr_ss->set_pattern(m, outerIndexPtr, innerIndexPtr);
+                y_ptr_ss->values() = r.col(0);
+            } else if (compute_grad){
                 // if y_ptr_s isn't initialized, set zeros as default
                 if (y_ptr_s->spmat().nonZeros() != b.rows())
                     y_ptr_s->set_zero_like(m, n, r.rows(),
-                            outerIndexPtr.data(), innerIndexPtr.data());
+                            outerIndexPtr->data(), innerIndexPtr->data());
 
                 std::memcpy(y_ptr_s->spmat().valuePtr(), r.data(), r.rows() * sizeof(dtype));
             }
@@ -490,11 +1634,11 @@ namespace OptSuite { namespace Base {
     template<typename dtype>
     void ProjectionOmega<dtype>::projection(const Ref<const mat_t> x) {
         r.resize(b.rows(), 1);
-        SparseIndex *outer_ptr = outerIndexPtr.data();
-        SparseIndex *inner_ptr = innerIndexPtr.data();
+        const SparseIndex *outer_ptr = outerIndexPtr->data();
+        const SparseIndex *inner_ptr = innerIndexPtr->data();
         Scalar *     r_ptr     = r.data();
 
-        for (size_t i = 0; i < outerIndexPtr.size() - 1; ++i) {
+        for (size_t i = 0; i < outerIndexPtr->size() - 1; ++i) {
             for (Index j = outer_ptr[i]; j < outer_ptr[i + 1]; ++j) {
                 *r_ptr++ = x(inner_ptr[j], i);   // for colmajor
             }
@@ -504,11 +1648,11 @@ namespace OptSuite { namespace Base {
     template<typename dtype>
     void ProjectionOmega<dtype>::projection(const fmat_t& x){
         r.resize(b.rows(), 1);
-        SparseIndex *outer_ptr = outerIndexPtr.data();
-        SparseIndex *inner_ptr = innerIndexPtr.data();
+        const SparseIndex *outer_ptr = outerIndexPtr->data();
+        const SparseIndex *inner_ptr = innerIndexPtr->data();
         Scalar *r_ptr = r.data();
 
-        for (size_t i = 0; i < outerIndexPtr.size() - 1; ++i){
+        for (size_t i = 0; i < outerIndexPtr->size() - 1; ++i){
             for (Index j = outer_ptr[i]; j < outer_ptr[i+1]; ++j){
                 *r_ptr++ = x.U().row(inner_ptr[j]).dot(x.V().row(i));
             }
@@ -0,0 +1,111 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  group_index.cpp
+ *
+ *    Description:
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 10:52:03 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <algorithm>
+#include <numeric>
+#include "OptSuite/Base/group_index.h"
+
+namespace OptSuite { namespace Base {
+    GroupIndex::GroupIndex(Index dim, std::vector<Index> ptr, std::vector<Index> idx)
+        : dim_(dim), ptr_(std::move(ptr)), idx_(std::move(idx)) {
+        init();
+    }
+
+    GroupIndex::GroupIndex(Index dim, const std::vector<std::vector<Index>>& groups) : dim_(dim) {
+        for (const auto& group : groups){
+            idx_.insert(idx_.end(), group.begin(), group.end());
+            ptr_.push_back(static_cast<Index>(idx_.size()));
+        }
+        init();
+    }
+
+    GroupIndex GroupIndex::from_labels(const std::vector<Index>& labels){
+        Index n = static_cast<Index>(labels.size());
+        Index num_groups = 0;
+        for (Index l : labels)
+            num_groups = std::max(num_groups, l + 1);
+        // counting sort of the rows by label
+        std::vector<Index> ptr(num_groups + 1, 0), idx;
+        for (Index l : labels)
+            if (l >= 0) ++ptr[l + 1];
+        std::partial_sum(ptr.begin(), ptr.end(), ptr.begin());
+        idx.resize(ptr.back());
+        std::vector<Index> next(ptr.begin(), ptr.end() - 1);
+        for (Index i = 0; i < n; ++i)
+            if (labels[i] >= 0) idx[next[labels[i]]++] = i;
+        return GroupIndex(n, std::move(ptr), std::move(idx));
+    }
+
+    void GroupIndex::init(){
+        OPTSUITE_ASSERT(!ptr_.empty() && ptr_.front() == 0 && ptr_.back() == latent_dim());
+        std::vector<Index> count(dim_, 0);
+        for (Index g = 0; g < num_groups(); ++g){
+            OPTSUITE_ASSERT(ptr_[g] <= ptr_[g + 1]);
+            for (Index k = ptr_[g]; k < ptr_[g + 1]; ++k){
+                OPTSUITE_ASSERT(idx_[k] >= 0 && idx_[k] < dim_);
+                ++count[idx_[k]];
+                if (k > ptr_[g] && idx_[k] != idx_[k - 1] + 1)
+                    contiguous_ = false;
+            }
+        }
+        overlapping_ = std::any_of(count.begin(), count.end(), [](Index c){ return c > 1; });
+        covering_    = std::none_of(count.begin(), count.end(), [](Index c){ return c == 0; });
+    }
+
+    std::vector<Index> GroupIndex::chunks(Size grain, Index cols) const {
+        std::vector<Index> c(1, 0);
+        Size acc = 0;
+        for (Index g = 0; g < num_groups(); ++g){
+            acc += size(g) * cols;
+            if (acc >= grain && g + 1 < num_groups()){
+                c.push_back(g + 1);
+                acc = 0;
+            }
+        }
+        if (num_groups() > 0)
+            c.push_back(num_groups());
+        return c;
+    }
+
+    GroupIndex GroupIndex::latent() const {
+        std::vector<Index> idx(latent_dim());
+        std::iota(idx.begin(), idx.end(), Index(0));
+        return GroupIndex(latent_dim(), ptr_, std::move(idx));
+    }
+
+    void GroupIndex::duplicate(const Ref<const Mat> x, Ref<Mat> v) const {
+        OPTSUITE_ASSERT(x.rows() == dim_ && v.rows() == latent_dim() && v.cols() == x.cols());
+        for (Index k = 0; k < latent_dim(); ++k)
+            v.row(k) = x.row(idx_[k]);
+    }
+
+    void GroupIndex::collapse(const Ref<const Mat> v, Ref<Mat> x) const {
+        OPTSUITE_ASSERT(x.rows() == dim_ && v.rows() == latent_dim() && v.cols() == x.cols());
+        x.setZero();
+        for (Index k = 0; k < latent_dim(); ++k)
+            x.row(idx_[k]) += v.row(k);
+    }
+
+    Mat GroupIndex::duplicate_columns(const Ref<const Mat> A) const {
+        OPTSUITE_ASSERT(A.cols() == dim_);
+        Mat AD(A.rows(), latent_dim());
+        for (Index k = 0; k < latent_dim(); ++k)
+            AD.col(k) = A.col(idx_[k]);
+        return AD;
+    }
+}}
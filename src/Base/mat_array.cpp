@@ -17,146 +17,267 @@
  * ===========================================================================
  */
 
+#include <algorithm>
 #include "OptSuite/core_n.h"
 #include "OptSuite/Base/mat_array.h"
 
 namespace OptSuite { namespace Base {
     template<typename dtype>
-    MatArray_t<dtype>::MatArray_t(const MatArray_t<dtype>& other){
-        this->_offset = other._offset;
-        this->_block_info = other._block_info;
+    MatArray_t<dtype>::Layout::Layout(Size align_bytes) {
+        if (align_bytes == 0)
+            return;
+        OPTSUITE_ASSERT(align_bytes % sizeof(dtype) == 0 &&
+                OPTSUITE_MAT_ARRAY_ALIGN % align_bytes == 0);
+        _align = align_bytes / sizeof(dtype);
+    }
+
+    template<typename dtype>
+    typename MatArray_t<dtype>::Layout& MatArray_t<dtype>::Layout::add_blocks(Size m, Size n, Size count) {
+        for (Index i = 0; i < count; ++i){
+            Index off = (_storage + _align - 1) / _align * _align;
+            _offset.push_back(off);
+            _block_info.push_back(std::pair<Size,Size>(m, n));
+            _storage = off + m * n;
+            _size += m * n;
+        }
+        return *this;
+    }
+
+    template<typename dtype>
+    void MatArray_t<dtype>::Layout::reserve(Size blocks) {
+        _offset.reserve(blocks);
+        _block_info.reserve(blocks);
+    }
+
+    template<typename dtype>
+    std::vector<Index> MatArray_t<dtype>::Layout::chunks(Size grain) const {
+        std::vector<Index> c(1, 0);
+        Size acc = 0;
+        for (Index i = 0; i < total_blocks(); ++i){
+            acc += _block_info[i].first * _block_info[i].second;
+            if (acc >= grain && i + 1 < total_blocks()){
+                c.push_back(i + 1);
+                acc = 0;
+            }
+        }
+        if (total_blocks() > 0)
+            c.push_back(total_blocks());
+        return c;
+    }
+
+    template<typename dtype>
+    bool MatArray_t<dtype>::Layout::operator==(const Layout& other) const {
+        return _storage == other._storage &&
+               _block_info == other._block_info &&
+               _offset == other._offset;
+    }
+
+    template<typename dtype>
+    MatArray_t<dtype>::MatArray_t(const Layout& layout) : Variable<dtype>(VariableKind::Array) {
+        set_layout(layout);
+    }
+
+    template<typename dtype>
+    MatArray_t<dtype>::MatArray_t(const MatArray_t<dtype>& other) : Variable<dtype>(VariableKind::Array) {
+        this->_layout = other._layout;
         this->_data = other._data;
+        update_blocks_it(0);
+    }
+
+    template<typename dtype>
+    MatArray_t<dtype>::MatArray_t(MatArray_t<dtype>&& other) : Variable<dtype>(VariableKind::Array) {
+        // the buffer is moved, so are the maps into it. other is left empty.
+        this->_layout.swap(other._layout);
+        this->_data.swap(other._data);
+        this->_blocks_it.swap(other._blocks_it);
     }
 
     template<typename dtype>
     MatArray_t<dtype>& MatArray_t<dtype>::operator=(const MatArray_t<dtype>& other){
-        this->_offset = other._offset;
-        this->_block_info = other._block_info;
+        if (this == &other)
+            return *this;
+        if (same_layout(other)){
+            // the maps stay valid
+            this->_layout = other._layout;
+            std::copy(other._data.begin(), other._data.end(), this->_data.begin());
+            return *this;
+        }
+        this->_layout = other._layout;
         this->_data = other._data;
+        update_blocks_it(0);
+        return *this;
+    }
+
+    template<typename dtype>
+    MatArray_t<dtype>& MatArray_t<dtype>::operator=(MatArray_t<dtype>&& other){
+        this->_layout.swap(other._layout);
+        this->_data.swap(other._data);
+        this->_blocks_it.swap(other._blocks_it);
         return *this;
     }
 
     template<typename dtype>
     Variable<dtype>& MatArray_t<dtype>::operator=(const Variable<dtype>& other){
-        const MatArray_t<dtype>* other_ptr = dynamic_cast<const MatArray_t<dtype>*>(&other);
+        const MatArray_t<dtype>* other_ptr = variable_cast<MatArray_t<dtype>>(&other);
         OPTSUITE_ASSERT(other_ptr);
         return this->operator=(*other_ptr);
     }
 
     template<typename dtype>
     void MatArray_t<dtype>::add_blocks(Size m, Size n, Size count) {
-        this->_blocks_it.clear();
-        for (int i = 0; i < count; ++i){
-            this->_offset.push_back(total_size());
-            this->_data.resize(total_size() + m * n, 0);
-            this->_block_info.push_back(std::pair<Size,Size>(m, n));
-        }
+        Index first = total_blocks();
+        const dtype* old_data = this->_data.data();
+        // copy on write
+        if (this->_layout.use_count() > 1)
+            this->_layout = std::make_shared<Layout>(*this->_layout);
+        this->_layout->add_blocks(m, n, count);
+
+        // grow the buffer geometrically so that adding blocks one by one
+        // costs amortized O(1) copies per entry
+        Size s = this->_layout->storage_size();
+        if (static_cast<size_t>(s) > this->_data.capacity())
+            this->_data.reserve(std::max(static_cast<size_t>(s), 2 * this->_data.capacity()));
+        this->_data.resize(s, dtype(0));
+
+        // the maps of the old blocks are still valid unless the buffer moved
+        update_blocks_it(this->_data.data() == old_data ? first : 0);
     }
 
     template<typename dtype>
     void MatArray_t<dtype>::reserve(Size s){
+        const dtype* old_data = this->_data.data();
         this->_data.reserve(s);
+        if (this->_data.data() != old_data)
+            update_blocks_it(0);
     }
 
     template<typename dtype>
-    void MatArray_t<dtype>::gen_blocks_it() const {
-        if (!_blocks_it.empty())
-            return;
-        for (int i = 0; i < total_blocks(); ++i){
-            _blocks_it.push_back((*this)[i]);
-        }
+    void MatArray_t<dtype>::set_layout(const Layout& layout){
+        this->_layout = std::make_shared<Layout>(layout);
+        allocate();
+    }
+
+    template<typename dtype>
+    void MatArray_t<dtype>::allocate(){
+        // one allocation for all blocks
+        this->_data.clear();
+        this->_data.resize(this->_layout->storage_size(), dtype(0));
+        update_blocks_it(0);
+    }
+
+    template<typename dtype>
+    void MatArray_t<dtype>::update_blocks_it(Index first){
+        if (first == 0)
+            this->_blocks_it.clear();
+        this->_blocks_it.reserve(total_blocks());
+        for (Index i = first; i < total_blocks(); ++i)
+            this->_blocks_it.push_back(Map<const mat_t>(this->_data.data() + _layout->offset(i),
+                        _layout->rows(i), _layout->cols(i)));
+    }
+
+    template<typename dtype>
+    bool MatArray_t<dtype>::same_layout(const MatArray_t<dtype>& other) const {
+        return this->_layout == other._layout || *this->_layout == *other._layout;
     }
 
     template<typename dtype>
     Size MatArray_t<dtype>::total_size() const {
-        return this->_data.size();
+        return this->_layout->total_size();
      }
 
     template<typename dtype>
     Size MatArray_t<dtype>::total_blocks() const {
-        return this->_block_info.size();
+        return this->_layout->total_blocks();
     }
 
     template<typename dtype>
     Map<typename MatArray_t<dtype>::vec_t> MatArray_t<dtype>::vec() {
         OPTSUITE_ASSERT(total_size() > 0);
+        OPTSUITE_ASSERT_MSG(!_layout->padded(), "vec() of a padded MatArray");
         return Map<vec_t>(_data.data(), total_size(), 1);
     }
 
     template<typename dtype>
     Map<const typename MatArray_t<dtype>::vec_t> MatArray_t<dtype>::vec() const {
         OPTSUITE_ASSERT(total_size() > 0);
+        OPTSUITE_ASSERT_MSG(!_layout->padded(), "vec() of a padded MatArray");
         return Map<const vec_t>(_data.data(), total_size(), 1);
     }
 
     template<typename dtype>
     Map<typename MatArray_t<dtype>::mat_t> MatArray_t<dtype>::operator[](Index ind) {
-        Index off = _offset[ind];
-        return Map<mat_t>(_data.data() + off, _block_info[ind].first,
-                _block_info[ind].second);
+        return Map<mat_t>(_data.data() + _layout->offset(ind), _layout->rows(ind),
+                _layout->cols(ind));
     }
 
     template<typename dtype>
     Map<const typename MatArray_t<dtype>::mat_t> MatArray_t<dtype>::operator[](Index ind) const {
-        Index off = _offset[ind];
-        return Map<const mat_t>(_data.data() + off, _block_info[ind].first,
-                _block_info[ind].second);
+        return Map<const mat_t>(_data.data() + _layout->offset(ind), _layout->rows(ind),
+                _layout->cols(ind));
     }
 
     template<typename dtype>
     typename MatArray_t<dtype>::iterator MatArray_t<dtype>::begin() const {
-        gen_blocks_it();
         return _blocks_it.cbegin();
     }
 
     template<typename dtype>
     typename MatArray_t<dtype>::iterator MatArray_t<dtype>::end() const {
-        gen_blocks_it();
         return _blocks_it.cend();
     }
 
+    // the reductions below run over the whole buffer, the padding is zero
+
     template<typename dtype>
     Scalar MatArray_t<dtype>::squaredNorm() const {
-        return this->vec().squaredNorm();
+        return Map<const vec_t>(_data.data(), storage_size()).squaredNorm();
     }
 
     template<typename dtype>
     Scalar MatArray_t<dtype>::norm() const {
-        return this->vec().norm();
+        return Map<const vec_t>(_data.data(), storage_size()).norm();
     }
 
     template<typename dtype>
     dtype MatArray_t<dtype>::dot(const MatArray_t<dtype>& other) const {
-        return this->vec().dot(other.vec());
+        OPTSUITE_ASSERT(storage_size() == other.storage_size());
+        return Map<const vec_t>(_data.data(), storage_size()).dot(
+                Map<const vec_t>(other._data.data(), storage_size()));
     }
 
     template<typename dtype>
     dtype MatArray_t<dtype>::dot(const Variable<dtype>& other) const {
-        const MatArray_t<dtype>* other_ptr = dynamic_cast<const MatArray_t<dtype>*>(&other);
+        const MatArray_t<dtype>* other_ptr = variable_cast<MatArray_t<dtype>>(&other);
         OPTSUITE_ASSERT(other_ptr);
         return this->dot(*other_ptr);
     }
 
     template<typename dtype>
     Scalar MatArray_t<dtype>::squared_norm_diff(const Variable<dtype>& other) const {
-        const MatArray_t<dtype>* other_ptr = dynamic_cast<const MatArray_t<dtype>*>(&other);
+        const MatArray_t<dtype>* other_ptr = variable_cast<MatArray_t<dtype>>(&other);
         OPTSUITE_ASSERT(other_ptr);
-        return (this->vec() - other_ptr->vec()).squaredNorm();
+        OPTSUITE_ASSERT(storage_size() == other_ptr->storage_size());
+        return (Map<const vec_t>(_data.data(), storage_size()) -
+                Map<const vec_t>(other_ptr->_data.data(), storage_size())).squaredNorm();
     }
 
     template<typename dtype>
     void MatArray_t<dtype>::set_zero_like(const Variable<dtype>& other){
-        const MatArray_t<dtype>* other_ptr = dynamic_cast<const MatArray_t<dtype>*>(&other);
+        const MatArray_t<dtype>* other_ptr = variable_cast<MatArray_t<dtype>>(&other);
         OPTSUITE_ASSERT(other_ptr);
-        *this = MatArray_t<dtype>::zeros_like(*other_ptr);
+        if (same_layout(*other_ptr))
+            std::fill(this->_data.begin(), this->_data.end(), dtype(0));
+        else {
+            this->_layout = other_ptr->_layout;
+            allocate();
+        }
     }
 
     template<typename dtype>
     MatArray_t<dtype> MatArray_t<dtype>::zeros_like(const MatArray_t<dtype>& other){
         MatArray_t<dtype> tmp;
-        tmp._block_info = other._block_info;
-        tmp._offset = other._offset;
-        tmp._data.resize(other.total_size(), 0);
+        tmp._layout = other._layout;
+        tmp.allocate();
         return tmp;
     }
 
@@ -164,7 +285,16 @@ namespace OptSuite { namespace Base {
     MatArray_t<dtype> MatArray_t<dtype>::from_vec_like(const Ref<const vec_t> v, const MatArray_t<dtype>& bv){
         OPTSUITE_ASSERT(bv.total_size() == v.size());
         MatArray_t<dtype> tmp = MatArray_t<dtype>::zeros_like(bv);
-        tmp.vec() = v;
+        if (!bv._layout->padded()){
+            tmp.vec() = v;
+            return tmp;
+        }
+        Index pos = 0;
+        for (Index i = 0; i < tmp.total_blocks(); ++i){
+            Map<mat_t> blk = tmp[i];
+            blk = Map<const mat_t>(v.data() + pos, blk.rows(), blk.cols());
+            pos += blk.size();
+        }
         return tmp;
     }
 
@@ -0,0 +1,79 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  screening.cpp
+ *
+ *    Description:
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 08:14:52 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "OptSuite/Base/screening.h"
+
+namespace OptSuite { namespace Base {
+    GapSafeScreening::GapSafeScreening(Vec col_norms, const Ref<const Mat> b,
+                                       PenaltyGroups groups, Scalar mu)
+        : col_norms_(std::move(col_norms)), b_(b), groups_(groups), mu_(mu) {
+        OPTSUITE_ASSERT(groups != PenaltyGroups::None && mu > 0);
+    }
+
+    Scalar GapSafeScreening::group_norm(const Ref<const Mat> x, Index j) const {
+        return groups_ == PenaltyGroups::Entries ? x.row(j).lpNorm<1>() : x.row(j).norm();
+    }
+
+    Scalar GapSafeScreening::dual_norm(const Ref<const Mat> g, Index j) const {
+        return groups_ == PenaltyGroups::Entries ? g.row(j).lpNorm<Eigen::Infinity>()
+                                                 : g.row(j).norm();
+    }
+
+    Scalar GapSafeScreening::dual_scale(const Ref<const Mat> g,
+                                        const std::vector<Index>& active) const {
+        Scalar s = mu_;
+        for (Index j : active)
+            s = std::max(s, dual_norm(g, j));
+        return s;
+    }
+
+    Scalar GapSafeScreening::gap(const Ref<const Mat> x, Scalar r_sqr, Scalar b_r, Scalar s,
+                                 const std::vector<Index>& active) const {
+        Scalar h = 0;
+        for (Index j : active)
+            h += group_norm(x, j);
+        Scalar primal = 0.5_s * r_sqr + mu_ * h;
+        // D(theta) = 0.5 ||b||^2 - 0.5 ||b - mu theta||^2 with theta = -r / s
+        Scalar k = mu_ / s;
+        Scalar dual = -k * b_r - 0.5_s * k * k * r_sqr;
+        return std::max(primal - dual, 0_s);
+    }
+
+    Scalar GapSafeScreening::gap(const Ref<const Mat> x, const Ref<const Mat> r,
+                                 const Ref<const Mat> g, const std::vector<Index>& active) const {
+        return gap(x, r.squaredNorm(), b_.cwiseProduct(r).sum(), dual_scale(g, active), active);
+    }
+
+    Scalar GapSafeScreening::operator()(const Ref<const Mat> x, const Ref<const Mat> r,
+                                        const Ref<const Mat> g, std::vector<Index>& active){
+        return (*this)(x, r.squaredNorm(), b_.cwiseProduct(r).sum(), g, active);
+    }
+
+    Scalar GapSafeScreening::operator()(const Ref<const Mat> x, Scalar r_sqr, Scalar b_r,
+                                        const Ref<const Mat> g, std::vector<Index>& active){
+        Scalar s = dual_scale(g, active);
+        Scalar gap = this->gap(x, r_sqr, b_r, s, active);
+        Scalar radius = std::sqrt(2 * gap) / mu_;
+        active.erase(std::remove_if(active.begin(), active.end(), [&](Index j){
+            return dual_norm(g, j) / s + radius * col_norms_[j] < 1;
+        }), active.end());
+        return gap;
+    }
+}}
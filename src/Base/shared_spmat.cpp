@@ -17,8 +17,256 @@
  * ===========================================================================
  */
 
+#include <algorithm>
 #include "OptSuite/Base/shared_spmat.h"
 
 namespace OptSuite { namespace Base {
-    
+    template<typename dtype>
+    SharedSpMat<dtype>::SharedSpMat() : SharedSpMat(0, 0) {}
+
+    template<typename dtype>
+    SharedSpMat<dtype>::SharedSpMat(Index m, Index n) : Variable<dtype>(VariableKind::SharedSparse) {
+        resize(m, n);
+    }
+
+    template<typename dtype>
+    SharedSpMat<dtype>::SharedSpMat(const spmat_t& A) : Variable<dtype>(VariableKind::SharedSparse) {
+        spmat_t B;
+        const spmat_t* src = &A;
+        if (!A.isCompressed()){
+            B = A;
+            B.makeCompressed();
+            src = &B;
+        }
+        Index n = src->cols(), nnz = src->nonZeros();
+        rows_ = src->rows();
+        outer_ = std::make_shared<std::vector<SparseIndex>>(
+                src->outerIndexPtr(), src->outerIndexPtr() + n + 1);
+        inner_ = std::make_shared<std::vector<SparseIndex>>(
+                src->innerIndexPtr(), src->innerIndexPtr() + nnz);
+        data_.assign(src->valuePtr(), src->valuePtr() + nnz);
+    }
+
+    template<typename dtype>
+    SharedSpMat<dtype>::SharedSpMat(Index m, index_ptr_t outer, index_ptr_t inner)
+        : Variable<dtype>(VariableKind::SharedSparse) {
+        set_pattern(m, std::move(outer), std::move(inner));
+    }
+
+    template<typename dtype>
+    SharedSpMat<dtype>& SharedSpMat<dtype>::operator=(const SharedSpMat<dtype>& other){
+        if (this == &other)
+            return *this;
+        rows_ = other.rows_;
+        outer_ = other.outer_;
+        inner_ = other.inner_;
+        data_ = other.data_;
+        return *this;
+    }
+
+    template<typename dtype>
+    Variable<dtype>& SharedSpMat<dtype>::operator=(const Variable<dtype>& other){
+        const SharedSpMat* other_ptr = variable_cast<SharedSpMat>(&other);
+        OPTSUITE_ASSERT(other_ptr);
+        return *this = *other_ptr;
+    }
+
+    template<typename dtype>
+    Index SharedSpMat<dtype>::rows() const {
+        return rows_;
+    }
+
+    template<typename dtype>
+    Index SharedSpMat<dtype>::cols() const {
+        return outer_->size() - 1;
+    }
+
+    template<typename dtype>
+    Index SharedSpMat<dtype>::nonZeros() const {
+        return data_.size();
+    }
+
+    template<typename dtype>
+    void SharedSpMat<dtype>::resize(Index m, Index n){
+        rows_ = m;
+        outer_ = std::make_shared<std::vector<SparseIndex>>(n + 1, 0);
+        inner_ = std::make_shared<std::vector<SparseIndex>>();
+        data_.clear();
+    }
+
+    template<typename dtype>
+    void SharedSpMat<dtype>::reserve(Index nnz){
+        own_inner().resize(nnz);
+        data_.resize(nnz, dtype(0));
+    }
+
+    template<typename dtype>
+    void SharedSpMat<dtype>::set_pattern(Index m, index_ptr_t outer, index_ptr_t inner){
+        OPTSUITE_ASSERT(outer && inner && !outer->empty());
+        OPTSUITE_ASSERT(static_cast<size_t>(outer->back()) == inner->size());
+        rows_ = m;
+        outer_ = std::move(outer);
+        inner_ = std::move(inner);
+        data_.assign(inner_->size(), dtype(0));
+    }
+
+    template<typename dtype>
+    bool SharedSpMat<dtype>::same_pattern(const SharedSpMat<dtype>& other) const {
+        if (rows_ != other.rows_)
+            return false;
+        if (outer_ == other.outer_ && inner_ == other.inner_)
+            return true;
+        return *outer_ == *other.outer_ && *inner_ == *other.inner_;
+    }
+
+    template<typename dtype>
+    std::vector<SparseIndex>& SharedSpMat<dtype>::own_outer(){
+        if (outer_.use_count() > 1)
+            outer_ = std::make_shared<std::vector<SparseIndex>>(*outer_);
+        return const_cast<std::vector<SparseIndex>&>(*outer_);
+    }
+
+    template<typename dtype>
+    std::vector<SparseIndex>& SharedSpMat<dtype>::own_inner(){
+        if (inner_.use_count() > 1)
+            inner_ = std::make_shared<std::vector<SparseIndex>>(*inner_);
+        return const_cast<std::vector<SparseIndex>&>(*inner_);
+    }
+
+    template<typename dtype>
+    const SparseIndex* SharedSpMat<dtype>::outerIndexPtr() const {
+        return outer_->data();
+    }
+
+    template<typename dtype>
+    SparseIndex* SharedSpMat<dtype>::outerIndexPtr(){
+        return own_outer().data();
+    }
+
+    template<typename dtype>
+    const SparseIndex* SharedSpMat<dtype>::innerIndexPtr() const {
+        return inner_->data();
+    }
+
+    template<typename dtype>
+    SparseIndex* SharedSpMat<dtype>::innerIndexPtr(){
+        return own_inner().data();
+    }
+
+    template<typename dtype>
+    const dtype* SharedSpMat<dtype>::valuePtr() const {
+        return data_.data();
+    }
+
+    template<typename dtype>
+    dtype* SharedSpMat<dtype>::valuePtr(){
+        return data_.data();
+    }
+
+    template<typename dtype>
+    Map<const typename SharedSpMat<dtype>::vec_t> SharedSpMat<dtype>::values() const {
+        return Map<const vec_t>(data_.data(), data_.size());
+    }
+
+    template<typename dtype>
+    Map<typename SharedSpMat<dtype>::vec_t> SharedSpMat<dtype>::values(){
+        return Map<vec_t>(data_.data(), data_.size());
+    }
+
+    template<typename dtype>
+    Map<const typename SharedSpMat<dtype>::spmat_t> SharedSpMat<dtype>::spmat() const {
+        return Map<const spmat_t>(rows(), cols(), nonZeros(), outer_->data(),
+                inner_->data(), data_.data());
+    }
+
+    template<typename dtype>
+    dtype SharedSpMat<dtype>::dot(const SharedSpMat<dtype>& other) const {
+        if (same_pattern(other))
+            return values().dot(other.values());
+        return spmat().conjugate().cwiseProduct(other.spmat()).sum();
+    }
+
+    template<typename dtype>
+    dtype SharedSpMat<dtype>::dot(const MatWrapper<dtype>& other) const {
+        OPTSUITE_ASSERT(other.mat().rows() == rows() && other.mat().cols() == cols());
+        const SparseIndex* outer = outer_->data();
+        const SparseIndex* inner = inner_->data();
+        dtype r = dtype(0);
+        for (Index j = 0; j < cols(); ++j)
+            for (Index k = outer[j]; k < outer[j + 1]; ++k)
+                r += Eigen::numext::conj(data_[k]) * other.mat()(inner[k], j);
+        return r;
+    }
+
+    template<typename dtype>
+    dtype SharedSpMat<dtype>::dot(const SpMatWrapper<dtype>& other) const {
+        return spmat().conjugate().cwiseProduct(other.spmat()).sum();
+    }
+
+    template<typename dtype>
+    dtype SharedSpMat<dtype>::dot(const FactorizedMat<dtype>& other) const {
+        // (UV')_ij on the pattern only
+        OPTSUITE_ASSERT(other.rows() == rows() && other.cols() == cols());
+        const SparseIndex* outer = outer_->data();
+        const SparseIndex* inner = inner_->data();
+        dtype r = dtype(0);
+        for (Index j = 0; j < cols(); ++j)
+            for (Index k = outer[j]; k < outer[j + 1]; ++k)
+                r += Eigen::numext::conj(data_[k]) *
+                    other.U().row(inner[k]).cwiseProduct(other.V().row(j)).sum();
+        return r;
+    }
+
+    template<typename dtype>
+    dtype SharedSpMat<dtype>::dot(const Variable<dtype>& other) const {
+        switch (other.kind()){
+            case VariableKind::SharedSparse:
+                return this->dot(static_cast<const SharedSpMat&>(other));
+            case VariableKind::Dense:
+                return this->dot(static_cast<const MatWrapper<dtype>&>(other));
+            case VariableKind::Sparse:
+                return this->dot(static_cast<const SpMatWrapper<dtype>&>(other));
+            case VariableKind::Factorized:
+                return this->dot(static_cast<const FactorizedMat<dtype>&>(other));
+            default:
+                OPTSUITE_ASSERT(false);
+                return dtype(0);
+        }
+    }
+
+    template<typename dtype>
+    Scalar SharedSpMat<dtype>::squaredNorm() const {
+        return values().squaredNorm();
+    }
+
+    template<typename dtype>
+    Scalar SharedSpMat<dtype>::norm() const {
+        return values().norm();
+    }
+
+    template<typename dtype>
+    void SharedSpMat<dtype>::set_zero_like(const Variable<dtype>& other){
+        const SharedSpMat* other_ptr = variable_cast<SharedSpMat>(&other);
+        OPTSUITE_ASSERT(other_ptr);
+        if (same_pattern(*other_ptr)){
+            std::fill(data_.begin(), data_.end(), dtype(0));
+            // adopt the pointers so that later comparisons are cheap
+            outer_ = other_ptr->outer_;
+            inner_ = other_ptr->inner_;
+        } else
+            set_pattern(other_ptr->rows_, other_ptr->outer_, other_ptr->inner_);
+    }
+
+    template<typename dtype>
+    Scalar SharedSpMat<dtype>::squared_norm_diff(const Variable<dtype>& other) const {
+        const SharedSpMat* other_ptr = variable_cast<SharedSpMat>(&other);
+        OPTSUITE_ASSERT(other_ptr);
+        if (same_pattern(*other_ptr))
+            return (values() - other_ptr->values()).squaredNorm();
+        return (spmat() - other_ptr->spmat()).squaredNorm();
+    }
+
+    // template instantiation
+    template class SharedSpMat<Scalar>;
+    template class SharedSpMat<ComplexScalar>;
 }}
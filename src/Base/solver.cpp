@@ -16,14 +16,160 @@
  * ==========================================================================
  */
 
+#include "OptSuite/Base/mat_op.h"
+#include "OptSuite/Base/screening.h"
 #include "OptSuite/Base/solver.h"
+#include "OptSuite/Base/var_expr.h"
 #include "OptSuite/Utils/logger.h"
+#include "OptSuite/Utils/profiler.h"
 #include "OptSuite/Utils/stopwatch.hpp"
+#include "OptSuite/Utils/thread_pool.h"
 #include "OptSuite/core_n.h"
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
+#include <numeric>
+#include <random>
 
 namespace OptSuite {
 namespace Base {
+namespace {
+// true once the relative change of the objective stays below ftol for
+// min_lasting_iters consecutive records
+class ObjStopChecker {
+public:
+    ObjStopChecker(Scalar ftol, Index min_lasting_iters)
+        : ftol_(ftol), min_lasting_iters_(min_lasting_iters) {}
+    bool operator()(const std::vector<Scalar> &obj_hist) {
+        Index size = obj_hist.size();
+        if (size < 2) { return false; }
+        if (std::fabs(obj_hist[size - 1] - obj_hist[size - 2]) / obj_hist[size - 2] < ftol_) {
+            lasting_iters_++;
+        } else {
+            lasting_iters_ = 0;
+        }
+        return lasting_iters_ >= min_lasting_iters_;
+    }
+
+private:
+    Scalar ftol_;
+    Index  min_lasting_iters_;
+    Index  lasting_iters_ = 0;
+};
+
+// operations on the column j of a dense or a sparse matrix
+inline Scalar col_dot(const Mat &A, Index j, const Vec &v) { return A.col(j).dot(v); }
+inline Scalar col_dot(const SpMat &A, Index j, const Vec &v) {
+    Scalar s = 0;
+    for (SpMat::InnerIterator it(A, j); it; ++it) s += it.value() * v[it.index()];
+    return s;
+}
+
+// v += alpha * A_j
+inline void col_axpy(const Mat &A, Index j, Scalar alpha, Vec &v) { v.noalias() += alpha * A.col(j); }
+inline void col_axpy(const SpMat &A, Index j, Scalar alpha, Vec &v) {
+    for (SpMat::InnerIterator it(A, j); it; ++it) v[it.index()] += alpha * it.value();
+}
+
+// c = A' A_j
+template <typename MatType>
+inline void gram_col(const MatType &A, Index j, Vec &c) {
+    Vec aj = A.col(j);
+    c.noalias() = A.transpose() * aj;
+}
+
+inline Vec col_sqnorms(const Mat &A) { return A.colwise().squaredNorm().transpose(); }
+inline Vec col_sqnorms(const SpMat &A) {
+    Vec L(A.cols());
+    for (Index j = 0; j < A.cols(); j++) L[j] = A.col(j).squaredNorm();
+    return L;
+}
+
+// a += v, there is no fetch_add for floating point atomics before C++20
+inline void atomic_add(std::atomic<Scalar> &a, Scalar v) {
+    Scalar old = a.load(std::memory_order_relaxed);
+    while (!a.compare_exchange_weak(old, old + v, std::memory_order_relaxed)) {}
+}
+
+// uniform sampling with replacement
+void draw_batch(std::mt19937 &gen, Index n_samples, std::vector<Index> &batch) {
+    std::uniform_int_distribution<Index> dist(0, n_samples - 1);
+    for (Index &i : batch) i = dist(gen);
+}
+
+// (I - gamma H)(I - D (I - gamma H)) + rho I, H the Hessian of f at x and
+// D the Jacobian of the prox at z, p = prox(z)
+class NewtonOp : public MatOp<Scalar> {
+public:
+    NewtonOp(FuncGrad<Scalar> &f, const Ref<const Mat> x, const Proximal<Scalar> &prox,
+             const Ref<const Mat> z, const Ref<const Mat> p, Scalar gamma, Scalar rho)
+        : MatOp<Scalar>(x.size(), x.size()), f_(f), x_(x), prox_(prox), z_(z), p_(p),
+          gamma_(gamma), rho_(rho), u_(x.rows(), x.cols()), w_(x.rows(), x.cols()) {}
+
+    void apply(const Ref<const Mat> in, Ref<Mat> out) const {
+        f_.hessian(x_, in, u_);
+        u_ = in - gamma_ * u_;
+        prox_.jacobian(z_, p_, gamma_, u_, w_);
+        f_.hessian(x_, w_, out);
+        out = u_ - w_ + gamma_ * out + rho_ * in;
+    }
+    void apply_transpose(const Ref<const Mat> in, Ref<Mat> out) const { apply(in, out); }
+
+private:
+    FuncGrad<Scalar>       &f_;
+    Ref<const Mat>          x_;
+    const Proximal<Scalar> &prox_;
+    Ref<const Mat>          z_, p_;
+    Scalar                  gamma_, rho_;
+    mutable Mat             u_, w_;
+};
+
+// H + rho I, H the Hessian of f at x
+class ShiftedHessianOp : public MatOp<Scalar> {
+public:
+    ShiftedHessianOp(FuncGrad<Scalar> &f, const Ref<const Mat> x, Scalar rho)
+        : MatOp<Scalar>(x.size(), x.size()), f_(f), x_(x), rho_(rho) {}
+
+    void apply(const Ref<const Mat> in, Ref<Mat> out) const {
+        f_.hessian(x_, in, out);
+        out += rho_ * in;
+    }
+    void apply_transpose(const Ref<const Mat> in, Ref<Mat> out) const { apply(in, out); }
+
+private:
+    FuncGrad<Scalar> &f_;
+    Ref<const Mat>    x_;
+    Scalar            rho_;
+};
+
+// op d = rhs for a symmetric positive semidefinite op by conjugate gradients
+// from d = 0, until ||rhs - op d|| <= tol ||rhs||; returns the iterations
+Index conjugate_gradient(const MatOp<Scalar> &op, const Ref<const Mat> rhs, Scalar tol,
+                         Index maxit, Ref<Mat> d) {
+    OPTSUITE_PROFILE_SCOPE("conjugate_gradient");
+    Mat    r = rhs, q = rhs, op_q(rhs.rows(), rhs.cols());
+    Scalar rr = r.squaredNorm(), stop = tol * tol * rr;
+    Index  k  = 0;
+    d.setZero();
+    for (; k < maxit && rr > stop; ++k) {
+        op.apply(q, op_q);
+        Scalar q_op_q = q.cwiseProduct(op_q).sum();
+        // negative curvature, with gamma above 1 / L locally
+        if (q_op_q <= 0) {
+            if (k == 0) d = rhs;
+            break;
+        }
+        Scalar step = rr / q_op_q;
+        d += step * q;
+        r -= step * op_q;
+        Scalar rr_next = r.squaredNorm();
+        q  = r + (rr_next / rr) * q;
+        rr = rr_next;
+    }
+    return k;
+}
+}   // namespace
+
 Scalar SolverOptions::ftol() { return ftol_; }
 Scalar SolverOptions::gtol() { return gtol_; }
 Scalar SolverOptions::xtol() { return xtol_; }
@@ -64,7 +210,7 @@ Scalar ArmijoStepSize::operator()(Ref<const Mat> x, const MatWrapper<Scalar> &gr
         MatWrapper<Scalar> gt(x);
         gt  = MatWrapper<Scalar>(func_gt(t));
         Scalar             lhs = func_f(x - t * gt.mat()); 
-        Scalar             rhs = f_val + t * grad_f.dot(gt) + 0.5 * t * gt.mat().squaredNorm();
+        Scalar             rhs = f_val - t * grad_f.dot(gt) + 0.5 * t * gt.mat().squaredNorm();
         if (lhs <= rhs) { break; }
         t *= shrink_scale_;
     }
@@ -96,7 +242,7 @@ Scalar BBStepSize::operator()(Ref<const Mat> x, const MatWrapper<Scalar> &grad_f
     MatWrapper<Scalar> grad_f_new(x_new);
     Scalar f_val_new = func_f(x_new, grad_f_new.mat(), true);
     MatWrapper<Scalar> s(x_new - x);
-    MatWrapper<Scalar> y(grad_f_new.mat() - grad_f.mat());
+    MatWrapper<Scalar> y = grad_f_new - grad_f;
     C = (eta_ * Q * C + f_val_new) / (eta_ * Q + 1);
     Q = eta_ * Q + 1;
     if (stepType)
@@ -111,26 +257,65 @@ Scalar BBStepSize::operator()(Ref<const Mat> x, const MatWrapper<Scalar> &grad_f
 void ProximalGradSolver::operator()(Ref<const Mat> x0, FuncGrad<Scalar> &func_f,
                                     Func<Scalar> &func_h, Proximal<Scalar> &h_prox, Scalar t,
                                     Ref<Mat> result, SolverRecords &records) {
+    solve(x0, func_f, func_h, h_prox, t, result, records, screen_t());
+}
+
+void ProximalGradSolver::operator()(Ref<const Mat> x0, AxmbNormSqr<Scalar> &func_f,
+                                    Func<Scalar> &func_h, Proximal<Scalar> &h_prox, Scalar t,
+                                    Ref<Mat> result, SolverRecords &records) {
+    if (options_.screening() == 0 || h_prox.penalty_groups() == PenaltyGroups::None) {
+        solve(x0, func_f, func_h, h_prox, t, result, records, screen_t());
+        return;
+    }
+    const Mat         &A = func_f.get_A();
+    GapSafeScreening   gap_safe(col_sqnorms(A).cwiseSqrt(), func_f.get_b(),
+                                h_prox.penalty_groups(), h_prox.penalty_weight());
+    std::vector<Index> active(A.cols());
+    std::iota(active.begin(), active.end(), 0_i);
+    auto screen = [&](Ref<Mat> x, const Ref<const Mat> grad) {
+        Index before = active.size();
+        gap_safe(x, func_f.residual(), grad, active);
+        if (Index(active.size()) == before) return false;
+        std::vector<bool> kept(x.rows(), false);
+        for (Index j : active) kept[j] = true;
+        for (Index j = 0; j < x.rows(); j++)
+            if (!kept[j]) x.row(j).setZero();
+        func_f.set_active(active);
+        return true;
+    };
+    // gives func_f all columns back, also when solve throws
+    struct ClearActive {
+        AxmbNormSqr<Scalar> &f;
+        ~ClearActive() { f.clear_active(); }
+    } clear_active{func_f};
+    solve(x0, func_f, func_h, h_prox, t, result, records, screen);
+    records.screened += A.cols() - active.size();
+}
+
+void ProximalGradSolver::solve(Ref<const Mat> x0, FuncGrad<Scalar> &func_f, Func<Scalar> &func_h,
+                               Proximal<Scalar> &h_prox, Scalar t, Ref<Mat> result,
+                               SolverRecords &records, const screen_t &screen) {
     using namespace OptSuite::Utils;
+    OPTSUITE_PROFILE_SCOPE("ProximalGradSolver");
     Logger               logger(options_.verbosity(), /* use_stderr */ true);
+    // temporaries of the functionals called below are taken from arena_
+    Arena::Bind          bind_arena(arena_);
     stopwatch::Stopwatch stopwatch;
     stopwatch.start();
     Mat                 x = x0;
     MatWrapper<Scalar>  grad_f(x);
     Index               i;
     std::vector<Scalar> obj_hist;
-    Index               lasting_iters = 0;
-    Scalar              f_val, h_val;
-    auto                stop_checker = [&]() -> bool {
-        Index size = obj_hist.size();
-        if (size < 2) { return false; }
-        if (std::fabs(obj_hist[size - 1] - obj_hist[size - 2]) / obj_hist[size - 2] <
-            options_.ftol()) {
-            lasting_iters++;
-        } else {
-            lasting_iters = 0;
-        }
-        return lasting_iters >= options_.min_lasting_iters();
+    std::vector<time_t> time_hist;
+    ObjStopChecker      stop_checker(options_.ftol(), options_.min_lasting_iters());
+    Scalar              f_val = 0, h_val = 0;
+    // P(x) - D(s * grad f(x)) for the dual variable scaled into the domain
+    // of the conjugate of t * h, see Proximal::dual_scale
+    bool certified   = h_prox.has_conjugate() && func_f.has_dual();
+    auto duality_gap = [&](Scalar obj_val) -> Scalar {
+        Scalar s    = h_prox.dual_scale(grad_f.mat());
+        Scalar dual = func_f.dual_objective(x, f_val, s) - h_prox.conjugate(-s * grad_f.mat());
+        return std::max(obj_val - dual, 0_s);
     };
     auto get_step_size = [&]() -> Scalar {
         switch (this->options_.step_size_strategy()) {
@@ -147,8 +332,18 @@ void ProximalGradSolver::operator()(Ref<const Mat> x0, FuncGrad<Scalar> &func_f,
         }
     };
     for (i = 0; i < options_.maxit(); i++) {
-        f_val          = func_f(x, grad_f.mat(), true);
-        h_val          = func_h(x);
+        {
+            OPTSUITE_PROFILE_SCOPE("eval_f");
+            f_val = func_f(x, grad_f.mat(), true);
+        }
+        if (screen && i % options_.screening() == 0) {
+            OPTSUITE_PROFILE_SCOPE("screening");
+            if (screen(x, grad_f.mat())) f_val = func_f(x, grad_f.mat(), true);
+        }
+        {
+            OPTSUITE_PROFILE_SCOPE("eval_h");
+            h_val = func_h(x);
+        }
         Scalar obj_val = f_val + t * h_val;
         if (i % 10 == 0) {
             logger.log_debug(std::left, std::setw(10), "Iters: ", i);
@@ -157,14 +352,823 @@ void ProximalGradSolver::operator()(Ref<const Mat> x0, FuncGrad<Scalar> &func_f,
             logger.log_debug("\n");
         }
         obj_hist.push_back(obj_val);
-        if (stop_checker()) { break; }
-        Scalar step_size = get_step_size();
-        h_prox(x.array() - step_size * grad_f.mat().array(), /* t */ step_size, x);
+        time_hist.push_back(stopwatch.elapsed<stopwatch::mus>());
+        if (certified && options_.gap_tol() > 0) {
+            OPTSUITE_PROFILE_SCOPE("duality_gap");
+            if (duality_gap(obj_val) <= options_.gap_tol() * std::max(1_s, std::fabs(obj_val)))
+                break;
+        } else if (stop_checker(obj_hist)) { break; }
+        Scalar step_size;
+        {
+            OPTSUITE_PROFILE_SCOPE("step_size");
+            step_size = get_step_size();
+        }
+        {
+            OPTSUITE_PROFILE_SCOPE("prox");
+            Arena::Scope scope(arena_);
+            auto         x_tmp = arena_.mat<Scalar>(x.rows(), x.cols());
+            x_tmp              = x - step_size * grad_f.mat();
+            h_prox(x_tmp, /* t */ step_size, x);
+        }
+    }
+    if (certified) {
+        OPTSUITE_PROFILE_SCOPE("duality_gap");
+        // after maxit iterations x has moved past the last evaluation
+        if (i == options_.maxit()) {
+            f_val = func_f(x, grad_f.mat(), true);
+            h_val = func_h(x);
+        }
+        records.gap = duality_gap(f_val + t * h_val);
+        logger.log_debug("duality gap: ", std::scientific, records.gap, "\n");
+    }
+    logger.log_debug("arena: ", arena_.high_water(), " bytes at peak, ",
+                     arena_.capacity(), " bytes in ", arena_.num_blocks(), " block(s)\n");
+    result                  = x;
+    records.elapsed_time_us += stopwatch.elapsed<stopwatch::mus>();
+    records.n_iters         += i;
+    records.arena_bytes     = std::max(records.arena_bytes, arena_.high_water());
+    records.obj_hist        = std::move(obj_hist);
+    records.time_hist_us    = std::move(time_hist);
+}
+
+Index StochasticSolverBase::epoch_length(Index n_samples) const {
+    if (stoch_.epoch_length > 0) return stoch_.epoch_length;
+    return std::max(1_i, n_samples / stoch_.batch_size);
+}
+
+void ProxSVRGSolver::operator()(Ref<const Mat> x0, FiniteSumFuncGrad<Scalar> &func_f,
+                                Func<Scalar> &func_h, Proximal<Scalar> &h_prox, Scalar t,
+                                Ref<Mat> result, SolverRecords &records) {
+    using namespace OptSuite::Utils;
+    OPTSUITE_PROFILE_SCOPE("ProxSVRGSolver");
+    OPTSUITE_ASSERT(stoch_.batch_size > 0);
+    Logger               logger(options_.verbosity(), /* use_stderr */ true);
+    Arena::Bind          bind_arena(arena_);
+    stopwatch::Stopwatch stopwatch;
+    stopwatch.start();
+    Index               n_samples = func_f.num_samples();
+    Index               inner     = epoch_length(n_samples);
+    Scalar              step_size = options_.fixed()();
+    // N / |B| makes the mini-batch sums unbiased estimates of the full sums
+    Scalar              scale     = Scalar(n_samples) / stoch_.batch_size;
+    std::mt19937        gen(stoch_.seed);
+    std::vector<Index>  batch(stoch_.batch_size);
+    Mat                 x = x0, x_snap(x0.rows(), x0.cols()), full_grad(x0.rows(), x0.cols());
+    Scalar              passes = 0;
+    std::vector<Scalar> obj_hist;
+    std::vector<time_t> time_hist;
+    ObjStopChecker      stop_checker(options_.ftol(), options_.min_lasting_iters());
+    Index               k;
+    for (k = 0; k < options_.maxit(); k++) {
+        // the snapshot and its full gradient
+        x_snap = x;
+        Scalar f_val;
+        {
+            OPTSUITE_PROFILE_SCOPE("full_grad");
+            f_val = func_f(x_snap, full_grad, true);
+        }
+        passes += 1;
+        Scalar obj_val = f_val + t * func_h(x_snap);
+        logger.log_debug(std::left, std::setw(10), "Epoch: ", k);
+        logger.log_debug(std::left, std::scientific, ", Obj: ", obj_val);
+        logger.log_debug(std::left, std::fixed, ", passes: ", passes);
+        logger.log_debug("\n");
+        obj_hist.push_back(obj_val);
+        time_hist.push_back(stopwatch.elapsed<stopwatch::mus>());
+        if (stop_checker(obj_hist)) { break; }
+
+        OPTSUITE_PROFILE_SCOPE("epoch");
+        for (Index j = 0; j < inner; j++) {
+            Arena::Scope scope(arena_);
+            auto         g      = arena_.mat<Scalar>(x.rows(), x.cols());
+            auto         g_snap = arena_.mat<Scalar>(x.rows(), x.cols());
+            draw_batch(gen, n_samples, batch);
+            func_f.batch(x, batch, g, true);
+            func_f.batch(x_snap, batch, g_snap, true);
+            // v = N / |B| (g - g_snap) + grad f(x_snap)
+            g = x - step_size * (scale * (g - g_snap) + full_grad);
+            h_prox(g, /* t */ step_size, x);
+        }
+        passes += 2_s * inner * stoch_.batch_size / n_samples;
+    }
+    result                  = x;
+    records.elapsed_time_us += stopwatch.elapsed<stopwatch::mus>();
+    records.n_iters         += k;
+    records.data_passes     += passes;
+    records.obj_hist        = std::move(obj_hist);
+    records.time_hist_us    = std::move(time_hist);
+    records.arena_bytes     = std::max(records.arena_bytes, arena_.high_water());
+}
+
+void ProxSAGASolver::operator()(Ref<const Mat> x0, FiniteSumFuncGrad<Scalar> &func_f,
+                                Func<Scalar> &func_h, Proximal<Scalar> &h_prox, Scalar t,
+                                Ref<Mat> result, SolverRecords &records) {
+    using namespace OptSuite::Utils;
+    OPTSUITE_PROFILE_SCOPE("ProxSAGASolver");
+    OPTSUITE_ASSERT(stoch_.batch_size > 0);
+    Logger               logger(options_.verbosity(), /* use_stderr */ true);
+    Arena::Bind          bind_arena(arena_);
+    stopwatch::Stopwatch stopwatch;
+    stopwatch.start();
+    Index               n_samples = func_f.num_samples();
+    Index               inner     = epoch_length(n_samples);
+    Scalar              step_size = options_.fixed()();
+    Scalar              scale     = Scalar(n_samples) / stoch_.batch_size;
+    bool                linear    = func_f.is_linear_model();
+    std::mt19937        gen(stoch_.seed);
+    std::vector<Index>  batch(stoch_.batch_size);
+    Index               m = x0.rows(), n = x0.cols();
+    Mat                 x = x0, grad_sum(m, n);
+    // the last gradient of every sample: the rows d_i of a linear model, or
+    // one column per sample holding the whole gradient
+    Mat                 table;
+    {
+        OPTSUITE_PROFILE_SCOPE("init_table");
+        grad_sum.setZero();
+        if (linear) {
+            std::vector<Index> all(n_samples);
+            std::iota(all.begin(), all.end(), 0_i);
+            table.resize(n_samples, n);
+            func_f.sample_derivative(x, all, table);
+            func_f.add_samples(all, table, 1_s, grad_sum);
+        } else {
+            table.resize(m * n, n_samples);
+            for (Index i = 0; i < n_samples; i++) {
+                Map<Mat> gi(table.col(i).data(), m, n);
+                func_f.sample(x, i, gi, true);
+                grad_sum += gi;
+            }
+        }
+    }
+    Scalar              passes = 1;
+    std::vector<Scalar> obj_hist;
+    std::vector<time_t> time_hist;
+    ObjStopChecker      stop_checker(options_.ftol(), options_.min_lasting_iters());
+    Index               k;
+    for (k = 0; k < options_.maxit(); k++) {
+        Scalar obj_val = func_f(x) + t * func_h(x);
+        logger.log_debug(std::left, std::setw(10), "Epoch: ", k);
+        logger.log_debug(std::left, std::scientific, ", Obj: ", obj_val);
+        logger.log_debug(std::left, std::fixed, ", passes: ", passes);
+        logger.log_debug("\n");
+        obj_hist.push_back(obj_val);
+        time_hist.push_back(stopwatch.elapsed<stopwatch::mus>());
+        if (stop_checker(obj_hist)) { break; }
+
+        OPTSUITE_PROFILE_SCOPE("epoch");
+        for (Index j = 0; j < inner; j++) {
+            Arena::Scope scope(arena_);
+            auto         v = arena_.mat<Scalar>(m, n);
+            draw_batch(gen, n_samples, batch);
+            // v = N / |B| sum_B (new - old) + sum of the table, then update
+            // the table and its sum. A repeated index sees its first update.
+            v = grad_sum;
+            if (linear) {
+                auto delta = arena_.mat<Scalar>(stoch_.batch_size, n);
+                func_f.sample_derivative(x, batch, delta);
+                for (Index l = 0; l < stoch_.batch_size; l++) {
+                    delta.row(l).swap(table.row(batch[l]));
+                    delta.row(l) = table.row(batch[l]) - delta.row(l);
+                }
+                func_f.add_samples(batch, delta, scale, v);
+                func_f.add_samples(batch, delta, 1_s, grad_sum);
+            } else {
+                auto delta = arena_.mat<Scalar>(m, n);
+                for (Index i : batch) {
+                    Map<Mat> gi(table.col(i).data(), m, n);
+                    func_f.sample(x, i, delta, true);
+                    delta -= gi;
+                    gi += delta;
+                    v += scale * delta;
+                    grad_sum += delta;
+                }
+            }
+            v = x - step_size * v;
+            h_prox(v, /* t */ step_size, x);
+        }
+        passes += Scalar(inner) * stoch_.batch_size / n_samples;
     }
     result                  = x;
     records.elapsed_time_us += stopwatch.elapsed<stopwatch::mus>();
+    records.n_iters         += k;
+    records.data_passes     += passes;
+    records.obj_hist        = std::move(obj_hist);
+    records.time_hist_us    = std::move(time_hist);
+    records.arena_bytes     = std::max(records.arena_bytes, arena_.high_water());
+}
+
+void CoordinateDescentSolver::operator()(Ref<const Mat> x0, const AxmbNormSqr<Scalar> &func_f,
+                                         Func<Scalar> &func_h, Proximal<Scalar> &h_prox,
+                                         Ref<Mat> result, SolverRecords &records) {
+    Cache cache;
+    solve(x0, func_f.get_A(), func_f.get_b(), func_h, h_prox, result, records, cache);
+}
+
+void CoordinateDescentSolver::operator()(Ref<const Mat> x0, const Mat &A, Ref<const Mat> b,
+                                         Func<Scalar> &func_h, Proximal<Scalar> &h_prox,
+                                         Ref<Mat> result, SolverRecords &records) {
+    Cache cache;
+    solve(x0, A, b, func_h, h_prox, result, records, cache);
+}
+
+void CoordinateDescentSolver::operator()(Ref<const Mat> x0, const SpMat &A, Ref<const Mat> b,
+                                         Func<Scalar> &func_h, Proximal<Scalar> &h_prox,
+                                         Ref<Mat> result, SolverRecords &records) {
+    // the atomic updates cost several times a serial one, so a single
+    // worker runs the serial solver
+    if (cd_.num_threads != 1 && Utils::ThreadPool::global().num_threads() > 1) {
+        solve_async(x0, A, b, func_h, h_prox, result, records);
+    } else {
+        Cache cache;
+        solve(x0, A, b, func_h, h_prox, result, records, cache);
+    }
+}
+
+template <typename MatType>
+void CoordinateDescentSolver::solve(Ref<const Mat> x0, const MatType &A, Ref<const Mat> b,
+                                    Func<Scalar> &func_h, Proximal<Scalar> &h_prox,
+                                    Ref<Mat> result, SolverRecords &records, Cache &cache) {
+    using namespace OptSuite::Utils;
+    OPTSUITE_PROFILE_SCOPE("CoordinateDescentSolver");
+    OPTSUITE_ASSERT(h_prox.is_separable());
+    OPTSUITE_ASSERT(b.cols() == 1 && x0.cols() == 1);
+    OPTSUITE_ASSERT(A.rows() == b.rows() && A.cols() == x0.rows());
+    Logger               logger(options_.verbosity(), /* use_stderr */ true);
+    stopwatch::Stopwatch stopwatch;
+    stopwatch.start();
+    Index  m = A.rows(), n = A.cols();
+    bool   covariance = cd_.update == CDUpdate::Covariance || (cd_.update == CDUpdate::Auto && m > n);
+    Vec    x          = x0;
+    Scalar b_sqr      = b.squaredNorm();
+    Scalar tol        = options_.xtol() * std::max(b_sqr, eps);
+    if (cache.L.size() == 0) cache.L = col_sqnorms(A);
+    const Vec &L = cache.L;
+
+    // residual updates: r = Ax - b
+    Vec r;
+    // covariance updates: g = A'(Ax - b) = Gx - c, and the columns of the
+    // Gram matrix G = A'A, computed when the coordinate first moves
+    Vec               g;
+    std::vector<Vec> &gram = cache.gram;
+    if (covariance) {
+        if (cache.c.size() == 0) cache.c = A.transpose() * b.col(0);
+        Vec Ax = A * x;
+        g      = A.transpose() * Ax - cache.c;
+        gram.resize(n);
+    } else {
+        r = A * x - b.col(0);
+    }
+
+    // sets x_j, returns L_j dx_j^2
+    auto move = [&](Index j, Scalar xj) -> Scalar {
+        Scalar d = xj - x[j];
+        if (d == 0) return 0;
+        x[j] = xj;
+        if (covariance) {
+            if (gram[j].size() == 0) gram_col(A, j, gram[j]);
+            g.noalias() += d * gram[j];
+        } else {
+            col_axpy(A, j, d, r);
+        }
+        return L[j] * d * d;
+    };
+    // minimize over x_j
+    auto update = [&](Index j) -> Scalar {
+        if (L[j] == 0) return 0;
+        Scalar gj = covariance ? g[j] : col_dot(A, j, r);
+        return move(j, h_prox.prox_entry(x[j] - gj / L[j], 1 / L[j]));
+    };
+    std::mt19937 gen(cd_.seed);
+    auto         sweep = [&](std::vector<Index> &order) {
+        if (cd_.shuffle) std::shuffle(order.begin(), order.end(), gen);
+        Scalar change = 0;
+        for (Index j : order) change = std::max(change, update(j));
+        return change;
+    };
+    auto objective = [&]() {
+        // 0.5 ||Ax - b||^2 = 0.5 x'(g - c) + 0.5 ||b||^2
+        Scalar f_val = covariance ? 0.5_s * x.dot(g - cache.c) + 0.5_s * b_sqr : 0.5_s * r.squaredNorm();
+        return f_val + func_h(x);
+    };
+
+    std::vector<Index> all(n), active;
+    std::iota(all.begin(), all.end(), 0_i);
+    if (!cache.working.empty()) all = cache.working;
+
+    // drops the coordinates that are zero at every solution
+    std::unique_ptr<GapSafeScreening> gap_safe;
+    if (options_.screening() > 0 && h_prox.penalty_groups() == PenaltyGroups::Entries)
+        gap_safe.reset(new GapSafeScreening(L.cwiseSqrt(), b, PenaltyGroups::Entries,
+                                            h_prox.penalty_weight()));
+    Index screened = 0;
+    auto  screen   = [&]() {
+        OPTSUITE_PROFILE_SCOPE("screening");
+        std::vector<Index> kept(all);
+        if (covariance) {
+            // ||r||^2 = x'(g - c) + ||b||^2 and <b, r> = c'x - ||b||^2
+            Scalar cx = cache.c.dot(x);
+            (*gap_safe)(x, x.dot(g) - cx + b_sqr, cx - b_sqr, g, kept);
+        } else {
+            Vec gs(n);
+            for (Index j : all) gs[j] = col_dot(A, j, r);
+            (*gap_safe)(x, r, gs, kept);
+        }
+        std::vector<char> keep(n, 0);
+        for (Index j : kept) keep[j] = 1;
+        for (Index j : all)
+            if (!keep[j]) move(j, 0);
+        screened += all.size() - kept.size();
+        all.swap(kept);
+    };
+
+    std::vector<Scalar> obj_hist;
+    std::vector<time_t> time_hist;
+    Index               i = 0;
+    while (i < options_.maxit()) {
+        Scalar change;
+        {
+            OPTSUITE_PROFILE_SCOPE("full_sweep");
+            change = sweep(all);
+        }
+        i++;
+        Scalar obj_val = objective();
+        logger.log_debug(std::left, std::setw(10), "Iters: ", i);
+        logger.log_debug(std::left, std::scientific, ", Obj: ", obj_val);
+        logger.log_debug(std::left, std::scientific, ", change: ", change);
+        logger.log_debug("\n");
+        obj_hist.push_back(obj_val);
+        time_hist.push_back(stopwatch.elapsed<stopwatch::mus>());
+        if (change < tol) break;
+        if (gap_safe) screen();
+        if (!cd_.active_set) continue;
+
+        // cycle over the nonzeros until they settle. Early supports can be
+        // much larger than the final one and ill-conditioned, so they are
+        // only solved to a fraction of the change of the last full sweep.
+        OPTSUITE_PROFILE_SCOPE("active_sweeps");
+        Scalar active_tol = std::max(tol, 1e-2_s * change);
+        active.clear();
+        for (Index j : all)
+            if (x[j] != 0) active.push_back(j);
+        while (i < options_.maxit()) {
+            i++;
+            if (sweep(active) < active_tol) break;
+        }
+    }
+    result                  = x;
+    records.elapsed_time_us += stopwatch.elapsed<stopwatch::mus>();
+    records.n_iters         += i;
+    records.screened        += screened;
+    records.obj_hist        = std::move(obj_hist);
+    records.time_hist_us    = std::move(time_hist);
+}
+
+void RegularizationPathSolver::operator()(const Mat &A, Ref<const Mat> b, RegularizationPath &path,
+                                          SolverRecords &records) {
+    solve_path(A, b, path, records);
+}
+
+void RegularizationPathSolver::operator()(const SpMat &A, Ref<const Mat> b,
+                                          RegularizationPath &path, SolverRecords &records) {
+    solve_path(A, b, path, records);
+}
+
+template <typename MatType>
+void RegularizationPathSolver::solve_path(const MatType &A, Ref<const Mat> b,
+                                          RegularizationPath &path, SolverRecords &records) {
+    using namespace OptSuite::Utils;
+    OPTSUITE_PROFILE_SCOPE("RegularizationPathSolver");
+    OPTSUITE_ASSERT(b.cols() == 1 && A.rows() == b.rows());
+    OPTSUITE_ASSERT(path_.num_lambdas > 0);
+    OPTSUITE_ASSERT(path_.lambda_min_ratio > 0 && path_.lambda_min_ratio <= 1);
+    OPTSUITE_ASSERT(path_.l1_ratio > 0 && path_.l1_ratio <= 1);
+    Logger logger(options_.verbosity(), /* use_stderr */ true);
+    Index  n = A.cols(), K = path_.num_lambdas;
+    Scalar alpha      = path_.l1_ratio;
+    Scalar lambda_max = Vec(A.transpose() * b.col(0)).cwiseAbs().maxCoeff() / alpha;
+
+    path.lambdas.resize(K);
+    for (Index k = 0; k < K; k++)
+        path.lambdas[k] = K == 1 ? lambda_max
+                                 : lambda_max * std::pow(path_.lambda_min_ratio,
+                                                         static_cast<Scalar>(k) / (K - 1));
+
+    stopwatch::Stopwatch stopwatch;
+    stopwatch.start();
+    Cache                cache;
+    ElasticNet           func_h;
+    ShrinkageElasticNet  h_prox;
+    Mat                  x = Mat::Zero(n, 1);
+    Vec                  grad;
+    std::vector<Triplet> triplets;
+    std::vector<Scalar>  obj_hist;
+    std::vector<time_t>  time_hist;
+    Index                sweeps = 0, screened = 0;
+    // the gradient A'(Ax - b) for the strong rule and the KKT conditions
+    auto gradient = [&]() {
+        OPTSUITE_PROFILE_SCOPE("kkt");
+        Vec r = A * x.col(0) - b.col(0);
+        grad  = A.transpose() * r;
+    };
+    // the solution at lambda_max is zero
+    gradient();
+    obj_hist.push_back(0.5_s * b.squaredNorm());
+    time_hist.push_back(stopwatch.elapsed<stopwatch::mus>());
+    for (Index k = 1; k < K; k++) {
+        Scalar lambda = path.lambdas[k];
+        func_h.mu1 = h_prox.mu1 = lambda * alpha;
+        func_h.mu2 = h_prox.mu2 = lambda * (1 - alpha);
+
+        // sequential strong rule: x_j stays zero if |grad_j| < alpha (2 lambda_k - lambda_{k-1})
+        // at the previous solution. It is not safe, so the KKT conditions
+        // |grad_j| <= alpha lambda_k of the discarded ones are checked after
+        // the solve and the violators put back.
+        std::vector<Index> &working = cache.working;
+        std::vector<char>   in_working(n, 0);
+        working.clear();
+        Scalar strong = alpha * (2 * lambda - path.lambdas[k - 1]);
+        for (Index j = 0; j < n; j++) {
+            if (x(j, 0) != 0 || std::abs(grad[j]) >= strong) {
+                working.push_back(j);
+                in_working[j] = 1;
+            }
+        }
+        SolverRecords point;
+        for (;;) {
+            // an empty working set would sweep all coordinates
+            if (!working.empty()) {
+                solve(x, A, b, func_h, h_prox, x, point, cache);
+                gradient();
+            }
+            Index violations = 0;
+            for (Index j = 0; j < n; j++) {
+                if (!in_working[j] && std::abs(grad[j]) > alpha * lambda) {
+                    working.push_back(j);
+                    in_working[j] = 1;
+                    violations++;
+                }
+            }
+            if (violations == 0) break;
+        }
+        if (point.obj_hist.empty()) obj_hist.push_back(obj_hist.back());
+        else obj_hist.push_back(point.obj_hist.back());
+        sweeps   += point.n_iters;
+        screened += point.screened;
+        time_hist.push_back(stopwatch.elapsed<stopwatch::mus>());
+        logger.log_debug(std::left, std::setw(10), "Lambda: ", std::scientific, lambda);
+        logger.log_debug(std::left, ", Sweeps: ", point.n_iters);
+        logger.log_debug(std::left, ", Working: ", working.size());
+        logger.log_debug(std::left, std::scientific, ", Obj: ", obj_hist.back());
+        logger.log_debug("\n");
+        for (Index j = 0; j < n; j++)
+            if (x(j, 0) != 0) triplets.emplace_back(j, k, x(j, 0));
+    }
+    cache.working.clear();
+    path.coefs.resize(n, K);
+    path.coefs.setFromTriplets(triplets.begin(), triplets.end());
+    records.elapsed_time_us += stopwatch.elapsed<stopwatch::mus>();
+    records.n_iters         += sweeps;
+    records.screened        += screened;
+    records.obj_hist        = std::move(obj_hist);
+    records.time_hist_us    = std::move(time_hist);
+}
+
+void CoordinateDescentSolver::solve_async(Ref<const Mat> x0, const SpMat &A, Ref<const Mat> b,
+                                          Func<Scalar> &func_h, Proximal<Scalar> &h_prox,
+                                          Ref<Mat> result, SolverRecords &records) {
+    using namespace OptSuite::Utils;
+    OPTSUITE_PROFILE_SCOPE("CoordinateDescentSolver::async");
+    OPTSUITE_ASSERT(h_prox.is_separable());
+    OPTSUITE_ASSERT(b.cols() == 1 && x0.cols() == 1);
+    OPTSUITE_ASSERT(A.rows() == b.rows() && A.cols() == x0.rows());
+    Logger               logger(options_.verbosity(), /* use_stderr */ true);
+    stopwatch::Stopwatch stopwatch;
+    stopwatch.start();
+    Index  m = A.rows(), n = A.cols();
+    int    p = cd_.num_threads > 0 ? cd_.num_threads : ThreadPool::global().num_threads();
+    Vec    L   = col_sqnorms(A);
+    Scalar tol = options_.xtol() * std::max(b.squaredNorm(), eps);
+
+    // the shared iterate and residual r = Ax - b
+    std::vector<std::atomic<Scalar>> x(n), r(m);
+    {
+        Vec r0 = A * x0.col(0) - b.col(0);
+        for (Index j = 0; j < n; j++) x[j].store(x0(j, 0), std::memory_order_relaxed);
+        for (Index k = 0; k < m; k++) r[k].store(r0[k], std::memory_order_relaxed);
+    }
+
+    // minimize over x_j, returns L_j dx_j^2. The update is dropped when
+    // another thread changed x_j in the meantime.
+    auto update = [&](Index j) -> Scalar {
+        if (L[j] == 0) return 0;
+        Scalar gj = 0;
+        for (SpMat::InnerIterator it(A, j); it; ++it)
+            gj += it.value() * r[it.index()].load(std::memory_order_relaxed);
+        Scalar xj = x[j].load(std::memory_order_relaxed);
+        Scalar xn = h_prox.prox_entry(xj - gj / L[j], 1 / L[j]);
+        Scalar d  = xn - xj;
+        if (d == 0 || !x[j].compare_exchange_strong(xj, xn, std::memory_order_relaxed)) return 0;
+        for (SpMat::InnerIterator it(A, j); it; ++it) atomic_add(r[it.index()], d * it.value());
+        return L[j] * d * d;
+    };
+    auto current_x = [&]() {
+        Vec xv(n);
+        for (Index j = 0; j < n; j++) xv[j] = x[j].load(std::memory_order_relaxed);
+        return xv;
+    };
+    auto objective = [&](const Vec &xv) {
+        Scalar f_val = 0;
+        for (Index k = 0; k < m; k++) {
+            Scalar rk = r[k].load(std::memory_order_relaxed);
+            f_val += rk * rk;
+        }
+        return 0.5_s * f_val + func_h(xv);
+    };
+
+    // every thread takes a slice of order, returns the largest change
+    std::vector<Scalar> change(p);
+    auto                sweep = [&](const std::vector<Index> &order) -> Scalar {
+        OPTSUITE_PROFILE_SCOPE("async_sweep");
+        Index len = order.size();
+        ThreadPool::global().parallel_for(p, [&](Index t) {
+            Scalar c = 0;
+            for (Index k = len * t / p; k < len * (t + 1) / p; k++)
+                c = std::max(c, update(order[k]));
+            change[t] = c;
+        });
+        return *std::max_element(change.begin(), change.end());
+    };
+
+    std::mt19937       gen(cd_.seed);
+    std::vector<Index> perm(n), active;
+    std::iota(perm.begin(), perm.end(), 0);
+    std::vector<Scalar> obj_hist;
+    std::vector<time_t> time_hist;
+    Index               i = 0;
+    while (i < options_.maxit()) {
+        if (cd_.shuffle) std::shuffle(perm.begin(), perm.end(), gen);
+        Scalar max_change = sweep(perm);
+        i++;
+        Scalar obj_val = objective(current_x());
+        logger.log_debug(std::left, std::setw(10), "Iters: ", i);
+        logger.log_debug(std::left, std::scientific, ", Obj: ", obj_val);
+        logger.log_debug(std::left, std::scientific, ", change: ", max_change);
+        logger.log_debug("\n");
+        obj_hist.push_back(obj_val);
+        time_hist.push_back(stopwatch.elapsed<stopwatch::mus>());
+        if (max_change < tol) {
+            // the sweep read stale values and may have dropped updates
+            Scalar c = 0;
+            for (Index j = 0; j < n; j++) c = std::max(c, update(j));
+            i++;
+            if (c < tol) break;
+            continue;
+        }
+        if (!cd_.active_set) continue;
+
+        // cycle over the nonzeros until they settle, as in solve
+        OPTSUITE_PROFILE_SCOPE("active_sweeps");
+        Scalar active_tol = std::max(tol, 1e-2_s * max_change);
+        active.clear();
+        for (Index j = 0; j < n; j++)
+            if (x[j].load(std::memory_order_relaxed) != 0) active.push_back(j);
+        while (i < options_.maxit()) {
+            if (cd_.shuffle) std::shuffle(active.begin(), active.end(), gen);
+            i++;
+            if (sweep(active) < active_tol) break;
+        }
+    }
+    result.col(0)           = current_x();
+    records.elapsed_time_us += stopwatch.elapsed<stopwatch::mus>();
+    records.n_iters         += i;
+    records.obj_hist        = std::move(obj_hist);
+    records.time_hist_us    = std::move(time_hist);
+}
+
+void SemismoothNewtonSolver::operator()(Ref<const Mat> x0, FuncGrad<Scalar> &func_f,
+                                        Func<Scalar> &func_h, Proximal<Scalar> &h_prox, Scalar t,
+                                        Ref<Mat> result, SolverRecords &records) {
+    using namespace OptSuite::Utils;
+    OPTSUITE_PROFILE_SCOPE("SemismoothNewtonSolver");
+    OPTSUITE_ASSERT(func_f.has_hessian() && h_prox.has_jacobian());
+    Logger               logger(options_.verbosity(), /* use_stderr */ true);
+    Arena::Bind          bind_arena(arena_);
+    stopwatch::Stopwatch stopwatch;
+    stopwatch.start();
+    Index               rows = x0.rows(), cols = x0.cols();
+    Mat                 x = x0, g(rows, cols), z(rows, cols), p(rows, cols), gp(rows, cols);
+    Mat                 F(rows, cols), d(rows, cols), rhs(rows, cols);
+    Mat                 xn(rows, cols), gn(rows, cols), zn(rows, cols), pn(rows, cols);
+    std::vector<Scalar> obj_hist;
+    std::vector<time_t> time_hist;
+    Scalar              fx = func_f(x, g, true), fp, hp, hn;
+
+    // gamma = alpha / L for an estimate L of the Lipschitz constant of grad f,
+    // starting from the curvature along grad f(x0)
+    const Scalar alpha = 0.95_s;
+    Scalar       L;
+    {
+        Mat v = g.squaredNorm() > 0 ? g : Mat::Ones(rows, cols);
+        func_f.hessian(x, v, d);
+        L = std::max(d.norm() / v.norm(), 1e-10_s);
+    }
+    Scalar gamma = alpha / L;
+    // the forward-backward envelope at xc; zc and pc get the forward and the
+    // prox point, hc gets h(pc)
+    auto envelope = [&](const Mat &xc, Scalar fc, const Mat &gc, Mat &zc, Mat &pc,
+                        Scalar &hc) -> Scalar {
+        OPTSUITE_PROFILE_SCOPE("envelope");
+        zc = xc - gamma * gc;
+        h_prox(zc, gamma, pc);
+        hc = func_h(pc);
+        return fc + gc.cwiseProduct(pc - xc).sum() + (pc - xc).squaredNorm() / (2 * gamma) +
+               t * hc;
+    };
+    bool certified   = h_prox.has_conjugate() && func_f.has_dual();
+    auto duality_gap = [&](Scalar obj_val) -> Scalar {
+        Scalar s    = h_prox.dual_scale(gp);
+        Scalar dual = func_f.dual_objective(p, fp, s) - h_prox.conjugate(-s * gp);
+        return std::max(obj_val - dual, 0_s);
+    };
+
+    Index  i;
+    Scalar obj_val = 0;
+    // the shift of the Newton system is reg * ||F||, with reg raised when
+    // the full step is not taken and lowered when it is
+    Scalar reg = newton_.reg;
+    for (i = 0; i < options_.maxit(); ++i) {
+        Scalar phi;
+        // f(p) <= f(x) + <g, p - x> + L / 2 ||p - x||^2 makes the prox point a
+        // sufficient decrease of the envelope
+        while (true) {
+            phi = envelope(x, fx, g, z, p, hp);
+            F   = x - p;
+            fp  = func_f(p, gp, true);
+            if (fp <= fx - g.cwiseProduct(F).sum() + 0.5_s * L * F.squaredNorm() +
+                              1e-12_s * std::fabs(fx))
+                break;
+            L *= 2;
+            gamma = alpha / L;
+        }
+        obj_val     = fp + t * hp;
+        Scalar res  = F.norm() / gamma;
+        obj_hist.push_back(obj_val);
+        time_hist.push_back(stopwatch.elapsed<stopwatch::mus>());
+        logger.log_debug(std::left, std::setw(10), "Iters: ", i);
+        logger.log_debug(std::left, std::scientific, ", Obj: ", obj_val);
+        logger.log_debug(std::left, std::scientific, ", res: ", res);
+        logger.log_debug(std::left, std::scientific, ", gamma: ", gamma);
+        if (certified && options_.gap_tol() > 0) {
+            OPTSUITE_PROFILE_SCOPE("duality_gap");
+            Scalar gap = duality_gap(obj_val);
+            logger.log_debug(std::left, std::scientific, ", gap: ", gap, "\n");
+            if (gap <= options_.gap_tol() * std::max(1_s, std::fabs(obj_val))) break;
+        } else {
+            logger.log_debug("\n");
+            if (res <= options_.gtol()) break;
+        }
+
+        {
+            OPTSUITE_PROFILE_SCOPE("newton_step");
+            func_f.hessian(x, F, rhs);
+            rhs = gamma * rhs - F;
+            NewtonOp op(func_f, x, h_prox, z, p, gamma, reg * F.norm());
+            records.cg_iters += conjugate_gradient(
+                op, rhs, std::min(newton_.cg_tol, std::sqrt(res)), newton_.cg_maxit, d);
+        }
+        // Armijo on the envelope along d, its gradient at x is -rhs / gamma;
+        // the prox point decreases it whenever d does not
+        OPTSUITE_PROFILE_SCOPE("line_search");
+        Scalar slope = -rhs.cwiseProduct(d).sum() / gamma;
+        Scalar tau   = slope < 0 ? 1 : 0;
+        for (; tau >= 1e-3_s; tau /= 2) {
+            xn        = x + tau * d;
+            Scalar fn = func_f(xn, gn, true);
+            if (envelope(xn, fn, gn, zn, pn, hn) <= phi + newton_.sigma * tau * slope) {
+                x.swap(xn);
+                g.swap(gn);
+                fx = fn;
+                break;
+            }
+        }
+        reg = tau == 1 ? std::max(reg / 2, 1e-6_s) : std::min(reg * 4, 1e6_s);
+        if (tau < 1e-3_s) {
+            x  = p;
+            g  = gp;
+            fx = fp;
+        }
+    }
+    logger.log_debug("cg iterations: ", records.cg_iters, "\n");
+    // maxit() > 0, so the prox point of the last pass is always computed
+    result = p;
+    if (certified) records.gap = duality_gap(obj_val);
+    records.elapsed_time_us += stopwatch.elapsed<stopwatch::mus>();
+    records.n_iters         += i;
+    records.arena_bytes     = std::max(records.arena_bytes, arena_.high_water());
+    records.obj_hist        = std::move(obj_hist);
+    records.time_hist_us    = std::move(time_hist);
+}
+
+void ADMMSolver::operator()(Ref<const Mat> x0, FuncGrad<Scalar> &func_f, Func<Scalar> &func_h,
+                            Proximal<Scalar> &h_prox, Scalar t, Ref<Mat> result,
+                            SolverRecords &records) {
+    using namespace OptSuite::Utils;
+    OPTSUITE_PROFILE_SCOPE("ADMMSolver");
+    OPTSUITE_ASSERT(admm_.rho > 0);
+    OPTSUITE_ASSERT(func_f.has_prox() || func_f.has_hessian());
+    Logger               logger(options_.verbosity(), /* use_stderr */ true);
+    Arena::Bind          bind_arena(arena_);
+    stopwatch::Stopwatch stopwatch;
+    stopwatch.start();
+    Index               rows = x0.rows(), cols = x0.cols();
+    Mat                 x = x0, z = x0, z_prev(rows, cols), u = Mat::Zero(rows, cols);
+    Mat                 v(rows, cols), g(rows, cols), d(rows, cols);
+    std::vector<Scalar> obj_hist;
+    std::vector<time_t> time_hist;
+    Scalar              rho = admm_.rho;
+
+    // x = argmin f(x) + rho / 2 ||x - v||^2
+    auto x_update = [&]() {
+        OPTSUITE_PROFILE_SCOPE("x_update");
+        if (func_f.has_prox()) {
+            func_f.prox(v, 1 / rho, x);
+            return;
+        }
+        for (Index k = 0; k < admm_.newton_steps; ++k) {
+            func_f(x, g, true);
+            g += rho * (x - v);
+            ShiftedHessianOp op(func_f, x, rho);
+            records.cg_iters += conjugate_gradient(
+                op, -g, std::min(0.1_s, g.norm()), admm_.cg_maxit, d);
+            x += d;
+        }
+    };
+    bool   certified = h_prox.has_conjugate() && func_f.has_dual();
+    Scalar f_val = 0, gap = -1;
+    auto   duality_gap = [&](Scalar obj_val) -> Scalar {
+        Scalar s    = h_prox.dual_scale(g);
+        Scalar dual = func_f.dual_objective(z, f_val, s) - h_prox.conjugate(-s * g);
+        return std::max(obj_val - dual, 0_s);
+    };
+
+    Index i;
+    for (i = 0; i < options_.maxit(); ++i) {
+        v = z - u;
+        x_update();
+        z_prev = z;
+        {
+            OPTSUITE_PROFILE_SCOPE("prox");
+            v = x + u;
+            h_prox(v, 1 / rho, z);
+        }
+        u += x - z;
+
+        Scalar r = (x - z).norm();
+        Scalar s = rho * (z - z_prev).norm();
+        f_val    = func_f(z, g, true);
+        Scalar obj_val = f_val + t * func_h(z);
+        obj_hist.push_back(obj_val);
+        time_hist.push_back(stopwatch.elapsed<stopwatch::mus>());
+        logger.log_debug(std::left, std::setw(10), "Iters: ", i);
+        logger.log_debug(std::left, std::scientific, ", Obj: ", obj_val);
+        logger.log_debug(std::left, std::scientific, ", r: ", r);
+        logger.log_debug(std::left, std::scientific, ", s: ", s);
+        logger.log_debug(std::left, std::scientific, ", rho: ", rho);
+        if (certified && options_.gap_tol() > 0) {
+            OPTSUITE_PROFILE_SCOPE("duality_gap");
+            gap = duality_gap(obj_val);
+            logger.log_debug(std::left, std::scientific, ", gap: ", gap, "\n");
+            if (gap <= options_.gap_tol() * std::max(1_s, std::fabs(obj_val))) {
+                ++i;
+                break;
+            }
+        } else {
+            logger.log_debug("\n");
+            Scalar eps = options_.xtol();
+            if (r <= eps * std::max({1_s, x.norm(), z.norm()}) &&
+                s <= eps * std::max(1_s, rho * u.norm())) {
+                ++i;
+                break;
+            }
+        }
+
+        if (admm_.adaptive && (r > admm_.balance * s || s > admm_.balance * r)) {
+            // u is the dual variable divided by rho
+            Scalar scale = r > s ? admm_.factor : 1 / admm_.factor;
+            rho *= scale;
+            u /= scale;
+            records.rho_updates++;
+        }
+    }
+    result = z;
+    // no iteration, nothing to certify
+    if (certified && !obj_hist.empty())
+        records.gap = gap >= 0 ? gap : duality_gap(obj_hist.back());
+    records.elapsed_time_us += stopwatch.elapsed<stopwatch::mus>();
     records.n_iters         += i;
+    records.arena_bytes     = std::max(records.arena_bytes, arena_.high_water());
     records.obj_hist        = std::move(obj_hist);
+    records.time_hist_us    = std::move(time_hist);
 }
 }   // namespace Base
 }   // namespace OptSuite
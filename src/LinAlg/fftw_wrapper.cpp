@@ -18,6 +18,7 @@
 
 #include "OptSuite/core_n.h"
 #include "OptSuite/LinAlg/fftw_wrapper.h"
+#include "OptSuite/Utils/profiler.h"
 
 
 namespace OptSuite { namespace LinAlg { 
@@ -30,6 +31,7 @@ namespace OptSuite { namespace LinAlg {
     void FFTWManager::forward(const std::vector<ComplexScalar>& in,
                                     std::vector<ComplexScalar>& out,
                                     Index nfft){
+        OPTSUITE_PROFILE_SCOPE("FFTWManager::forward");
         if (nfft == -1) nfft = in.size();
         if (out.size() < (size_t)nfft) out.resize(nfft);
         get_plan(nfft, false, in.data(), out.data()).
@@ -38,6 +40,7 @@ namespace OptSuite { namespace LinAlg {
     void FFTWManager::backward(const std::vector<ComplexScalar>& in,
                                      std::vector<ComplexScalar>& out,
                                      Index nfft){
+        OPTSUITE_PROFILE_SCOPE("FFTWManager::backward");
         if (nfft == -1) nfft = in.size();
         if (out.size() < (size_t)nfft) out.resize(nfft);
         get_plan(nfft, true, in.data(), out.data()).
@@ -45,6 +48,7 @@ namespace OptSuite { namespace LinAlg {
     }
 
     void FFTWManager::forward(const Ref<const CMat> in, Ref<CMat> out, Index nfft){
+        OPTSUITE_PROFILE_SCOPE("FFTWManager::forward");
         if (nfft == -1) nfft = in.rows();
         Index howmany = in.cols();
         Index idist = in.outerStride(), odist = out.outerStride();
@@ -74,6 +78,7 @@ namespace OptSuite { namespace LinAlg {
 
     }
     void FFTWManager::backward(const Ref<const CMat> in, Ref<CMat> out, Index nfft){
+        OPTSUITE_PROFILE_SCOPE("FFTWManager::backward");
         if (nfft == -1) nfft = in.rows();
         Index howmany = in.cols();
         Index idist = in.outerStride(), odist = out.outerStride();
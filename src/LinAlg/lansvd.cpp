@@ -19,6 +19,7 @@
 #include "OptSuite/core_n.h"
 #include "OptSuite/Base/mat_op.h"
 #include "OptSuite/LinAlg/lansvd.h"
+#include "OptSuite/Utils/profiler.h"
 
 
 namespace OptSuite { namespace LinAlg {
@@ -78,6 +79,7 @@ namespace OptSuite { namespace LinAlg {
     template<typename T>
     void LANSVD<T>::compute_impl(int m, int n, int k, char which, APROD aprod,
             const T* dparam, const int* iparam){
+        OPTSUITE_PROFILE_SCOPE("LANSVD::compute");
         int mn_min = std::min(m, n);
 
         // check which parameter
@@ -0,0 +1,108 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  problem_gen.cpp
+ *
+ *    Description:  
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 05:58:02 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "OptSuite/core_n.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "OptSuite/LinAlg/problem_gen.h"
+
+namespace OptSuite { namespace LinAlg {
+    namespace {
+        // gaussian matrix with k columns, column j scaled by cond^(-j/(k-1))
+        Mat scaled_randn(Index rows, Index k, Scalar cond){
+            OPTSUITE_ASSERT(cond >= 1);
+            Mat A = randn(rows, k);
+            if (cond > 1 && k > 1){
+                Vec d = Vec::LinSpaced(k, 0, -std::log(cond)).array().exp();
+                A = A * d.asDiagonal();
+            }
+            return A;
+        }
+
+        // keep round(n * sparsity) random rows of x, zero out the others
+        void sparsify_rows(Ref<Mat> x, Scalar sparsity, unsigned long seed){
+            OPTSUITE_ASSERT(sparsity >= 0 && sparsity <= 1);
+            Index n = x.rows();
+            std::vector<Index> indexes(n);
+            std::iota(indexes.begin(), indexes.end(), 0);
+            std::shuffle(indexes.begin(), indexes.end(), std::mt19937(seed));
+            Index k = static_cast<Index>(std::round(n * sparsity));
+            for (Index i = k; i < n; ++i)
+                x.row(indexes[i]).setZero();
+        }
+    }
+
+    RegressionProblem gen_lasso(Index m, Index n, Scalar sparsity, Scalar cond,
+            Scalar noise, unsigned long seed){
+        return gen_group_lasso(m, n, 1, sparsity, cond, noise, seed);
+    }
+
+    RegressionProblem gen_group_lasso(Index m, Index n, Index l, Scalar sparsity,
+            Scalar cond, Scalar noise, unsigned long seed){
+        OPTSUITE_ASSERT(m > 0 && n > 0 && l > 0 && noise >= 0);
+        rng(seed);
+        RegressionProblem p;
+        p.A = scaled_randn(m, n, cond);
+        p.x_true = randn(n, l);
+        sparsify_rows(p.x_true, sparsity, seed);
+        p.b = p.A * p.x_true;
+        if (noise > 0)
+            p.b += randn(m, l, 0, noise);
+        return p;
+    }
+
+    CompletionProblem gen_low_rank_completion(Index m, Index n, Index r,
+            Scalar sample_ratio, Scalar noise, unsigned long seed){
+        OPTSUITE_ASSERT(m > 0 && n > 0 && r > 0 && r <= std::min(m, n) && noise >= 0);
+        rng(seed);
+        CompletionProblem p;
+        p.x_true = randn(m, r) * randn(r, n);
+        p.omega = sprandn(m, n, sample_ratio);
+        p.omega.makeCompressed();
+
+        p.b.resize(p.omega.nonZeros(), 1);
+        Index k = 0;
+        for (Index j = 0; j < p.omega.outerSize(); ++j)
+            for (SpMat::InnerIterator it(p.omega, j); it; ++it)
+                p.b(k++) = p.x_true(it.row(), it.col());
+        if (noise > 0)
+            p.b += randn(p.b.rows(), 1, 0, noise);
+        return p;
+    }
+
+    ClassificationProblem gen_logistic(Index m, Index n, Scalar sparsity,
+            Scalar cond, Scalar noise, unsigned long seed){
+        OPTSUITE_ASSERT(m > 0 && n > 0 && noise >= 0);
+        rng(seed);
+        ClassificationProblem p;
+        // scale the features, i.e. the rows of A
+        p.A = scaled_randn(m, n, cond).transpose();
+        p.x_true = randn(n, 1);
+        sparsify_rows(p.x_true, sparsity, seed);
+
+        Mat z = p.A.transpose() * p.x_true;
+        if (noise > 0)
+            z += randn(m, 1, 0, noise);
+        p.b = z.unaryExpr([](Scalar v) { return v >= 0 ? 1_s : -1_s; });
+        return p;
+    }
+}}
@@ -0,0 +1,95 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  arena.cpp
+ *
+ *    Description:
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 03:26:11 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <algorithm>
+#include "OptSuite/Utils/arena.h"
+
+namespace OptSuite { namespace Utils {
+    namespace {
+        thread_local Arena* bound_arena = nullptr;
+
+        inline Size round_up(Size bytes){
+            return (bytes + OPTSUITE_ARENA_ALIGN - 1) / OPTSUITE_ARENA_ALIGN * OPTSUITE_ARENA_ALIGN;
+        }
+    }
+
+    Arena::Bind::Bind(Arena& a) : prev_(bound_arena) {
+        bound_arena = &a;
+    }
+
+    Arena::Bind::~Bind(){
+        bound_arena = prev_;
+    }
+
+    Arena::Arena(Size bytes){
+        if (bytes > 0)
+            blocks_.emplace_back(round_up(bytes));
+    }
+
+    Arena& Arena::current(){
+        if (bound_arena != nullptr)
+            return *bound_arena;
+        static thread_local Arena fallback;
+        return fallback;
+    }
+
+    void* Arena::allocate(Size bytes){
+        bytes = round_up(std::max(bytes, 1_i));
+        if (blocks_.empty())
+            blocks_.emplace_back(std::max(bytes, Size(OPTSUITE_ARENA_MIN_BLOCK)));
+        if (offset_ + bytes > static_cast<Size>(blocks_[block_].size())){
+            // the next block is free, reuse it if large enough
+            Size next = block_ + 1;
+            if (next == static_cast<Size>(blocks_.size()) ||
+                    static_cast<Size>(blocks_[next].size()) < bytes){
+                // grow geometrically, the blocks after `next` are free as well
+                Size cap = std::max(bytes, capacity());
+                blocks_.insert(blocks_.begin() + next, block_t(cap));
+            }
+            block_ = next;
+            offset_ = 0;
+        }
+        void* p = blocks_[block_].data() + offset_;
+        offset_ += bytes;
+        used_ += bytes;
+        high_water_ = std::max(high_water_, used_);
+        return p;
+    }
+
+    void Arena::rewind(const Checkpoint& cp){
+        OPTSUITE_ASSERT(cp.used <= used_);
+        block_ = cp.block;
+        offset_ = cp.offset;
+        used_ = cp.used;
+        // nothing is alive: merge the blocks so that the next round fits in one
+        if (used_ == 0 && blocks_.size() > 1){
+            Size cap = capacity();
+            blocks_.clear();
+            blocks_.emplace_back(cap);
+            block_ = 0;
+            offset_ = 0;
+        }
+    }
+
+    Size Arena::capacity() const {
+        Size cap = 0;
+        for (const block_t& b : blocks_)
+            cap += b.size();
+        return cap;
+    }
+}}
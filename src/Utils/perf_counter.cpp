@@ -0,0 +1,114 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  perf_counter.cpp
+ *
+ *    Description:
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 02:31:47 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include "OptSuite/Utils/perf_counter.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace OptSuite { namespace Utils {
+    PerfCounterValues& PerfCounterValues::operator+=(const PerfCounterValues& other){
+        cycles       += other.cycles;
+        instructions += other.instructions;
+        llc_misses   += other.llc_misses;
+        return *this;
+    }
+
+    PerfCounterValues& PerfCounterValues::operator-=(const PerfCounterValues& other){
+        cycles       -= other.cycles;
+        instructions -= other.instructions;
+        llc_misses   -= other.llc_misses;
+        return *this;
+    }
+
+    PerfCounterValues operator-(PerfCounterValues a, const PerfCounterValues& b){
+        a -= b;
+        return a;
+    }
+
+#ifdef __linux__
+    namespace {
+        int open_counter(uint32_t type, uint64_t config, int group_fd){
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size           = sizeof(attr);
+            attr.type           = type;
+            attr.config         = config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP;
+            // count the calling thread on any cpu
+            return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+        }
+    }
+
+    PerfCounterGroup::PerfCounterGroup(){
+        fd_cycles_ = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (fd_cycles_ < 0)
+            return;
+        // the remaining counters are optional, e.g. LLC misses are often
+        // missing in virtual machines
+        fd_instructions_ = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, fd_cycles_);
+        fd_llc_misses_ = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, fd_cycles_);
+    }
+
+    PerfCounterGroup::~PerfCounterGroup(){
+        if (fd_llc_misses_ >= 0) close(fd_llc_misses_);
+        if (fd_instructions_ >= 0) close(fd_instructions_);
+        if (fd_cycles_ >= 0) close(fd_cycles_);
+    }
+
+    PerfCounterValues PerfCounterGroup::read() const {
+        PerfCounterValues v;
+        if (!available())
+            return v;
+
+        // layout of PERF_FORMAT_GROUP: nr, value[nr] in the order of creation
+        uint64_t buf[4] = {0, 0, 0, 0};
+        if (::read(fd_cycles_, buf, sizeof(buf)) <= 0)
+            return v;
+
+        int k = 1;
+        v.cycles = buf[k++];
+        if (fd_instructions_ >= 0 && k <= static_cast<int>(buf[0])) v.instructions = buf[k++];
+        if (fd_llc_misses_ >= 0 && k <= static_cast<int>(buf[0])) v.llc_misses = buf[k++];
+        return v;
+    }
+#else
+    PerfCounterGroup::PerfCounterGroup() {}
+    PerfCounterGroup::~PerfCounterGroup() {}
+    PerfCounterValues PerfCounterGroup::read() const { return PerfCounterValues(); }
+#endif
+
+    void PerfCounterGroup::start(){
+        start_ = read();
+    }
+
+    void PerfCounterGroup::stop(){
+        acc_ += read() - start_;
+    }
+
+    PerfCounterGroup& thread_perf_counters(){
+        thread_local PerfCounterGroup group;
+        return group;
+    }
+}}
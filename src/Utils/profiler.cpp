@@ -0,0 +1,235 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  profiler.cpp
+ *
+ *    Description:
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 09:48:02 AM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include "OptSuite/core_n.h"
+#include "OptSuite/Utils/logger.h"
+#include "OptSuite/Utils/profiler.h"
+#include "OptSuite/Utils/str_format.h"
+
+namespace OptSuite { namespace Utils {
+    ProfileNode* ProfileNode::child(const char* child_name){
+        for (auto& c : children){
+            // literals are not always merged across translation units
+            if (c->name == child_name || std::strcmp(c->name, child_name) == 0)
+                return c.get();
+        }
+        children.emplace_back(new ProfileNode(child_name, this));
+        return children.back().get();
+    }
+
+    void ProfileNode::add(time_t ns){
+        if (count == 0 || ns < min_ns) min_ns = ns;
+        if (ns > max_ns) max_ns = ns;
+        total_ns += ns;
+        ++count;
+    }
+
+    void ProfileNode::add(time_t ns, const PerfCounterValues& v){
+        add(ns);
+        counters += v;
+        ++counted;
+    }
+
+    void ProfileNode::merge(const ProfileNode& other){
+        if (other.count > 0){
+            if (count == 0 || other.min_ns < min_ns) min_ns = other.min_ns;
+            max_ns = std::max(max_ns, other.max_ns);
+            total_ns += other.total_ns;
+            count += other.count;
+        }
+        counters += other.counters;
+        counted += other.counted;
+        flops += other.flops;
+        for (const auto& c : other.children)
+            child(c->name)->merge(*c);
+    }
+
+    time_t ProfileNode::self_ns() const {
+        time_t t = total_ns;
+        for (const auto& c : children)
+            t -= c->total_ns;
+        return std::max(t, time_t(0));
+    }
+
+    double ProfileNode::total_flops() const {
+        double f = flops;
+        for (const auto& c : children)
+            f += c->total_flops();
+        return f;
+    }
+
+    namespace {
+        void report_at_exit(){
+            const Profiler& p = Profiler::instance();
+            if (p.merged_tree()->children.empty())
+                return;
+            const char* filename = std::getenv("OPTSUITE_PROFILE_OUTPUT");
+            if (filename != nullptr && filename[0] != '\0')
+                p.report_to_file(filename);
+            else {
+                Global::logger_e.log_info("\n");
+                p.report(Global::logger_e.get_stream());
+            }
+        }
+
+        bool has_hardware_data(const ProfileNode& node){
+            if (node.counted > 0 || node.flops > 0)
+                return true;
+            for (const auto& c : node.children)
+                if (has_hardware_data(*c))
+                    return true;
+            return false;
+        }
+
+        void report_node(std::ostream& out, const ProfileNode& node, int depth, bool hw){
+            std::string name = std::string(2 * depth, ' ') + node.name;
+            out << str_format("%-48s %10ld %12.3f %12.3f %10.3f %10.3f %10.3f",
+                    name.c_str(), static_cast<long>(node.count),
+                    node.total_ns * 1e-6, node.self_ns() * 1e-6,
+                    node.count > 0 ? node.total_ns * 1e-3 / node.count : 0.,
+                    node.min_ns * 1e-3, node.max_ns * 1e-3);
+            if (hw){
+                if (node.counted > 0 && node.counters.cycles > 0)
+                    out << str_format(" %6.2f %12lu", node.counters.ipc(),
+                            static_cast<unsigned long>(node.counters.llc_misses));
+                else
+                    out << str_format(" %6s %12s", "-", "-");
+
+                // flops per nanosecond is GFLOP/s
+                double f = node.total_flops();
+                if (f > 0 && node.total_ns > 0)
+                    out << str_format(" %9.3f", f / node.total_ns);
+                else
+                    out << str_format(" %9s", "-");
+            }
+            out << "\n";
+
+            // most expensive children first
+            std::vector<const ProfileNode*> sorted;
+            for (const auto& c : node.children)
+                sorted.push_back(c.get());
+            std::sort(sorted.begin(), sorted.end(),
+                    [](const ProfileNode* a, const ProfileNode* b){
+                        return a->total_ns > b->total_ns;
+                    });
+            for (const auto* c : sorted)
+                report_node(out, *c, depth + 1, hw);
+        }
+    }
+
+    Profiler::Profiler(){
+        const char* v = std::getenv("OPTSUITE_PERF_COUNTERS");
+        if (v != nullptr && v[0] != '\0' && v[0] != '0')
+            set_counters_enabled(true);
+    }
+
+    void Profiler::set_counters_enabled(bool v){
+        if (v && !thread_perf_counters().available()){
+            Global::logger_e.log_info("Hardware performance counters are not "
+                    "available. Only wall time is profiled.\n");
+            v = false;
+        }
+        counters_enabled_ = v;
+    }
+
+    Profiler& Profiler::instance(){
+        static Profiler profiler;
+        static bool registered = (std::atexit(report_at_exit) == 0);
+        (void)registered;
+        return profiler;
+    }
+
+    Profiler::ThreadState& Profiler::local_state(){
+        // the state is owned by the profiler so that the data recorded by a
+        // thread survives the thread itself
+        thread_local ThreadState* state = nullptr;
+        if (state == nullptr){
+            std::shared_ptr<ThreadState> s = std::make_shared<ThreadState>();
+            std::lock_guard<std::mutex> lock(mutex_);
+            threads_.push_back(s);
+            state = s.get();
+        }
+        return *state;
+    }
+
+    ProfileNode* Profiler::enter(const char* name){
+        ThreadState& s = local_state();
+        s.current = s.current->child(name);
+        return s.current;
+    }
+
+    void Profiler::leave(ProfileNode* node, time_t ns){
+        node->add(ns);
+        ThreadState& s = local_state();
+        // regions are strictly nested on one thread
+        OPTSUITE_ASSERT(s.current == node);
+        s.current = node->parent;
+    }
+
+    void Profiler::leave(ProfileNode* node, time_t ns, const PerfCounterValues& v){
+        node->add(ns, v);
+        ThreadState& s = local_state();
+        OPTSUITE_ASSERT(s.current == node);
+        s.current = node->parent;
+    }
+
+    void Profiler::add_flops(double f){
+        if (!enabled_)
+            return;
+        ThreadState& s = local_state();
+        s.current->flops += f;
+    }
+
+    std::unique_ptr<ProfileNode> Profiler::merged_tree() const {
+        std::unique_ptr<ProfileNode> root(new ProfileNode("<all threads>", nullptr));
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& t : threads_)
+            root->merge(t->root);
+        return root;
+    }
+
+    void Profiler::report(std::ostream& out) const {
+        std::unique_ptr<ProfileNode> root = merged_tree();
+        bool hw = has_hardware_data(*root);
+        out << str_format("%-48s %10s %12s %12s %10s %10s %10s", "region", "count",
+                "total(ms)", "self(ms)", "avg(us)", "min(us)", "max(us)");
+        if (hw)
+            out << str_format(" %6s %12s %9s", "IPC", "LLC-misses", "GFLOP/s");
+        out << "\n";
+        for (const auto& c : root->children)
+            report_node(out, *c, 0, hw);
+    }
+
+    void Profiler::report_to_file(const std::string& filename) const {
+        std::ofstream out(filename, std::ios::out);
+        report(out);
+    }
+
+    void Profiler::reset(){
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& t : threads_){
+            // no region may be open while resetting
+            OPTSUITE_ASSERT(t->current == &t->root);
+            t->root.children.clear();
+        }
+    }
+}}
@@ -0,0 +1,162 @@
+/*
+ * ==========================================================================
+ *
+ *       Filename:  thread_pool.cpp
+ *
+ *    Description:
+ *
+ *        Version:  1.0
+ *        Created:  10/19/2026 11:40:52 PM
+ *       Revision:  none
+ *       Compiler:  gcc
+ *
+ *         Author:  Haoyang Liu (@liuhy), liuhaoyang@pku.edu.cn
+ *   Organization:  BICMR, PKU
+ *
+ * ==========================================================================
+ */
+
+#include <cstdlib>
+#include "OptSuite/Utils/thread_pool.h"
+
+namespace OptSuite { namespace Utils {
+    namespace {
+        // true while the thread runs tasks of a pool
+        thread_local bool in_pool_task = false;
+    }
+
+    ThreadPool::ThreadPool(int num_threads){
+        start_workers(num_threads > 0 ? num_threads : default_num_threads());
+    }
+
+    ThreadPool::~ThreadPool(){
+        stop_workers();
+    }
+
+    ThreadPool& ThreadPool::global(){
+        static ThreadPool pool;
+        return pool;
+    }
+
+    int ThreadPool::default_num_threads(){
+        const char* env = std::getenv("OPTSUITE_NUM_THREADS");
+        if (env != nullptr && std::atoi(env) > 0)
+            return std::atoi(env);
+        unsigned hc = std::thread::hardware_concurrency();
+        return hc > 0 ? static_cast<int>(hc) : 1;
+    }
+
+    void ThreadPool::set_num_threads(int num_threads){
+        if (num_threads < 1)
+            num_threads = 1;
+        std::lock_guard<std::mutex> run(run_mutex_);
+        if (num_threads == this->num_threads())
+            return;
+        stop_workers();
+        start_workers(num_threads);
+    }
+
+    void ThreadPool::start_workers(int num_threads){
+        stop_ = false;
+        ranges_.clear();
+        for (int i = 0; i < num_threads; ++i)
+            ranges_.emplace_back(new TaskRange);
+        // the workers must not mistake the last job for a new one
+        for (int i = 1; i < num_threads; ++i)
+            workers_.emplace_back(&ThreadPool::worker_loop, this, i, generation_);
+    }
+
+    void ThreadPool::stop_workers(){
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_start_.notify_all();
+        for (auto& w : workers_)
+            w.join();
+        workers_.clear();
+    }
+
+    void ThreadPool::worker_loop(int id, unsigned long seen){
+        for (;;){
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_start_.wait(lock, [&](){ return stop_ || generation_ != seen; });
+                if (stop_)
+                    return;
+                seen = generation_;
+            }
+            in_pool_task = true;
+            run_tasks(id);
+            in_pool_task = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--active_ == 0)
+                    cv_done_.notify_one();
+            }
+        }
+    }
+
+    void ThreadPool::run_tasks(int id){
+        Index i;
+        while (take(id, i))
+            (*task_)(i);
+    }
+
+    bool ThreadPool::take(int id, Index& i){
+        int p = static_cast<int>(ranges_.size());
+        // own range from the front
+        {
+            TaskRange& r = *ranges_[id];
+            std::lock_guard<std::mutex> lock(r.mutex);
+            if (r.begin < r.end){
+                i = r.begin++;
+                return true;
+            }
+        }
+        // steal from the back of the others
+        for (int k = 1; k < p; ++k){
+            TaskRange& r = *ranges_[(id + k) % p];
+            std::lock_guard<std::mutex> lock(r.mutex);
+            if (r.begin < r.end){
+                i = --r.end;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::parallel_for(Index n, const std::function<void(Index)>& f){
+        if (n <= 0)
+            return;
+        if (n == 1 || workers_.empty() || in_pool_task || !run_mutex_.try_lock()){
+            for (Index i = 0; i < n; ++i)
+                f(i);
+            return;
+        }
+        std::lock_guard<std::mutex> run(run_mutex_, std::adopt_lock);
+
+        int p = num_threads();
+        for (int t = 0; t < p; ++t){
+            TaskRange& r = *ranges_[t];
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.begin = n * t / p;
+            r.end = n * (t + 1) / p;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &f;
+            active_ = p - 1;
+            ++generation_;
+        }
+        cv_start_.notify_all();
+
+        in_pool_task = true;
+        run_tasks(0);
+        in_pool_task = false;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_done_.wait(lock, [&](){ return active_ == 0; });
+        task_ = nullptr;
+    }
+}}
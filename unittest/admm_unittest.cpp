@@ -0,0 +1,85 @@
+/**
+ * admm_unittest.cpp
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#include "solver_test.h"
+
+namespace {
+
+using ::testing::Combine;
+using ::testing::Values;
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+using namespace OptSuite::UnitTest;
+
+class ADMMTest : public SolverTest {
+protected:
+    void SetUp() override {
+        SolverTest::SetUp();
+        options_.gap_tol(1e-8);
+        options_.maxit(5000);
+    }
+
+    SolverRecords check(FuncGrad<Scalar> &func_f, Func<Scalar> &func_h, Proximal<Scalar> &h_prox,
+                        const Mat &x0, ADMMOptions admm = ADMMOptions()) {
+        ADMMSolver    solver("ADMM", options_, admm);
+        SolverRecords records;
+        Mat           x(x0);
+        solver(x0, func_f, func_h, h_prox, 1, x, records);
+        EXPECT_GE(records.gap, 0);
+        EXPECT_LE(records.gap, 1e-8 * std::max(1_s, std::fabs(records.obj_hist.back())));
+        EXPECT_LT(records.n_iters, options_.maxit());
+        return records;
+    }
+};
+
+// the cached factorization solves (I + t A'A) y = v + t A'b
+TEST_P(ADMMTest, LeastSquaresProx) {
+    Mat  b      = randn(m_, 2);
+    Mat  v      = randn(n_, 2);
+    auto func_f = AxmbNormSqr<Scalar>(A_, b);
+    Mat  y(n_, 2);
+    for (Scalar t : {0.5, 0.5, 3.0}) {
+        func_f.prox(v, t, y);
+        Mat M    = Mat::Identity(n_, n_) + t * A_.transpose() * A_;
+        Mat want = M.ldlt().solve(v + t * A_.transpose() * b);
+        EXPECT_LE((y - want).norm(), 1e-8 * want.norm()) << "t = " << t;
+    }
+}
+
+TEST_P(ADMMTest, Lasso) {
+    Lasso p(A_);
+    check(p.func_f, p.func_h, p.h_prox, Mat::Zero(n_, 1));
+}
+
+// with no prox for f the x-update takes Newton-CG steps
+TEST_P(ADMMTest, SparseLogistic) {
+    SparseLogistic p(A_);
+    SolverRecords  records = check(p.func_f, p.func_h, p.h_prox, Mat::Zero(n_, 1));
+    EXPECT_GT(records.cg_iters, 0);
+}
+
+// residual balancing recovers from a poor initial penalty
+TEST_P(ADMMTest, AdaptivePenalty) {
+    Lasso       p(A_);
+    ADMMOptions admm;
+    admm.rho            = 1e-4;
+    SolverRecords fixed = [&] {
+        ADMMOptions off = admm;
+        off.adaptive    = false;
+        ADMMSolver    solver("ADMM", options_, off);
+        SolverRecords records;
+        Mat           x = Mat::Zero(n_, 1);
+        solver(Mat::Zero(n_, 1), p.func_f, p.func_h, p.h_prox, 1, x, records);
+        return records;
+    }();
+    SolverRecords records = check(p.func_f, p.func_h, p.h_prox, Mat::Zero(n_, 1), admm);
+    EXPECT_GT(records.rho_updates, 0);
+    EXPECT_LT(records.n_iters, fixed.n_iters);
+}
+
+INSTANTIATE_TEST_SUITE_P(ADMM, ADMMTest, Combine(Values(200), Values(100, 400)));
+
+}   // namespace
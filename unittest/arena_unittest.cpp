@@ -0,0 +1,111 @@
+/**
+ * arena_unittest.cpp
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#include "OptSuite/Utils/arena.h"
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+using namespace OptSuite;
+using namespace OptSuite::Utils;
+
+inline bool aligned(const void *p) {
+    return reinterpret_cast<std::uintptr_t>(p) % OPTSUITE_ARENA_ALIGN == 0;
+}
+
+// a scope gives back what was allocated in it, and the next allocation
+// reuses the same memory
+TEST(ArenaTest, ScopeRewind) {
+    Arena   arena(1 << 12);
+    Scalar *outer = arena.allocate<Scalar>(10);
+    Size    used  = arena.used();
+    void   *first;
+    {
+        Arena::Scope scope(arena);
+        first = arena.allocate<Scalar>(128);
+        {
+            Arena::Scope inner(arena);
+            arena.allocate<char>(1024);
+        }
+        EXPECT_EQ(arena.used(), used + 128 * sizeof(Scalar));
+    }
+    EXPECT_EQ(arena.used(), used);
+    {
+        Arena::Scope scope(arena);
+        EXPECT_EQ(arena.allocate<Scalar>(128), first);
+    }
+    EXPECT_NE(static_cast<void *>(outer), first);
+    EXPECT_GE(arena.high_water(), used + 128 * sizeof(Scalar) + 1024);
+}
+
+// once nothing is alive the blocks are merged into one that holds the
+// footprint of the last round
+TEST(ArenaTest, MergeBlocks) {
+    Arena arena(1 << 10);
+    {
+        Arena::Scope scope(arena);
+        for (int k = 0; k < 8; k++) arena.allocate<char>(1 << 10);
+        EXPECT_GT(arena.num_blocks(), 1);
+    }
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_EQ(arena.num_blocks(), 1);
+    Size cap = arena.capacity();
+    EXPECT_GE(cap, Size(8 << 10));
+    {
+        Arena::Scope scope(arena);
+        for (int k = 0; k < 8; k++) arena.allocate<char>(1 << 10);
+        EXPECT_EQ(arena.num_blocks(), 1);
+    }
+    EXPECT_EQ(arena.capacity(), cap);
+
+    // no merge while something is alive
+    arena.allocate<char>(1);
+    {
+        Arena::Scope scope(arena);
+        arena.allocate<char>(2 * cap);
+        EXPECT_EQ(arena.num_blocks(), 2);
+    }
+    EXPECT_EQ(arena.num_blocks(), 2);
+}
+
+TEST(ArenaTest, Alignment) {
+    Arena        arena;
+    Arena::Scope scope(arena);
+    for (Size n : {1, 3, 8, 17, 1000, 100000}) {
+        EXPECT_TRUE(aligned(arena.allocate<char>(n))) << n;
+        EXPECT_TRUE(aligned(arena.allocate<Scalar>(n))) << n;
+        EXPECT_TRUE(aligned(arena.vec<Scalar>(n).data())) << n;
+        EXPECT_TRUE(aligned(arena.mat<Scalar>(n, 3).data())) << n;
+    }
+}
+
+// a thread uses its own default arena until one is bound to it
+TEST(ArenaTest, Current) {
+    Arena &fallback = Arena::current();
+    EXPECT_EQ(&Arena::current(), &fallback);
+    Arena *other = nullptr;
+    std::thread([&] { other = &Arena::current(); }).join();
+    EXPECT_NE(other, &fallback);
+
+    Arena arena;
+    {
+        Arena::Bind bind(arena);
+        EXPECT_EQ(&Arena::current(), &arena);
+        {
+            Arena       nested;
+            Arena::Bind inner(nested);
+            EXPECT_EQ(&Arena::current(), &nested);
+        }
+        EXPECT_EQ(&Arena::current(), &arena);
+        // the binding is per thread
+        Arena *seen = nullptr;
+        std::thread([&] { seen = &Arena::current(); }).join();
+        EXPECT_NE(seen, &arena);
+    }
+    EXPECT_EQ(&Arena::current(), &fallback);
+}
+
+}   // namespace
@@ -0,0 +1,200 @@
+/**
+ * cd_unittest.cpp
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/Base/solver.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "OptSuite/Utils/thread_pool.h"
+#include "gtest/gtest.h"
+#include "thread_pool_guard.h"
+
+namespace {
+
+using ::testing::Combine;
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+using namespace OptSuite::UnitTest;
+using namespace OptSuite::Utils;
+
+class CDTest : public TestWithParam<::std::tuple<int32_t, int32_t>> {
+protected:
+    void SetUp() override {
+        int32_t m, n;
+        std::tie(m, n) = GetParam();
+        rng(/* seed */ 2026);
+        A_  = sprandn(m, n, 0.05);
+        b_  = randn(m, 1);
+        x0_ = Mat::Zero(n, 1);
+        options_.xtol(1e-16);
+        options_.maxit(10000);
+        options_.verbosity(Verbosity::Quiet);
+        ThreadPool::global().set_num_threads(4);
+    }
+
+    template <typename MatType>
+    Mat solve(const MatType &A, const CoordinateDescentOptions &cd, Func<Scalar> &h,
+              Proximal<Scalar> &prox) {
+        CoordinateDescentSolver solver("CD", options_, cd);
+        SolverRecords           records;
+        Mat                     x(x0_);
+        solver(x0_, A, b_, h, prox, x, records);
+        return x;
+    }
+
+    Mat solve(int num_threads, Func<Scalar> &h, Proximal<Scalar> &prox) {
+        CoordinateDescentOptions cd;
+        cd.num_threads = num_threads;
+        return solve(A_, cd, h, prox);
+    }
+
+    // x is a fixed point of x = prox_h(x - A'(Ax - b)) entry by entry
+    void expect_optimal(Proximal<Scalar> &prox, const Mat &x) {
+        Mat    g   = A_.transpose() * (A_ * x - b_);
+        Scalar tol = 1e-6 * std::max(1_s, (A_.transpose() * b_).cwiseAbs().maxCoeff());
+        for (Index j = 0; j < x.rows(); j++)
+            EXPECT_NEAR(x(j), prox.prox_entry(x(j) - g(j), 1), tol) << j;
+    }
+
+    ThreadPoolGuard pool_guard_;
+    SpMat           A_;
+    Mat             b_, x0_;
+    SolverOptions   options_;
+};
+
+// the serial solver for each coordinate update
+TEST_P(CDTest, Lasso) {
+    Scalar mu     = 0.1 * (A_.transpose() * b_).cwiseAbs().maxCoeff();
+    auto   func_h = L1Norm(mu);
+    auto   h_prox = ShrinkageL1(mu);
+    Mat    x      = solve(1, func_h, h_prox);
+    expect_optimal(h_prox, x);
+    EXPECT_GT((x.array() != 0).count(), 0);
+}
+
+TEST_P(CDTest, ElasticNet) {
+    Scalar mu     = 0.05 * (A_.transpose() * b_).cwiseAbs().maxCoeff();
+    auto   func_h = ElasticNet(mu, 0.5);
+    auto   h_prox = ShrinkageElasticNet(mu, 0.5);
+    expect_optimal(h_prox, solve(1, func_h, h_prox));
+}
+
+TEST_P(CDTest, Box) {
+    auto func_h = Zero<Scalar>();
+    auto h_prox = BoxProj(-0.1, 0.1);
+    Mat  x      = solve(1, func_h, h_prox);
+    expect_optimal(h_prox, x);
+    EXPECT_LE(x.cwiseAbs().maxCoeff(), 0.1);
+}
+
+// both ways of keeping the gradient, on a dense and on a sparse A
+TEST_P(CDTest, Updates) {
+    Scalar mu     = 0.1 * (A_.transpose() * b_).cwiseAbs().maxCoeff();
+    auto   func_h = L1Norm(mu);
+    auto   h_prox = ShrinkageL1(mu);
+    Mat    A      = Mat(A_);
+    Mat    x_ref  = solve(1, func_h, h_prox);
+    for (CDUpdate update : {CDUpdate::Residual, CDUpdate::Covariance}) {
+        CoordinateDescentOptions cd;
+        cd.update = update;
+        Mat x_sp  = solve(A_, cd, func_h, h_prox);
+        Mat x_de  = solve(A, cd, func_h, h_prox);
+        EXPECT_LE((x_sp - x_ref).norm(), 1e-6 * std::max(x_ref.norm(), 1_s));
+        EXPECT_LE((x_de - x_ref).norm(), 1e-6 * std::max(x_ref.norm(), 1_s));
+    }
+}
+
+// the asynchronous solver must reach the solution of the serial one
+TEST_P(CDTest, AsyncLasso) {
+    Scalar mu     = 0.1 * (A_.transpose() * b_).cwiseAbs().maxCoeff();
+    auto   func_h = L1Norm(mu);
+    auto   h_prox = ShrinkageL1(mu);
+    Mat    x_ser  = solve(1, func_h, h_prox);
+    for (int p : {2, 4, 0}) {
+        Mat x_par = solve(p, func_h, h_prox);
+        EXPECT_LE((x_par - x_ser).norm(), 1e-4 * std::max(x_ser.norm(), 1_s)) << p << " threads";
+    }
+}
+
+TEST_P(CDTest, AsyncElasticNet) {
+    Scalar mu     = 0.05 * (A_.transpose() * b_).cwiseAbs().maxCoeff();
+    auto   func_h = ElasticNet(mu, 0.5);
+    auto   h_prox = ShrinkageElasticNet(mu, 0.5);
+    Mat    x_ser  = solve(1, func_h, h_prox);
+    Mat    x_par  = solve(4, func_h, h_prox);
+    EXPECT_LE((x_par - x_ser).norm(), 1e-4 * std::max(x_ser.norm(), 1_s));
+}
+
+// the asynchronous solver honors the order and the active set options
+TEST_P(CDTest, AsyncOptions) {
+    Scalar mu     = 0.1 * (A_.transpose() * b_).cwiseAbs().maxCoeff();
+    auto   func_h = L1Norm(mu);
+    auto   h_prox = ShrinkageL1(mu);
+    Mat    x_ser  = solve(1, func_h, h_prox);
+    for (bool active_set : {false, true}) {
+        for (bool shuffle : {false, true}) {
+            CoordinateDescentOptions cd;
+            cd.num_threads = 4;
+            cd.active_set  = active_set;
+            cd.shuffle     = shuffle;
+            Mat x_par      = solve(A_, cd, func_h, h_prox);
+            EXPECT_LE((x_par - x_ser).norm(), 1e-4 * std::max(x_ser.norm(), 1_s))
+                << active_set << shuffle;
+        }
+    }
+}
+
+// the coordinates dropped by the gap-safe test are zero at the solution
+TEST_P(CDTest, GapSafeScreening) {
+    Scalar mu     = 0.3 * (A_.transpose() * b_).cwiseAbs().maxCoeff();
+    auto   func_h = L1Norm(mu);
+    auto   h_prox = ShrinkageL1(mu);
+
+    CoordinateDescentOptions cd;
+    cd.active_set = false;
+    options_.screening(10);
+    CoordinateDescentSolver solver("CD", options_, cd);
+    SolverRecords           records;
+    Mat                     x(x0_);
+    solver(x0_, A_, b_, func_h, h_prox, x, records);
+    EXPECT_GT(records.screened, 0);
+
+    options_.screening(0);
+    CoordinateDescentSolver reference("CD", options_, cd);
+    Mat                     y(x0_);
+    SolverRecords           ref_records;
+    reference(x0_, A_, b_, func_h, h_prox, y, ref_records);
+    EXPECT_EQ(ref_records.screened, 0);
+    EXPECT_LE((x - y).norm(), 1e-6 * std::max(y.norm(), 1_s));
+}
+
+// the path starts at zero and ends at the solution of a single solve
+TEST_P(CDTest, RegularizationPath) {
+    PathOptions path_options;
+    path_options.num_lambdas      = 30;
+    path_options.lambda_min_ratio = 0.05;
+    path_options.l1_ratio         = 0.8;
+    RegularizationPathSolver solver("Path", options_, path_options);
+    RegularizationPath       path;
+    SolverRecords            records;
+    solver(A_, b_, path, records);
+    ASSERT_EQ(path.lambdas.size(), 30);
+    ASSERT_EQ(path.coefs.cols(), 30);
+    EXPECT_EQ(Mat(path.coefs.col(0)).cwiseAbs().maxCoeff(), 0);
+    for (Index k = 1; k < 30; k++) EXPECT_LT(path.lambdas[k], path.lambdas[k - 1]);
+
+    Scalar lambda = path.lambdas[29];
+    auto   func_h = ElasticNet(0.8 * lambda, 0.2 * lambda);
+    auto   h_prox = ShrinkageElasticNet(0.8 * lambda, 0.2 * lambda);
+    Mat    x      = solve(1, func_h, h_prox);
+    EXPECT_LE((Mat(path.coefs.col(29)) - x).norm(), 1e-4 * std::max(x.norm(), 1_s));
+}
+
+INSTANTIATE_TEST_SUITE_P(CoordinateDescent, CDTest,
+                         Combine(Values(200, 1000), Values(100, 2000)));
+
+}   // namespace
@@ -0,0 +1,107 @@
+/**
+ * gap_unittest.cpp
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#include "solver_test.h"
+
+namespace {
+
+using ::testing::Combine;
+using ::testing::Values;
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+using namespace OptSuite::UnitTest;
+
+class GapTest : public SolverTest {
+protected:
+    void SetUp() override {
+        SolverTest::SetUp();
+        options_.ftol(0);
+        options_.maxit(20000);
+        options_.step_size_strategy(StepSizeStrategy::Fixed);
+    }
+
+    // runs to gap_tol and checks the certificate against a longer run
+    template <typename F>
+    void check(F &func_f, Func<Scalar> &func_h, Proximal<Scalar> &h_prox, Scalar L,
+               const Mat &x0) {
+        options_.fixed(FixedStepSize(1 / L));
+        options_.gap_tol(1e-6);
+        ProximalGradSolver solver("ProxGrad", options_);
+        SolverRecords      records;
+        Mat                x(x0);
+        solver(x0, func_f, func_h, h_prox, 1, x, records);
+        ASSERT_GE(records.gap, 0);
+        Scalar obj = records.obj_hist.back();
+        EXPECT_LE(records.gap, 1e-6 * std::max(1_s, std::fabs(obj)));
+        EXPECT_LT(records.n_iters, options_.maxit());
+
+        options_.gap_tol(1e-12);
+        ProximalGradSolver reference("ProxGrad", options_);
+        SolverRecords      ref_records;
+        Mat                y(x0);
+        reference(x0, func_f, func_h, h_prox, 1, y, ref_records);
+        // the gap bounds the distance to the optimal value
+        Scalar opt = ref_records.obj_hist.back() - ref_records.gap;
+        EXPECT_GE(obj - opt, -1e-10 * std::max(1_s, std::fabs(obj)));
+        EXPECT_LE(obj - opt, records.gap + 1e-10 * std::max(1_s, std::fabs(obj)));
+    }
+
+    // the screened solve drops rows and reaches the unscreened solution
+    void check_screening(AxmbNormSqr<Scalar> &func_f, Func<Scalar> &func_h,
+                         Proximal<Scalar> &h_prox, Scalar L, const Mat &x0) {
+        options_.fixed(FixedStepSize(1 / L));
+        options_.gap_tol(1e-10);
+        Mat           x(x0), y(x0);
+        SolverRecords records, ref_records;
+        ProximalGradSolver("ProxGrad", options_)(x0, func_f, func_h, h_prox, 1, y, ref_records);
+        EXPECT_EQ(ref_records.screened, 0);
+
+        options_.screening(10);
+        ProximalGradSolver("ProxGrad", options_)(x0, func_f, func_h, h_prox, 1, x, records);
+        EXPECT_GT(records.screened, 0);
+        EXPECT_LE(records.gap, 1e-10 * std::max(1_s, std::fabs(records.obj_hist.back())));
+        EXPECT_LE((x - y).norm(), 1e-4 * std::max(1_s, y.norm()));
+        // func_f is given all columns back
+        Mat g(x0), g_ref(x0);
+        Mat z = randn(x0.rows(), x0.cols());
+        EXPECT_EQ(func_f(z, g, true), AxmbNormSqr<Scalar>(A_, func_f.get_b())(z, g_ref, true));
+        EXPECT_EQ(g, g_ref);
+    }
+};
+
+TEST_P(GapTest, Lasso) {
+    Lasso p(A_);
+    check(p.func_f, p.func_h, p.h_prox, lipschitz(A_), Mat::Zero(n_, 1));
+}
+
+TEST_P(GapTest, GroupLasso) {
+    GroupLasso p(A_);
+    check(p.func_f, p.func_h, p.h_prox, lipschitz(A_), Mat::Zero(n_, 3));
+}
+
+TEST_P(GapTest, L2Ball) {
+    L2Ball p(A_);
+    check(p.func_f, p.func_h, p.h_prox, lipschitz(A_), Mat::Zero(n_, 1));
+}
+
+TEST_P(GapTest, SparseLogistic) {
+    SparseLogistic p(A_);
+    check(p.func_f, p.func_h, p.h_prox, lipschitz(p.A) / (4 * m_), Mat::Zero(n_, 1));
+}
+
+TEST_P(GapTest, ScreeningLasso) {
+    Lasso p(A_, 0.3);
+    check_screening(p.func_f, p.func_h, p.h_prox, lipschitz(A_), Mat::Zero(n_, 1));
+}
+
+TEST_P(GapTest, ScreeningGroupLasso) {
+    GroupLasso p(A_, 0.3);
+    check_screening(p.func_f, p.func_h, p.h_prox, lipschitz(A_), Mat::Zero(n_, 3));
+}
+
+INSTANTIATE_TEST_SUITE_P(DualityGap, GapTest, Combine(Values(100), Values(50, 300)));
+
+}   // namespace
@@ -0,0 +1,233 @@
+/**
+ * group_unittest.cpp
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/Base/group_index.h"
+#include "OptSuite/Base/solver.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "OptSuite/Utils/thread_pool.h"
+#include "gtest/gtest.h"
+#include "thread_pool_guard.h"
+#include <algorithm>
+#include <random>
+
+namespace {
+
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+using namespace OptSuite::UnitTest;
+using namespace OptSuite::Utils;
+
+// n rows in groups of 1 to 8 random rows each, a tenth of them in no group
+GroupIndex random_groups(Index n, bool overlap) {
+    std::mt19937       gen(2026);
+    std::vector<Index> rows(n);
+    std::iota(rows.begin(), rows.end(), 0);
+    std::shuffle(rows.begin(), rows.end(), gen);
+    std::vector<std::vector<Index>> groups;
+    for (Index i = n / 10; i < n;) {
+        Index m = std::min<Index>(1 + gen() % 8, n - i);
+        groups.emplace_back(rows.begin() + i, rows.begin() + i + m);
+        if (overlap) groups.back().push_back(rows[gen() % n]);
+        i += m;
+    }
+    if (overlap)
+        for (Index i = 0; i < n / 10; i++) groups.push_back({rows[i]});
+    return GroupIndex(n, groups);
+}
+
+class GroupTest : public TestWithParam<int32_t> {
+protected:
+    void SetUp() override {
+        n_ = GetParam();
+        rng(/* seed */ 2026);
+        x_ = randn(n_, 2);
+    }
+
+    int32_t n_;
+    Mat     x_;
+};
+
+TEST_P(GroupTest, Structure) {
+    GroupIndex disjoint = random_groups(n_, false);
+    EXPECT_FALSE(disjoint.overlapping());
+    EXPECT_EQ(disjoint.covering(), n_ < 10);
+    EXPECT_EQ(disjoint.latent_dim(), n_ - n_ / 10);
+
+    std::vector<Index> labels(n_);
+    for (Index i = 0; i < n_; i++) labels[i] = i / 3;
+    GroupIndex blocks = GroupIndex::from_labels(labels);
+    EXPECT_EQ(blocks.num_groups(), (n_ + 2) / 3);
+    EXPECT_TRUE(blocks.contiguous());
+    EXPECT_TRUE(blocks.covering());
+
+    // A D v = A x for x = D v
+    GroupIndex overlap = random_groups(n_, true);
+    EXPECT_TRUE(overlap.overlapping() || n_ < 10);
+    Mat A = randn(5, n_);
+    Mat v = randn(overlap.latent_dim(), 2);
+    Mat x(n_, 2);
+    overlap.collapse(v, x);
+    EXPECT_LE((overlap.duplicate_columns(A) * v - A * x).norm(), 1e-12 * (1 + x.norm()));
+}
+
+// the prox of arbitrary groups against a direct loop over the groups
+TEST_P(GroupTest, DisjointProx) {
+    GroupIndex groups  = random_groups(n_, false);
+    Vec        weights = randn(groups.num_groups(), 1).cwiseAbs();
+    Scalar     mu = 0.5, t = 2;
+    ShrinkageGroupL2 prox(groups, mu, weights);
+    GroupL2Norm      func(groups, mu, weights);
+    Mat              y(n_, 2);
+    prox(x_, t, y);
+
+    Mat    want = x_;
+    Scalar h    = 0;
+    for (Index g = 0; g < groups.num_groups(); g++) {
+        Scalar xn = 0;
+        for (Index k = groups.ptr(g); k < groups.ptr(g + 1); k++)
+            xn += x_.row(groups.index(k)).squaredNorm();
+        xn       = std::sqrt(xn);
+        h       += mu * weights(g) * xn;
+        Scalar a = std::max(0_s, 1 - t * mu * weights(g) / xn);
+        for (Index k = groups.ptr(g); k < groups.ptr(g + 1); k++)
+            want.row(groups.index(k)) *= a;
+    }
+    EXPECT_LE((y - want).norm(), 1e-12 * want.norm());
+    EXPECT_NEAR(func(x_), h, 1e-12 * h);
+
+    // in place
+    y = x_;
+    prox(y, t, y);
+    EXPECT_LE((y - want).norm(), 1e-12 * want.norm());
+}
+
+// rows as groups give ShrinkageL2Rowwise
+TEST_P(GroupTest, Rows) {
+    std::vector<Index> labels(n_);
+    std::iota(labels.begin(), labels.end(), 0);
+    GroupIndex         groups = GroupIndex::from_labels(labels);
+    ShrinkageGroupL2   prox(groups, 0.7);
+    ShrinkageL2Rowwise rowwise(0.7);
+    Mat                y(n_, 2), z(n_, 2);
+    prox(x_, 1, y);
+    rowwise(x_, 1, z);
+    EXPECT_LE((y - z).norm(), 1e-12 * (1 + z.norm()));
+    EXPECT_NEAR(GroupL2Norm(groups, 0.7)(x_), L1_2Norm(0.7)(x_), 1e-10 * n_);
+}
+
+TEST_P(GroupTest, ParallelProx) {
+    ThreadPoolGuard guard;
+    GroupIndex       groups = random_groups(n_, false);
+    ShrinkageGroupL2 prox(groups, 0.3);
+    Mat              x = randn(n_, 16), y(n_, 16), z(n_, 16);
+    ThreadPool::global().set_num_threads(1);
+    prox(x, 1, y);
+    ThreadPool::global().set_num_threads(4);
+    prox(x, 1, z);
+    EXPECT_EQ(y, z);
+}
+
+// the latent group lasso on duplicated columns reaches a certified gap
+TEST_P(GroupTest, OverlappingLasso) {
+    Index      n      = std::min<Index>(n_, 400);
+    GroupIndex groups = random_groups(n, true);
+    Mat        A      = randn(n / 2 + 1, n);
+    Mat        b      = randn(n / 2 + 1, 1);
+    Mat        AD     = groups.duplicate_columns(A);
+    Scalar     mu     = 0.2 * (A.transpose() * b).cwiseAbs().maxCoeff();
+    auto       func_f = AxmbNormSqr<Scalar>(AD, b);
+    auto       func_h = GroupL2Norm(groups, mu);
+    auto       h_prox = ShrinkageGroupL2(groups, mu);
+
+    SolverOptions options;
+    options.gtol(0);
+    options.gap_tol(1e-10);
+    options.maxit(200);
+    options.verbosity(Verbosity::Quiet);
+    SemismoothNewtonSolver solver("SSN", options);
+    SolverRecords          records;
+    Mat                    v0 = Mat::Zero(groups.latent_dim(), 1), v(v0);
+    solver(v0, func_f, func_h, h_prox, 1, v, records);
+    ASSERT_GE(records.gap, 0);
+    EXPECT_LE(records.gap, 1e-10 * std::max(1_s, std::fabs(records.obj_hist.back())));
+    Mat x(n, 1);
+    groups.collapse(v, x);
+    EXPECT_LE((A * x - AD * v).norm(), 1e-10 * (1 + b.norm()));
+}
+
+// the rows in no group kept free as groups of zero weight, see GroupIndex
+TEST_P(GroupTest, FreeRows) {
+    Index      n       = std::min<Index>(n_, 400);
+    GroupIndex partial = random_groups(n, false);
+    std::vector<std::vector<Index>> rows(partial.num_groups());
+    std::vector<bool>               covered(n, false);
+    for (Index g = 0; g < partial.num_groups(); g++)
+        for (Index k = partial.ptr(g); k < partial.ptr(g + 1); k++) {
+            rows[g].push_back(partial.index(k));
+            covered[partial.index(k)] = true;
+        }
+    for (Index i = 0; i < n; i++)
+        if (!covered[i]) rows.push_back({i});
+    GroupIndex groups(n, rows);
+    Vec        weights = Vec::Ones(groups.num_groups());
+    weights.tail(groups.num_groups() - partial.num_groups()).setZero();
+    ASSERT_TRUE(groups.covering());
+
+    Mat    A      = randn(n / 2 + 1, n);
+    Mat    b      = randn(n / 2 + 1, 1);
+    Scalar mu     = 0.2 * (A.transpose() * b).cwiseAbs().maxCoeff();
+    auto   func_f = AxmbNormSqr<Scalar>(A, b);
+    auto   func_h = GroupL2Norm(groups, mu, weights);
+    auto   h_prox = ShrinkageGroupL2(groups, mu, weights);
+    // the free groups count once g vanishes on them, until then only s = 0
+    // keeps the conjugate finite
+    Mat g = randn(n, 1);
+    for (Index i = 0; i < n; i++)
+        if (!covered[i]) g(i) = 0;
+    Scalar s = h_prox.dual_scale(g);
+    EXPECT_GT(s, 0);
+    EXPECT_EQ(s, ShrinkageGroupL2(partial, mu).dual_scale(g));
+    if (partial.num_groups() < groups.num_groups()) {
+        for (Index i = 0; i < n; i++)
+            if (!covered[i]) g(i) = 1e-3;
+        EXPECT_EQ(h_prox.dual_scale(g), 0);
+    }
+
+    SolverOptions options;
+    options.gtol(0);
+    options.gap_tol(1e-10);
+    options.maxit(200);
+    options.verbosity(Verbosity::Quiet);
+    SemismoothNewtonSolver solver("SSN", options);
+    SolverRecords          records;
+    Mat                    x0 = Mat::Zero(n, 1), x(x0);
+    solver(x0, func_f, func_h, h_prox, 1, x, records);
+    ASSERT_GE(records.gap, 0);
+    Scalar obj = records.obj_hist.back();
+    EXPECT_LE(records.gap, 1e-10 * std::max(1_s, std::fabs(obj)));
+    // the free rows are not shrunk: A'(Ax - b) vanishes on them
+    Mat grad = A.transpose() * (A * x - b);
+    for (Index i = 0; i < n; i++)
+        if (!covered[i]) {
+            EXPECT_NEAR(grad(i), 0, 1e-8 * (1 + b.norm())) << i;
+        }
+
+    // the approximate gap still bounds the distance to a longer run here
+    options.gap_tol(0);
+    options.gtol(1e-13);
+    SemismoothNewtonSolver reference("SSN", options);
+    SolverRecords          ref_records;
+    Mat                    y(x0);
+    reference(x0, func_f, func_h, h_prox, 1, y, ref_records);
+    EXPECT_LE(obj - ref_records.obj_hist.back(), records.gap + 1e-12 * std::max(1_s, obj));
+}
+
+INSTANTIATE_TEST_SUITE_P(Groups, GroupTest, Values(1, 50, 5000));
+
+}   // namespace
@@ -92,5 +92,62 @@ int main(int argc, char **argv) {
         Utils::Global::logger_e.log_info(std::left, std::setw(10), ", Sparsity: ", std::fixed,
                                          std::setprecision(5), sparsity(result));
     }
+    /* the same problem on a regularization path by coordinate descent */ {
+        Base::SolverOptions options{};
+        options.xtol(1e-12);
+        options.maxit(100000);
+        options.verbosity(Verbosity::Info);
+        Base::PathOptions path_options;
+        path_options.num_lambdas      = 20;
+        path_options.lambda_min_ratio = mu / (A.mat().transpose() * b.mat()).cwiseAbs().maxCoeff();
+        Base::RegularizationPathSolver solver("Regularization Path", options, path_options);
+        Base::RegularizationPath       path;
+        Base::SolverRecords            records;
+
+        Utils::Global::logger_e.log_info("\n");
+        Utils::Global::logger_o.log_info("=======================\n");
+        solver(A.mat(), b.mat(), path, records);
+        Base::MatWrapper<Scalar> result(Mat(path.coefs.col(path_options.num_lambdas - 1)));
+        Utils::Global::logger_o.log_info(std::left, std::setw(10), "Sweeps: ", std::left,
+                                         records.n_iters);
+        Utils::Global::logger_o.log_info(std::left, std::setw(10), ", Elapsed time: ", std::left,
+                                         std::setprecision(6), records.elapsed_time_us / 1e6);
+        Utils::Global::logger_e.log_info(std::left, std::setw(10), ", Err-exact: ", std::left,
+                                         std::scientific, err_exact(result));
+        Utils::Global::logger_e.log_info(std::left, std::setw(10), ", Sparsity: ", std::fixed,
+                                         std::setprecision(5), sparsity(result));
+    }
+    /* the same problem to a duality gap of 1e-10 by semismooth Newton */ {
+        auto                     func_f = Base::AxmbNormSqr<Scalar>(A.mat(), b.mat());
+        auto                     func_h = Base::L1Norm(mu);
+        Base::MatWrapper<Scalar> x0;
+        x0.set_zero_like(u);
+        Base::MatWrapper<Scalar> result(x0);
+        Base::SolverOptions      options{};
+        options.gtol(0);
+        options.gap_tol(1e-10);
+        options.maxit(1000);
+        options.verbosity(Verbosity::Info);
+        Base::SemismoothNewtonSolver solver("Semismooth Newton", options);
+        Base::SolverRecords          records;
+
+        Utils::Global::logger_e.log_info("\n");
+        Utils::Global::logger_o.log_info("=======================\n");
+        for (Scalar t : {100, 10, 1}) {
+            auto h_prox = Base::ShrinkageL1(mu * t);
+            solver(x0.mat(), func_f, func_h, h_prox, t, result.mat(), records);
+            x0.mat() = result.mat();
+        }
+        Utils::Global::logger_o.log_info(std::left, std::setw(10), "Iters: ", std::left,
+                                         records.n_iters);
+        Utils::Global::logger_o.log_info(", CG iters: ", records.cg_iters);
+        Utils::Global::logger_o.log_info(std::left, std::setw(10), ", Elapsed time: ", std::left,
+                                         std::setprecision(6), records.elapsed_time_us / 1e6);
+        Utils::Global::logger_o.log_info(", Gap: ", std::scientific, records.gap);
+        Utils::Global::logger_e.log_info(std::left, std::setw(10), ", Err-exact: ", std::left,
+                                         std::scientific, err_exact(result));
+        Utils::Global::logger_e.log_info(std::left, std::setw(10), ", Sparsity: ", std::fixed,
+                                         std::setprecision(5), sparsity(result));
+    }
     return 0;
 }
\ No newline at end of file
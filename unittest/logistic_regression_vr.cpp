@@ -0,0 +1,90 @@
+/**
+ * File              : logistic_regression_vr.cpp
+ * Author            : Haoyang Liu <liuhaoyang@pku.edu.cn>
+ * Date              : 10.19.2026
+ * Last Modified Date: 10.19.2026
+ * Last Modified By  : Haoyang Liu <liuhaoyang@pku.edu.cn>
+ */
+
+#include "OptSuite/Base/mat_wrapper.h"
+#include "OptSuite/Base/solver.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "OptSuite/Utils/logger.h"
+#include "OptSuite/core_n.h"
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+
+using namespace OptSuite;
+using namespace OptSuite::Utils;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+
+// l1-regularized logistic regression on a tall data set, solved by
+// prox-SVRG and prox-SAGA
+int main(int argc, char **argv) {
+    Index                    m = 100000, n = 64;
+    Base::MatWrapper<Scalar> A, b;
+    Scalar                   mu = 1e-3;
+
+    rng(/* seed */ 114514);
+
+    A.mat() = randn(n, m);
+    b.mat() = randn(m, 1);
+    for (Index i = 0; i < m; i++)
+        b.mat().coeffRef(i) = (rand() % 2 == 0 ? 1 : -1);
+    auto sparsity = [&](const Mat &x) {
+        Scalar thre = 1e-6 * x.array().abs().maxCoeff();
+        return 1.0 * (x.array().abs() > thre).count() / n;
+    };
+
+    auto   func_f = Base::LogisticRegression<Scalar>(A.mat(), b.mat());
+    auto   func_h = Base::L1Norm(mu);
+    auto   h_prox = Base::ShrinkageL1(mu);
+    Mat    x0     = Mat::Zero(n, 1);
+    // f = sum_i f_i with f_i = log(1 + exp(-b_i a_i' x)) / m, so that
+    // m * f_i is ||a_i||^2 / 4 smooth
+    Scalar L_max = A.mat().colwise().squaredNorm().maxCoeff() / 4;
+
+    Base::SolverOptions options{};
+    options.ftol(1e-8);
+    options.maxit(50);
+    options.min_lasting_iters(3);
+    options.step_size_strategy(Base::StepSizeStrategy::Fixed);
+    options.verbosity(Verbosity::Debug);
+    Base::StochasticOptions stoch;
+    stoch.batch_size = 16;
+
+    auto report = [&](const char *name, const Base::SolverRecords &records, const Mat &x) {
+        Utils::Global::logger_o.log_info(name, ": ");
+        Utils::Global::logger_o.log_info(std::left, std::setw(10), "Epochs: ", std::left,
+                                         records.n_iters);
+        Utils::Global::logger_o.log_info(", Passes: ", std::fixed, std::setprecision(1),
+                                         records.data_passes);
+        Utils::Global::logger_o.log_info(", Elapsed time: ", std::setprecision(6),
+                                         records.elapsed_time_us / 1e6);
+        Utils::Global::logger_o.log_info(", Obj: ", std::scientific, records.obj_hist.back());
+        Utils::Global::logger_o.log_info(", Sparsity: ", std::fixed, std::setprecision(5),
+                                         sparsity(x), "\n");
+    };
+
+    {
+        Base::SolverRecords records;
+        Mat                 result(x0);
+        options.fixed(Base::FixedStepSize(1 / (4 * L_max)));
+        Base::ProxSVRGSolver solver("Prox-SVRG", options, stoch);
+        solver(x0, func_f, func_h, h_prox, 1, result, records);
+        report("Prox-SVRG", records, result);
+    }
+    {
+        Base::SolverRecords records;
+        Mat                 result(x0);
+        options.fixed(Base::FixedStepSize(1 / (3 * L_max)));
+        Base::ProxSAGASolver solver("Prox-SAGA", options, stoch);
+        solver(x0, func_f, func_h, h_prox, 1, result, records);
+        report("Prox-SAGA", records, result);
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * newton_unittest.cpp
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#include "solver_test.h"
+
+namespace {
+
+using ::testing::Combine;
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+using namespace OptSuite::UnitTest;
+
+class NewtonTest : public SolverTest {
+protected:
+    void SetUp() override {
+        SolverTest::SetUp();
+        options_.gtol(0);
+        options_.gap_tol(1e-10);
+        options_.maxit(100);
+    }
+
+    // the Newton solver must certify 1e-10 in a few dozen iterations
+    void check(FuncGrad<Scalar> &func_f, Func<Scalar> &func_h, Proximal<Scalar> &h_prox,
+               const Mat &x0) {
+        SemismoothNewtonSolver solver("SSN", options_);
+        SolverRecords          records;
+        Mat                    x(x0);
+        solver(x0, func_f, func_h, h_prox, 1, x, records);
+        ASSERT_GE(records.gap, 0);
+        EXPECT_LE(records.gap, 1e-10 * std::max(1_s, std::fabs(records.obj_hist.back())));
+        EXPECT_LE(records.n_iters, 50);
+    }
+};
+
+TEST_P(NewtonTest, Lasso) {
+    Lasso p(A_);
+    check(p.func_f, p.func_h, p.h_prox, Mat::Zero(n_, 1));
+}
+
+TEST_P(NewtonTest, GroupLasso) {
+    GroupLasso p(A_);
+    check(p.func_f, p.func_h, p.h_prox, Mat::Zero(n_, 3));
+}
+
+TEST_P(NewtonTest, L2Ball) {
+    L2Ball p(A_);
+    check(p.func_f, p.func_h, p.h_prox, Mat::Zero(n_, 1));
+}
+
+TEST_P(NewtonTest, SparseLogistic) {
+    SparseLogistic p(A_);
+    check(p.func_f, p.func_h, p.h_prox, Mat::Zero(n_, 1));
+}
+
+// a warm start at the solution stops on the first pass, certified
+TEST_P(NewtonTest, WarmStart) {
+    Lasso                  p(A_);
+    SemismoothNewtonSolver solver("SSN", options_);
+    SolverRecords          records, warm_records;
+    Mat                    x0 = Mat::Zero(n_, 1), x(x0), y(x0);
+    solver(x0, p.func_f, p.func_h, p.h_prox, 1, x, records);
+    solver(x, p.func_f, p.func_h, p.h_prox, 1, y, warm_records);
+    EXPECT_EQ(warm_records.n_iters, 0);
+    ASSERT_GE(warm_records.gap, 0);
+    EXPECT_LE(warm_records.gap, 1e-10 * std::max(1_s, std::fabs(warm_records.obj_hist.back())));
+    EXPECT_LE((x - y).norm(), 1e-8 * std::max(1_s, x.norm()));
+}
+
+INSTANTIATE_TEST_SUITE_P(SemismoothNewton, NewtonTest,
+                         Combine(Values(200), Values(100, 1000)));
+
+// the generalized Jacobians against finite differences at a random point,
+// where the operators are differentiable
+class JacobianTest : public TestWithParam<int32_t> {
+protected:
+    void SetUp() override {
+        n_ = GetParam();
+        rng(/* seed */ 2026);
+        x_ = randn(n_, 1);
+    }
+
+    void check(Proximal<Scalar> &prox, Scalar t) {
+        ASSERT_TRUE(prox.has_jacobian());
+        Mat    p(n_, 1), q(n_, 1), y(n_, 1), z(n_, 1);
+        Mat    v = randn(n_, 1), w = randn(n_, 1);
+        Scalar eps = 1e-7;
+        prox(x_, t, p);
+        prox(x_ + eps * v, t, q);
+        prox.jacobian(x_, p, t, v, y);
+        EXPECT_LE((y - (q - p) / eps).norm(), 1e-5 * v.norm());
+        // symmetric with 0 <= D <= I
+        prox.jacobian(x_, p, t, w, z);
+        EXPECT_NEAR(w.cwiseProduct(y).sum(), v.cwiseProduct(z).sum(), 1e-10 * v.norm() * w.norm());
+        EXPECT_GE(v.cwiseProduct(y).sum(), -1e-12 * v.squaredNorm());
+        EXPECT_LE(v.cwiseProduct(y).sum(), v.squaredNorm() * (1 + 1e-12));
+    }
+
+    int32_t n_;
+    Mat     x_;
+};
+
+// the radii cut x, so that the projections are not the identity
+TEST_P(JacobianTest, L1Ball) {
+    L1NormBallProj<Scalar> prox(0.3 * x_.cwiseAbs().sum());
+    check(prox, 1);
+}
+
+TEST_P(JacobianTest, LInfBall) {
+    LInfBallProj<Scalar> prox(0.5 * x_.cwiseAbs().maxCoeff());
+    check(prox, 1);
+}
+
+TEST_P(JacobianTest, Box) {
+    BoxProj prox(-0.5, 0.8);
+    check(prox, 1);
+}
+
+TEST_P(JacobianTest, ElasticNet) {
+    ShrinkageElasticNet prox(0.4, 0.5);
+    check(prox, 2);
+}
+
+TEST_P(JacobianTest, Simplex) {
+    SimplexProj<Scalar> prox(2);
+    check(prox, 1);
+}
+
+TEST_P(JacobianTest, WeightedL1Ball) {
+    Vec                            w = randn(n_, 1).cwiseAbs().array() + 0.1;
+    WeightedL1NormBallProj<Scalar> prox(w, 0.3 * w.cwiseProduct(x_).cwiseAbs().sum());
+    check(prox, 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(Jacobian, JacobianTest, Values(1, 10, 1000));
+
+}   // namespace
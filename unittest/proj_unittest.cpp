@@ -0,0 +1,167 @@
+/**
+ * proj_unittest.cpp
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "OptSuite/Utils/thread_pool.h"
+#include "gtest/gtest.h"
+#include "thread_pool_guard.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+using namespace OptSuite::UnitTest;
+using namespace OptSuite::Utils;
+
+// the tau with sum_i max(a_i - tau, 0) = radius by sorting a
+Scalar sorted_threshold(Vec a, Scalar radius) {
+    std::sort(a.data(), a.data() + a.size(), std::greater<Scalar>());
+    Scalar sum = 0, tau = 0;
+    for (Index i = 0; i < a.size(); i++) {
+        sum += a(i);
+        if (a(i) <= (sum - radius) / (i + 1)) break;
+        tau = (sum - radius) / (i + 1);
+    }
+    return tau;
+}
+
+// y keeps k entries of every column of x, none of them smaller than a dropped one
+void expect_top_k(const Mat &x, const Mat &y, Index k) {
+    for (Index j = 0; j < x.cols(); j++) {
+        Scalar kept = INFINITY, dropped = 0;
+        Index  count = 0;
+        for (Index i = 0; i < x.rows(); i++) {
+            if (y(i, j) != 0) {
+                EXPECT_EQ(y(i, j), x(i, j));
+                kept = std::min(kept, std::fabs(x(i, j)));
+                count++;
+            } else {
+                dropped = std::max(dropped, std::fabs(x(i, j)));
+            }
+        }
+        EXPECT_EQ(count, std::min(k, x.rows())) << "column " << j;
+        EXPECT_GE(kept, dropped) << "column " << j;
+    }
+}
+
+class ProjTest : public TestWithParam<int32_t> {
+protected:
+    void SetUp() override {
+        n_ = GetParam();
+        rng(/* seed */ 2026);
+        x_ = randn(n_, 1);
+        // repeated entries
+        for (Index i = 0; i + 1 < n_; i += 7) x_(i + 1) = -x_(i);
+    }
+
+    int32_t n_;
+    Mat     x_;
+};
+
+TEST_P(ProjTest, L1Ball) {
+    Mat y(n_, 1);
+    for (Scalar mu : {1e-8, 0.5, 3.0, 1e10}) {
+        L1NormBallProj<Scalar> proj(mu);
+        proj(x_, 1, y);
+        Mat want = x_;
+        if (x_.lpNorm<1>() > mu) {
+            Scalar tau = sorted_threshold(x_.cwiseAbs(), mu);
+            want       = x_.array().sign() * (x_.array().abs() - tau).max(0);
+        }
+        EXPECT_LE((y - want).lpNorm<Eigen::Infinity>(), 1e-12 * std::max(1_s, mu)) << mu;
+        EXPECT_LE(y.lpNorm<1>(), mu + 1e-12 * x_.lpNorm<1>());
+    }
+}
+
+TEST_P(ProjTest, Simplex) {
+    Mat y(n_, 1);
+    for (Scalar radius : {1e-8, 1.0, 1e4}) {
+        SimplexProj<Scalar> proj(radius);
+        proj(x_, 1, y);
+        Scalar tau  = sorted_threshold(x_, radius);
+        Mat    want = (x_.array() - tau).max(0);
+        EXPECT_LE((y - want).lpNorm<Eigen::Infinity>(), 1e-12 * std::max(1_s, radius)) << radius;
+        EXPECT_NEAR(y.sum(), radius, 1e-12 * std::max(1_s, radius));
+        EXPECT_GE(y.minCoeff(), 0);
+    }
+}
+
+TEST_P(ProjTest, WeightedL1Ball) {
+    Mat y(n_, 1), z(n_, 1);
+    // unit weights give the l1 ball
+    WeightedL1NormBallProj<Scalar> unit(Vec::Ones(n_), 0.5);
+    L1NormBallProj<Scalar>         l1(0.5);
+    unit(x_, 1, y);
+    l1(x_, 1, z);
+    EXPECT_LE((y - z).lpNorm<Eigen::Infinity>(), 1e-12);
+
+    // y_i = sign(x_i) max(|x_i| - lambda w_i, 0) on the boundary
+    Vec w = randn(n_, 1).cwiseAbs().array() + 0.1;
+    for (Scalar mu : {0.5, 3.0}) {
+        WeightedL1NormBallProj<Scalar> proj(w, mu);
+        proj(x_, 1, y);
+        if (x_.col(0).cwiseAbs().dot(w) <= mu) {
+            EXPECT_EQ(y, x_);
+            continue;
+        }
+        EXPECT_NEAR(y.col(0).cwiseAbs().dot(w), mu, 1e-10 * mu);
+        // one lambda on the support, the breakpoints |x_i| / w_i off it are below
+        Vec    r      = x_.col(0).cwiseAbs().cwiseQuotient(w);
+        Scalar lambda = -1;
+        for (Index i = 0; i < n_; i++) {
+            if (y(i) == 0) continue;
+            Scalar l = (std::fabs(x_(i)) - std::fabs(y(i))) / w(i);
+            if (lambda < 0) lambda = l;
+            EXPECT_NEAR(l, lambda, 1e-10 * std::max(1_s, lambda));
+            EXPECT_EQ(y(i) > 0, x_(i) > 0);
+        }
+        ASSERT_GE(lambda, 0);
+        for (Index i = 0; i < n_; i++) {
+            if (y(i) == 0) {
+                EXPECT_LE(r(i), lambda * (1 + 1e-10));
+            }
+        }
+    }
+}
+
+TEST_P(ProjTest, L0Ball) {
+    Mat x = randn(n_, 3);
+    Mat y(n_, 3);
+    for (Index k : {0, 1, 10, 500, 200000}) {
+        L0NormBallProj<Scalar> proj(k + 0.5);
+        proj(x, 1, y);
+        expect_top_k(x, y, k);
+    }
+    // in place
+    L0NormBallProj<Scalar> proj(10);
+    y = x;
+    proj(y, 1, y);
+    expect_top_k(x, y, 10);
+}
+
+// the selection is split across the threads on long columns
+TEST(ProjParallelTest, L0Ball) {
+    ThreadPoolGuard guard;
+    ThreadPool::global().set_num_threads(4);
+    rng(/* seed */ 2026);
+    Index n = OPTSUITE_TOP_K_PARALLEL + 3;
+    Mat   x = randn(n, 1);
+    Mat   y(n, 1);
+    for (Index k : {1, 1000, 100000}) {
+        L0NormBallProj<Scalar> proj(k);
+        proj(x, 1, y);
+        expect_top_k(x, y, k);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Projection, ProjTest, Values(1, 2, 50, 1000, 100000));
+
+}   // namespace
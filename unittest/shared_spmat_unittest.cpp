@@ -0,0 +1,118 @@
+/**
+ * shared_spmat_unittest.cpp
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#include "OptSuite/Base/factorized_mat.h"
+#include "OptSuite/Base/mat_wrapper.h"
+#include "OptSuite/Base/shared_spmat.h"
+#include "OptSuite/Base/spmat_wrapper.h"
+#include "OptSuite/Base/var_expr.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using ::testing::Combine;
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+
+class SharedSpMatTest : public TestWithParam<::std::tuple<int32_t, int32_t>> {
+protected:
+    void SetUp() override {
+        std::tie(m_, n_) = GetParam();
+        rng(/* seed */ 2026);
+        A_ = sprandn(m_, n_, 0.1);
+        A_.makeCompressed();
+    }
+
+    // the same pattern as A_ with random values
+    SharedSpMat<Scalar> random_like(const SharedSpMat<Scalar> &x) {
+        SharedSpMat<Scalar> y;
+        y.set_zero_like(x);
+        y.values() = randn(x.nonZeros(), 1);
+        return y;
+    }
+
+    int32_t m_, n_;
+    SpMat   A_;
+};
+
+TEST_P(SharedSpMatTest, Pattern) {
+    SharedSpMat<Scalar> x(A_);
+    EXPECT_EQ(Mat(x.spmat()), Mat(A_));
+
+    // copies and set_zero_like share the index arrays
+    SharedSpMat<Scalar> y(x), z;
+    z.set_zero_like(x);
+    EXPECT_EQ(y.outer_index(), x.outer_index());
+    EXPECT_EQ(z.inner_index(), x.inner_index());
+    EXPECT_TRUE(z.same_pattern(x));
+    EXPECT_EQ(z.values().squaredNorm(), 0);
+
+    // an equal pattern in other arrays is recognized, and adopted by set_zero_like
+    SharedSpMat<Scalar> w(A_);
+    EXPECT_NE(w.inner_index(), x.inner_index());
+    EXPECT_TRUE(w.same_pattern(x));
+    w.set_zero_like(x);
+    EXPECT_EQ(w.inner_index(), x.inner_index());
+
+    // the non-const index accessors detach the matrix from the other owners
+    if (x.nonZeros() > 0) {
+        SparseIndex *inner = y.innerIndexPtr();
+        EXPECT_NE(y.inner_index(), x.inner_index());
+        inner[0] = (inner[0] + 1) % m_;
+        EXPECT_EQ(x.innerIndexPtr()[0], A_.innerIndexPtr()[0]);
+    }
+}
+
+TEST_P(SharedSpMatTest, Values) {
+    SharedSpMat<Scalar> x(A_), y(x);
+    y.values() *= 2;
+    EXPECT_EQ(Mat(x.spmat()), Mat(A_));
+    EXPECT_EQ(Mat(y.spmat()), Mat(2 * A_));
+    EXPECT_EQ(y.outer_index(), x.outer_index());
+    EXPECT_NEAR(y.squared_norm_diff(x), A_.squaredNorm(), 1e-12 * (1 + A_.squaredNorm()));
+    EXPECT_NEAR(y.norm(), 2 * A_.norm(), 1e-12 * (1 + A_.norm()));
+}
+
+// <x, y> and <y, x> through Variable::dot against a dense reference
+TEST_P(SharedSpMatTest, Dot) {
+    SharedSpMat<Scalar> x(A_);
+    Mat                 xd = Mat(A_);
+    auto check = [&](const Variable<Scalar> &y, const Mat &yd) {
+        const Variable<Scalar> &xv  = x;
+        Scalar                  ref = xd.cwiseProduct(yd).sum();
+        Scalar                  tol = 1e-12 * (1 + xd.norm() * yd.norm());
+        EXPECT_NEAR(xv.dot(y), ref, tol);
+        EXPECT_NEAR(y.dot(xv), ref, tol);
+    };
+    SharedSpMat<Scalar> s = random_like(x);
+    check(s, Mat(s.spmat()));
+    MatWrapper<Scalar> d(randn(m_, n_));
+    check(d, d.mat());
+    SpMatWrapper<Scalar> p(sprandn(m_, n_, 0.2));
+    check(p, Mat(p.spmat()));
+    FactorizedMat<Scalar> f(randn(m_, 3), randn(n_, 3));
+    check(f, f.mat());
+}
+
+TEST_P(SharedSpMatTest, Axpy) {
+    SharedSpMat<Scalar> x(A_);
+    SharedSpMat<Scalar> y = random_like(x);
+    Mat                 ref = Mat(y.spmat()) - 0.5 * Mat(A_);
+    SharedSpMat<Scalar> z   = y - 0.5 * x;
+    EXPECT_EQ(z.inner_index(), x.inner_index());
+    EXPECT_LE((Mat(z.spmat()) - ref).norm(), 1e-14 * (1 + ref.norm()));
+    // in place
+    y = y - 0.5 * x;
+    EXPECT_EQ(y.values(), z.values());
+}
+
+INSTANTIATE_TEST_SUITE_P(SharedSpMat, SharedSpMatTest,
+                         Combine(Values(1, 30), Values(1, 50)));
+
+}   // namespace
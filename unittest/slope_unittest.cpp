@@ -0,0 +1,212 @@
+/**
+ * slope_unittest.cpp
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#include "OptSuite/Utils/thread_pool.h"
+#include "solver_test.h"
+#include "thread_pool_guard.h"
+
+namespace {
+
+using ::testing::Combine;
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+using namespace OptSuite::UnitTest;
+using namespace OptSuite::Utils;
+
+// n weights decreasing linearly from 1 to 0.1
+Vec linear_weights(Index n) {
+    return Vec::LinSpaced(n, 1, 0.1);
+}
+
+class SortedL1Test : public TestWithParam<int32_t> {
+protected:
+    void SetUp() override {
+        n_ = GetParam();
+        rng(/* seed */ 2026);
+        x_      = randn(n_, 3);
+        lambda_ = linear_weights(n_);
+    }
+
+    int32_t n_;
+    Mat     x_;
+    Vec     lambda_;
+};
+
+TEST_P(SortedL1Test, Norm) {
+    Mat          x = x_.col(0);
+    SortedL1Norm h(lambda_, 2);
+    std::vector<Scalar> a(x.data(), x.data() + n_);
+    for (Scalar& v : a) v = std::fabs(v);
+    std::sort(a.rbegin(), a.rend());
+    Scalar r = 0;
+    for (Index i = 0; i < n_; i++) r += lambda_(i) * a[i];
+    EXPECT_NEAR(h(x), 2 * r, 1e-12 * r);
+    // the same under permutations and sign changes
+    Mat y = -x.reverse();
+    EXPECT_NEAR(h(y), h(x), 1e-12 * r);
+}
+
+// equal weights give the l1 norm, a single one the l-infinity norm
+TEST_P(SortedL1Test, SpecialCases) {
+    Mat y(n_, 3), z(n_, 3);
+    SortedL1Prox(Vec::Constant(n_, 0.5))(x_, 2, y);
+    ShrinkageL1(0.5)(x_, 2, z);
+    EXPECT_LE((y - z).norm(), 1e-12 * std::max(1_s, z.norm()));
+
+    Vec first = Vec::Zero(n_);
+    first(0)  = 0.8;
+    SortedL1Prox prox(first);
+    for (Index j = 0; j < 3; j++) {
+        Mat xj = x_.col(j), yj(n_, 1), zj(n_, 1);
+        prox(xj, 1, yj);
+        ShrinkageLInf(0.8)(xj, 1, zj);
+        EXPECT_LE((yj - zj).norm(), 1e-10 * std::max(1_s, zj.norm()));
+    }
+}
+
+// 0.5 ||y - x||^2 + t h(y) does not decrease along random directions
+TEST_P(SortedL1Test, Optimality) {
+    SortedL1Norm h(lambda_, 0.3);
+    SortedL1Prox prox(lambda_, 0.3);
+    Mat          y(n_, 3);
+    prox(x_, 2, y);
+    auto   obj = [&](const Mat& z) { return 0.5 * (z - x_).squaredNorm() + 2 * h(z); };
+    Scalar f   = obj(y);
+    for (int k = 0; k < 10; k++) {
+        Mat d = randn(n_, 3);
+        for (Scalar eps : {1e-2, 1e-5})
+            EXPECT_LE(f, obj(y + eps * d / d.norm()) + 1e-12 * std::max(1_s, f)) << eps;
+    }
+    // in place
+    Mat z = x_;
+    prox(z, 2, z);
+    EXPECT_EQ(y, z);
+}
+
+// the sign and the order of the entries carry over to the prox
+TEST_P(SortedL1Test, Equivariance) {
+    SortedL1Prox prox(lambda_, 0.3);
+    Mat          x = x_.col(0), y(n_, 1), z(n_, 1);
+    prox(x, 1, y);
+    Mat xr = -x.reverse();
+    prox(xr, 1, z);
+    EXPECT_LE((z + y.reverse()).norm(), 1e-12 * std::max(1_s, y.norm()));
+}
+
+TEST_P(SortedL1Test, DualScale) {
+    // equal weights: the scale of ShrinkageL1
+    Mat g = 3 * x_;
+    EXPECT_NEAR(SortedL1Prox(Vec::Constant(n_, 0.5)).dual_scale(g), ShrinkageL1(0.5).dual_scale(g),
+                1e-14);
+    // a single weight: the l1 ball, the dual of the l-infinity norm
+    Vec first = Vec::Zero(n_);
+    first(0)  = 0.8;
+    Scalar s  = std::min(1_s, 0.8 / g.cwiseAbs().colwise().sum().maxCoeff());
+    EXPECT_NEAR(SortedL1Prox(first).dual_scale(g), s, 1e-14);
+    // the partial sums of s |g| are below those of mu lambda, one of them tight
+    SortedL1Prox prox(lambda_, 0.3);
+    Scalar       t = prox.dual_scale(g);
+    EXPECT_LT(t, 1);
+    Scalar tight = 1;
+    for (Index j = 0; j < 3; j++) {
+        std::vector<Scalar> a(g.col(j).data(), g.col(j).data() + n_);
+        for (Scalar& v : a) v = std::fabs(v);
+        std::sort(a.rbegin(), a.rend());
+        Scalar gs = 0, ls = 0;
+        for (Index k = 0; k < n_; k++) {
+            gs += t * a[k];
+            ls += 0.3 * lambda_(k);
+            EXPECT_LE(gs, ls * (1 + 1e-12));
+            tight = std::min(tight, (ls - gs) / ls);
+        }
+    }
+    EXPECT_LE(tight, 1e-12);
+}
+
+TEST_P(SortedL1Test, Jacobian) {
+    SortedL1Prox prox(lambda_, 0.3);
+    Mat          p(n_, 3), q(n_, 3), y(n_, 3);
+    Mat          v   = randn(n_, 3);
+    Scalar       eps = 1e-7;
+    prox(x_, 1, p);
+    prox(x_ + eps * v, 1, q);
+    prox.jacobian(x_, p, 1, v, y);
+    // on long vectors the perturbation reorders nearby magnitudes
+    if (n_ <= 1000) {
+        EXPECT_LE((y - (q - p) / eps).norm(), 1e-5 * std::max(1_s, v.norm()));
+    }
+    // symmetric with 0 <= D <= I
+    Mat w = randn(n_, 3), z(n_, 3);
+    prox.jacobian(x_, p, 1, w, z);
+    EXPECT_NEAR(w.cwiseProduct(y).sum(), v.cwiseProduct(z).sum(), 1e-10 * v.norm() * w.norm());
+    EXPECT_GE(v.cwiseProduct(y).sum(), -1e-12);
+    EXPECT_LE(v.cwiseProduct(y).sum(), v.squaredNorm() * (1 + 1e-12));
+}
+
+TEST_P(SortedL1Test, Parallel) {
+    ThreadPoolGuard guard;
+    SortedL1Prox prox(lambda_, 0.3);
+    Mat          x = randn(n_, 16), y(n_, 16), z(n_, 16);
+    ThreadPool::global().set_num_threads(1);
+    prox(x, 1, y);
+    ThreadPool::global().set_num_threads(4);
+    prox(x, 1, z);
+    EXPECT_EQ(y, z);
+}
+
+INSTANTIATE_TEST_SUITE_P(SortedL1, SortedL1Test, Values(1, 2, 10, 1000, 100000));
+
+class SlopeTest : public SolverTest {
+protected:
+    void SetUp() override {
+        SolverTest::SetUp();
+        b_      = randn(m_, 1);
+        lambda_ = linear_weights(n_);
+        mu_     = 0.2 * (A_.transpose() * b_).cwiseAbs().maxCoeff();
+    }
+
+    Mat    b_;
+    Vec    lambda_;
+    Scalar mu_;
+};
+
+// the proximal gradient method certifies its solution by the duality gap
+TEST_P(SlopeTest, ProximalGradient) {
+    auto func_f = AxmbNormSqr<Scalar>(A_, b_);
+    auto func_h = SortedL1Norm(lambda_, mu_);
+    auto h_prox = SortedL1Prox(lambda_, mu_);
+
+    options_.ftol(0);
+    options_.gap_tol(1e-8);
+    options_.maxit(20000);
+    options_.step_size_strategy(StepSizeStrategy::Fixed);
+    options_.fixed(FixedStepSize(1 / lipschitz(A_)));
+    ProximalGradSolver solver("ProxGrad", options_);
+    SolverRecords      records;
+    Mat                x0 = Mat::Zero(n_, 1), x(x0);
+    solver(x0, func_f, func_h, h_prox, 1, x, records);
+    ASSERT_GE(records.gap, 0);
+    EXPECT_LE(records.gap, 1e-8 * std::max(1_s, std::fabs(records.obj_hist.back())));
+    EXPECT_LT(records.n_iters, 20000);
+
+    // and agrees with the semismooth Newton method
+    options_.gtol(0);
+    options_.gap_tol(1e-10);
+    options_.maxit(100);
+    SemismoothNewtonSolver newton("SSN", options_);
+    SolverRecords          ssn_records;
+    Mat                    y(x0);
+    newton(x0, func_f, func_h, h_prox, 1, y, ssn_records);
+    EXPECT_LE(ssn_records.gap, 1e-10 * std::max(1_s, std::fabs(ssn_records.obj_hist.back())));
+    EXPECT_LE(ssn_records.n_iters, 50);
+    EXPECT_LE((x - y).norm(), 1e-3 * std::max(1_s, y.norm()));
+}
+
+INSTANTIATE_TEST_SUITE_P(Slope, SlopeTest, Combine(Values(100), Values(50, 300)));
+
+}   // namespace
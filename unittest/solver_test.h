@@ -0,0 +1,102 @@
+/**
+ * solver_test.h
+ * Created by Haoyang Liu on 10/19/2026.
+ *
+ * The fixture and the test problems shared by the solver unit tests.
+ */
+#ifndef OPTSUITE_UNITTEST_SOLVER_TEST_H
+#define OPTSUITE_UNITTEST_SOLVER_TEST_H
+
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/Base/solver.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "gtest/gtest.h"
+#include <tuple>
+
+namespace OptSuite { namespace UnitTest {
+    // a random m x n A_ for the (m, n) parameter and quiet options_
+    class SolverTest : public ::testing::TestWithParam<::std::tuple<int32_t, int32_t>> {
+        protected:
+            void SetUp() override {
+                std::tie(m_, n_) = GetParam();
+                LinAlg::rng(/* seed */ 2026);
+                A_ = LinAlg::randn(m_, n_);
+                options_.verbosity(Verbosity::Quiet);
+            }
+
+            // the Lipschitz constant of the gradient of 0.5 ||Ax - b||^2
+            static Scalar lipschitz(const Mat &A) {
+                Scalar s = A.jacobiSvd().singularValues()(0);
+                return s * s;
+            }
+
+            int32_t             m_, n_;
+            Mat                 A_;
+            Base::SolverOptions options_;
+    };
+
+    // the problems below draw their data from the random generator, mu is
+    // ratio times the value above which the solution is zero
+
+    // 0.5 ||Ax - b||^2 + mu ||x||_1
+    struct Lasso {
+        explicit Lasso(const Mat &A, Scalar ratio = 0.1)
+            : b(LinAlg::randn(A.rows(), 1)),
+              mu(ratio * (A.transpose() * b).cwiseAbs().maxCoeff()),
+              func_f(A, b), func_h(mu), h_prox(mu) {}
+
+        Mat                       b;
+        Scalar                    mu;
+        Base::AxmbNormSqr<Scalar> func_f;
+        Base::L1Norm              func_h;
+        Base::ShrinkageL1         h_prox;
+    };
+
+    // 0.5 ||AX - B||_F^2 + mu ||X||_{1,2} with three columns
+    struct GroupLasso {
+        explicit GroupLasso(const Mat &A, Scalar ratio = 0.1)
+            : b(LinAlg::randn(A.rows(), 3)),
+              mu(ratio * (A.transpose() * b).rowwise().norm().maxCoeff()),
+              func_f(A, b), func_h(mu), h_prox(mu) {}
+
+        Mat                       b;
+        Scalar                    mu;
+        Base::AxmbNormSqr<Scalar> func_f;
+        Base::L1_2Norm            func_h;
+        Base::ShrinkageL2Rowwise  h_prox;
+    };
+
+    // 0.5 ||Ax - b||^2 over the unit l2 ball
+    struct L2Ball {
+        explicit L2Ball(const Mat &A)
+            : b(LinAlg::randn(A.rows(), 1)), func_f(A, b), h_prox(1) {}
+
+        Mat                          b;
+        Base::AxmbNormSqr<Scalar>    func_f;
+        Base::Zero<Scalar>           func_h;
+        Base::L2NormBallProj<Scalar> h_prox;
+    };
+
+    // l1-regularized logistic regression on M' with random +-1 labels, see
+    // LogisticRegression for the layout
+    struct SparseLogistic {
+        explicit SparseLogistic(const Mat &M, Scalar ratio = 0.05)
+            : A(M.transpose()), b(labels(M.rows())),
+              mu(ratio * (A * b).cwiseAbs().maxCoeff() / M.rows()),
+              func_f(A, b), func_h(mu), h_prox(mu) {}
+
+        static Mat labels(Index m) {
+            Mat b = LinAlg::randn(m, 1);
+            for (Index i = 0; i < m; i++) b(i) = b(i) > 0 ? 1 : -1;
+            return b;
+        }
+
+        Mat                              A, b;
+        Scalar                           mu;
+        Base::LogisticRegression<Scalar> func_f;
+        Base::L1Norm                     func_h;
+        Base::ShrinkageL1                h_prox;
+    };
+}}
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * thread_pool_guard.h
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#ifndef OPTSUITE_UNITTEST_THREAD_POOL_GUARD_H
+#define OPTSUITE_UNITTEST_THREAD_POOL_GUARD_H
+
+#include "OptSuite/Utils/thread_pool.h"
+
+namespace OptSuite { namespace UnitTest {
+    // gives the global pool back the size it had at construction, for the
+    // tests that change it; the default size is OPTSUITE_NUM_THREADS or the
+    // number of hardware threads
+    class ThreadPoolGuard {
+        public:
+            ThreadPoolGuard() : num_threads_(Utils::ThreadPool::global().num_threads()) {}
+            ~ThreadPoolGuard() { Utils::ThreadPool::global().set_num_threads(num_threads_); }
+
+            ThreadPoolGuard(const ThreadPoolGuard&) = delete;
+            ThreadPoolGuard& operator=(const ThreadPoolGuard&) = delete;
+
+        private:
+            int num_threads_;
+    };
+}}
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * tv_unittest.cpp
+ * Created by Haoyang Liu on 10/19/2026.
+ */
+#include "OptSuite/Base/functional.h"
+#include "OptSuite/LinAlg/rng_wrapper.h"
+#include "OptSuite/Utils/thread_pool.h"
+#include "gtest/gtest.h"
+#include "thread_pool_guard.h"
+
+namespace {
+
+using ::testing::Combine;
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+using namespace OptSuite;
+using namespace OptSuite::Base;
+using namespace OptSuite::LinAlg;
+using namespace OptSuite::UnitTest;
+using namespace OptSuite::Utils;
+
+// a piecewise constant signal with noise
+Mat noisy_steps(Index m, Index n) {
+    Mat x = 0.3 * randn(m, n);
+    for (Index j = 0; j < n; j++)
+        for (Index i = 0; i < m; i++) x(i, j) += ((i * 7 / std::max<Index>(m, 1)) % 3) + (j * 5 / n) % 2;
+    return x;
+}
+
+// 0.5 ||y - x||^2 + h(y) does not decrease along random directions
+void expect_minimum(Func<Scalar> &h, const Mat &x, const Mat &y, Scalar tol) {
+    auto obj = [&](const Mat &z) { return 0.5 * (z - x).squaredNorm() + h(z); };
+    Scalar f = obj(y);
+    for (int k = 0; k < 10; k++) {
+        Mat d = randn(y.rows(), y.cols());
+        for (Scalar eps : {1e-2, 1e-4})
+            EXPECT_LE(f, obj(y + eps * d / d.norm()) + tol * std::max(1_s, f)) << eps;
+    }
+}
+
+class TV1DTest : public TestWithParam<int32_t> {};
+
+// the optimality of y: with s_k = sum_{i <= k} (y_i - x_i) / lambda,
+// |s_k| <= 1, s_k = sign(y_{k+1} - y_k) on the jumps and s_{n-1} = 0
+TEST_P(TV1DTest, Optimality) {
+    Index m = GetParam();
+    rng(/* seed */ 2026);
+    Mat x = noisy_steps(m, 3);
+    for (Scalar lambda : {1e-3, 0.1, 1.0, 100.0}) {
+        TV1DProx prox(lambda);
+        Mat      y(m, 3);
+        prox(x, 1, y);
+        for (Index j = 0; j < 3; j++) {
+            Scalar s = 0;
+            for (Index k = 0; k < m; k++) {
+                s += (y(k, j) - x(k, j)) / lambda;
+                if (k + 1 == m) {
+                    EXPECT_NEAR(s, 0, 1e-8 * m);
+                    break;
+                }
+                EXPECT_LE(std::fabs(s), 1 + 1e-8 * m);
+                Scalar jump = y(k + 1, j) - y(k, j);
+                if (std::fabs(jump) > 1e-10) {
+                    EXPECT_NEAR(s, jump > 0 ? 1 : -1, 1e-8 * m);
+                }
+            }
+        }
+        // in place
+        Mat z = x;
+        prox(z, 1, z);
+        EXPECT_EQ(y, z);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(TotalVariation, TV1DTest, Values(1, 2, 10, 1000, 100000));
+
+class TV2DTest : public TestWithParam<::std::tuple<int32_t, int32_t>> {
+protected:
+    void SetUp() override {
+        std::tie(m_, n_) = GetParam();
+        rng(/* seed */ 2026);
+        x_ = noisy_steps(m_, n_);
+    }
+
+    int32_t m_, n_;
+    Mat     x_;
+};
+
+TEST_P(TV2DTest, Anisotropic) {
+    TV2DNorm h(0.5, TVType::Anisotropic);
+    TV2DProx prox(0.5, TVType::Anisotropic, 5000, 1e-9);
+    Mat      y(m_, n_);
+    prox(x_, 1, y);
+    EXPECT_LT(prox.iters(), 5000);
+    expect_minimum(h, x_, y, 1e-8);
+}
+
+TEST_P(TV2DTest, Isotropic) {
+    TV2DNorm h(0.5, TVType::Isotropic);
+    TV2DProx prox(0.5, TVType::Isotropic, 20000, 1e-7);
+    Mat      y(m_, n_);
+    prox(x_, 1, y);
+    EXPECT_LT(prox.iters(), 20000);
+    expect_minimum(h, x_, y, 1e-6);
+    // the warm start from the last dual variables stops at the first gap check
+    Mat z(m_, n_);
+    prox(x_, 1, z);
+    EXPECT_LE(prox.iters(), 10);
+    EXPECT_LE((y - z).norm(), 1e-3 * y.norm());
+}
+
+// a single column is the 1D prox
+TEST_P(TV2DTest, Column) {
+    Mat x = x_.col(0), y(m_, 1), z(m_, 1), w(m_, 1);
+    TV1DProx(0.5)(x, 1, y);
+    TV2DProx(0.5, TVType::Anisotropic)(x, 1, z);
+    TV2DProx(0.5, TVType::Isotropic, 100000, 1e-10)(x, 1, w);
+    EXPECT_LE((y - z).norm(), 1e-10 * y.norm());
+    EXPECT_LE((y - w).norm(), 1e-4 * y.norm());
+}
+
+TEST_P(TV2DTest, Parallel) {
+    ThreadPoolGuard guard;
+    for (TVType type : {TVType::Anisotropic, TVType::Isotropic}) {
+        Mat y(m_, n_), z(m_, n_);
+        ThreadPool::global().set_num_threads(1);
+        TV2DProx(0.5, type, 50)(x_, 1, y);
+        ThreadPool::global().set_num_threads(4);
+        TV2DProx(0.5, type, 50)(x_, 1, z);
+        EXPECT_EQ(y, z);
+    }
+}
+
+TEST_P(TV2DTest, InPlace) {
+    for (TVType type : {TVType::Anisotropic, TVType::Isotropic}) {
+        Mat y(m_, n_), z = x_;
+        TV2DProx(0.5, type, 50)(x_, 1, y);
+        TV2DProx(0.5, type, 50)(z, 1, z);
+        EXPECT_EQ(y, z);
+    }
+}
+
+// a zero weight or no iterations give back x
+TEST_P(TV2DTest, Identity) {
+    for (TVType type : {TVType::Anisotropic, TVType::Isotropic}) {
+        Mat      y(m_, n_);
+        TV2DProx prox(0, type);
+        prox(x_, 1, y);
+        EXPECT_EQ(y, x_);
+        TV2DProx(0.5, type)(x_, 0, y);
+        EXPECT_EQ(y, x_);
+        TV2DProx(0.5, type, 0)(x_, 1, y);
+        EXPECT_EQ(y, x_);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(TotalVariation, TV2DTest,
+                         Combine(Values(1, 30, 120), Values(1, 40, 150)));
+
+}   // namespace